@@ -0,0 +1,176 @@
+// Programmer: Seiji Emery
+// Programmer ID: M00202623
+//
+// Allocators.h
+// std-compatible allocators for the container Allocator parameters (DynamicArray,
+// SmallDynamicArray, SortableArray, HashTable, Stack, Queue):
+//
+//  – MallocAllocator<T>: calls malloc / free directly (bypasses any global operator new overrides)
+//  – ArenaAllocator<T>:  bump allocates from a LinearArena; deallocate() is a no-op, and
+//                        all memory is released at once when the arena is reset / destroyed
+//
+// Remote source:
+// https://github.com/SeijiEmery/comp220/tree/master/assignment_03/src/Allocators.h
+//
+
+#ifndef Allocators_h
+#define Allocators_h
+#include <cstdlib>      // malloc, free
+#include <cstddef>      // std::max_align_t
+#include <cstdint>      // uintptr_t
+#include <cassert>
+#include <new>          // std::bad_alloc
+#include <stdexcept>    // std::logic_error
+#include <utility>      // std::swap
+
+template <typename T>
+struct MallocAllocator {
+    typedef T value_type;
+
+    MallocAllocator () {}
+    template <typename U> MallocAllocator (const MallocAllocator<U>&) {}
+
+    T* allocate (size_t count) {
+        if (void* ptr = std::malloc(count * sizeof(T))) {
+            return static_cast<T*>(ptr);
+        }
+        throw std::bad_alloc();
+    }
+    void deallocate (T* ptr, size_t) { std::free(ptr); }
+
+    template <typename U> bool operator== (const MallocAllocator<U>&) const { return true; }
+    template <typename U> bool operator!= (const MallocAllocator<U>&) const { return false; }
+};
+
+// Bump-pointer (monotonic) arena: hands out memory from a linked list of malloc-ed chunks.
+// Chunks grow geometrically (chunkSize doubles per chunk, up to maxChunkSize; requests larger
+// than that get a chunk of their own). Nothing is freed individually: reset() releases
+// everything at once (keeping the newest / largest chunk around for reuse), and the
+// destructor frees all chunks.
+class LinearArena {
+    struct Chunk {
+        Chunk* prev;
+        size_t size;
+        // (chunk memory follows)
+    };
+    Chunk* chunks    = nullptr;
+    char*  next      = nullptr;     // bump pointer into the current chunk
+    char*  end       = nullptr;
+    size_t chunkSize;
+    size_t bytesUsed = 0;
+    size_t numChunks = 0;
+
+    static const size_t maxChunkSize = 16 * 1024 * 1024;
+
+    static LinearArena*& currentArena () {
+        static thread_local LinearArena* arena = nullptr;
+        return arena;
+    }
+    static char* chunkBegin (Chunk* chunk) { return reinterpret_cast<char*>(chunk + 1); }
+
+    void addChunk (size_t minSize) {
+        size_t size = minSize > chunkSize ? minSize : chunkSize;
+        Chunk* chunk = static_cast<Chunk*>(std::malloc(sizeof(Chunk) + size));
+        if (!chunk) throw std::bad_alloc();
+        chunk->prev = chunks;
+        chunk->size = size;
+        chunks = chunk;
+        next = chunkBegin(chunk);
+        end  = next + size;
+        ++numChunks;
+        if (chunkSize < maxChunkSize) {
+            chunkSize *= 2;
+        }
+    }
+    void freeChunks (Chunk* chunk) {
+        while (chunk) {
+            Chunk* prev = chunk->prev;
+            std::free(chunk);
+            chunk = prev;
+        }
+    }
+public:
+    LinearArena (size_t chunkSize = 64 * 1024) : chunkSize(chunkSize) {}
+    LinearArena (const LinearArena&) = delete;
+    LinearArena& operator= (const LinearArena&) = delete;
+    LinearArena (LinearArena&& other) : chunkSize(other.chunkSize) { swap(other); }
+    LinearArena& operator= (LinearArena&& other) { swap(other); return *this; }
+    ~LinearArena () { freeChunks(chunks); }
+
+    void swap (LinearArena& other) {
+        std::swap(chunks, other.chunks);
+        std::swap(next, other.next);
+        std::swap(end, other.end);
+        std::swap(chunkSize, other.chunkSize);
+        std::swap(bytesUsed, other.bytesUsed);
+        std::swap(numChunks, other.numChunks);
+    }
+
+    // Releases everything allocated from this arena. Keeps the newest (largest) chunk, so
+    // an arena that is reset + refilled w/ a similar workload stops calling malloc.
+    void reset () {
+        if (chunks) {
+            freeChunks(chunks->prev);
+            chunks->prev = nullptr;
+            next = chunkBegin(chunks);
+            end  = next + chunks->size;
+            numChunks = 1;
+        }
+        bytesUsed = 0;
+    }
+
+    static char* alignUp (char* ptr, size_t align) {
+        return reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(ptr) + align - 1) & ~(uintptr_t)(align - 1));
+    }
+    void* allocate (size_t size, size_t align = alignof(std::max_align_t)) {
+        char* ptr = alignUp(next, align);
+        if (!next || ptr + size > end) {
+            addChunk(size + align);
+            ptr = alignUp(next, align);
+        }
+        next = ptr + size;
+        bytesUsed += size;
+        return ptr;
+    }
+
+    size_t bytesAllocated () const { return bytesUsed; }
+    size_t chunkCount () const { return numChunks; }
+
+    // Arena that default-constructed ArenaAllocators allocate from (per thread); set w/ Scope
+    static LinearArena* current () { return currentArena(); }
+
+    // RAII: makes arena the current arena while this is in scope
+    class Scope {
+        LinearArena* prev;
+    public:
+        Scope (LinearArena& arena) : prev(currentArena()) { currentArena() = &arena; }
+        Scope (const Scope&) = delete;
+        Scope& operator= (const Scope&) = delete;
+        ~Scope () { currentArena() = prev; }
+    };
+};
+
+template <typename T>
+struct ArenaAllocator {
+    typedef T value_type;
+    LinearArena* arena;
+
+    // Throws std::logic_error if there is no current arena (ie. outside of a LinearArena::Scope)
+    ArenaAllocator () : arena(LinearArena::current()) {
+        if (!arena) {
+            throw std::logic_error("ArenaAllocator needs an arena (use LinearArena::Scope)");
+        }
+    }
+    ArenaAllocator (LinearArena& arena) : arena(&arena) {}
+    template <typename U> ArenaAllocator (const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate (size_t count) {
+        return static_cast<T*>(arena->allocate(count * sizeof(T), alignof(T)));
+    }
+    void deallocate (T*, size_t) {}
+
+    template <typename U> bool operator== (const ArenaAllocator<U>& other) const { return arena == other.arena; }
+    template <typename U> bool operator!= (const ArenaAllocator<U>& other) const { return arena != other.arena; }
+};
+
+#endif // Allocators_h
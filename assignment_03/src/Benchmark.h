@@ -0,0 +1,210 @@
+// Programmer: Seiji Emery
+// Programmer ID: M00202623
+//
+// Benchmark.h
+// Small shared benchmark harness (dvc_test, the PriorityQueue push / pop tests):
+//  – times on a monotonic clock (std::chrono::steady_clock), not clock() (CPU time, ~1 ms steps)
+//  – warms up first (runs the function for at least warmupMs), so the first samples don't pay for
+//    cold caches / page faults / lazy allocations
+//  – auto-calibrates the # of iterations per sample so each sample takes at least minSampleMs
+//    (ie. is well above the clock's resolution), then takes `samples` samples
+//  – reports the median, mean, p90, stddev, min + max time / iteration, and how many samples are
+//    outliers (outside Tukey's fences: > 1.5 IQR below Q1 / above Q3); use the median, which
+//    outliers (eg. a context switch during one sample) don't move
+//  – doNotOptimize(): keeps a result (+ the work that produced it) from being optimized away
+//  – Report: collects named results and writes them as CSV or JSON (for regression tracking)
+//
+// Usage:
+//      bench::Stats stats = bench::run(options, [&]() { work(); });
+//      bench::Stats stats = bench::run(options, [&](size_t iterations) { setup(iterations); },
+//                                               [&](size_t i) { work(i); });   // (setup isn't timed)
+//      std::cout << stats << '\n';
+//      bench::Report::global().add("work", n, stats);
+//
+// Remote source:
+// https://github.com/SeijiEmery/comp220/tree/master/assignment_03/src/Benchmark.h
+//
+
+#ifndef Benchmark_h
+#define Benchmark_h
+#include <cstddef>
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+
+namespace bench {
+
+typedef std::chrono::steady_clock Clock;
+static_assert(Clock::is_steady, "bench::Clock must be monotonic");
+
+inline double elapsedMs (Clock::time_point t0, Clock::time_point t1) {
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+// Forces value to be computed (+ kept) without otherwise using it
+template <typename T>
+inline void doNotOptimize (const T& value) {
+    asm volatile ("" : : "r,m"(value) : "memory");
+}
+// Forces all pending writes to memory to happen (ie. not be optimized away / moved past here)
+inline void clobberMemory () {
+    asm volatile ("" : : : "memory");
+}
+
+struct Options {
+    double warmupMs      = 10;      // run (untimed) for at least this long first
+    double minSampleMs   = 5;       // calibrate iterations / sample to take at least this long
+    size_t samples       = 10;
+    size_t maxIterations = 1 << 24; // (per sample)
+
+    Options () {}
+    explicit Options (size_t samples) : samples(std::max(samples, (size_t)1)) {}
+};
+
+// Time / iteration of each sample, in ms
+struct Stats {
+    size_t samples    = 0;
+    size_t iterations = 0;      // per sample
+    size_t outliers   = 0;
+    double median = 0, mean = 0, p90 = 0, stddev = 0, min = 0, max = 0;
+
+    friend std::ostream& operator<< (std::ostream& os, const Stats& stats) {
+        return os << std::setw(8) << stats.median << " ms / run (median; p90 " << stats.p90
+            << ", stddev " << stats.stddev << ", " << stats.samples << " x " << stats.iterations
+            << " runs" << (stats.outliers ? ", " + std::to_string(stats.outliers) + " outlier(s)" : "") << ")";
+    }
+};
+
+// Stats of a set of samples (ms / iteration; reorders them)
+inline Stats computeStats (std::vector<double>& samples, size_t iterations) {
+    Stats stats;
+    size_t n = samples.size();
+    stats.samples    = n;
+    stats.iterations = iterations;
+    if (n == 0) return stats;
+
+    std::sort(samples.begin(), samples.end());
+    // (linear interpolation between the closest ranks)
+    auto percentile = [&](double p) {
+        double rank = p * (n - 1);
+        size_t lo = (size_t)rank, hi = std::min(lo + 1, n - 1);
+        return samples[lo] + (samples[hi] - samples[lo]) * (rank - lo);
+    };
+    stats.median = percentile(0.5);
+    stats.p90    = percentile(0.9);
+    stats.min    = samples.front();
+    stats.max    = samples.back();
+
+    double sum = 0;
+    for (double sample : samples) sum += sample;
+    stats.mean = sum / n;
+    double squares = 0;
+    for (double sample : samples) squares += (sample - stats.mean) * (sample - stats.mean);
+    stats.stddev = n > 1 ? std::sqrt(squares / (n - 1)) : 0;
+
+    double q1 = percentile(0.25), q3 = percentile(0.75), iqr = q3 - q1;
+    for (double sample : samples) {
+        if (sample < q1 - 1.5 * iqr || sample > q3 + 1.5 * iqr) ++stats.outliers;
+    }
+    return stats;
+}
+
+// Benchmarks fcn(i) (i: 0 - iterations - 1 in each sample); setup(iterations) is called before
+// each timed batch of iterations (untimed), eg. to create fresh inputs for each iteration
+template <typename Setup, typename F>
+Stats run (const Options& options, Setup setup, F fcn) {
+    auto timeBatch = [&](size_t iterations) {
+        setup(iterations);
+        auto t0 = Clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            fcn(i);
+        }
+        auto t1 = Clock::now();
+        clobberMemory();
+        return elapsedMs(t0, t1);
+    };
+
+    // Warm up
+    double warmup = 0;
+    do {
+        warmup += timeBatch(1);
+    } while (warmup < options.warmupMs);
+
+    // Calibrate: grow iterations until one batch takes at least minSampleMs
+    size_t iterations = 1;
+    for (double ms = timeBatch(iterations); ms < options.minSampleMs && iterations < options.maxIterations; ms = timeBatch(iterations)) {
+        size_t target = ms > 0 ? (size_t)(iterations * options.minSampleMs * 1.2 / ms) : iterations * 10;
+        iterations = std::min(std::max(target, iterations * 2), options.maxIterations);
+    }
+
+    std::vector<double> samples;
+    samples.reserve(options.samples);
+    for (size_t i = 0; i < options.samples; ++i) {
+        samples.push_back(timeBatch(iterations) / iterations);
+    }
+    return computeStats(samples, iterations);
+}
+template <typename F>
+Stats run (const Options& options, F fcn) {
+    return run(options, [](size_t) {}, [&](size_t) { fcn(); });
+}
+
+// Named results (name + a size parameter n, eg. # of lines or elements), written as CSV / JSON
+class Report {
+    struct Entry {
+        std::string name;
+        size_t      n;
+        Stats       stats;
+    };
+    std::vector<Entry> entries;
+
+    static void writeJsonString (std::ostream& os, const std::string& str) {
+        os << '"';
+        for (char c : str) {
+            if (c == '"' || c == '\\') os << '\\' << c;
+            else if ((unsigned char)c < 0x20) os << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c
+                                                 << std::dec << std::setfill(' ');
+            else os << c;
+        }
+        os << '"';
+    }
+public:
+    static Report& global () {
+        static Report report;
+        return report;
+    }
+    void   add   (const std::string& name, size_t n, const Stats& stats) { entries.push_back({ name, n, stats }); }
+    size_t size  () const { return entries.size(); }
+    void   clear () { entries.clear(); }
+
+    void writeCsv (std::ostream& os) const {
+        os << "name,n,samples,iterations,median_ms,mean_ms,p90_ms,stddev_ms,min_ms,max_ms,outliers\n";
+        for (const auto& entry : entries) {
+            const Stats& s = entry.stats;
+            os << '"' << entry.name << "\"," << entry.n << ',' << s.samples << ',' << s.iterations << ','
+               << s.median << ',' << s.mean << ',' << s.p90 << ',' << s.stddev << ','
+               << s.min << ',' << s.max << ',' << s.outliers << '\n';
+        }
+    }
+    void writeJson (std::ostream& os) const {
+        os << "[\n";
+        for (size_t i = 0; i < entries.size(); ++i) {
+            const Stats& s = entries[i].stats;
+            os << "  { \"name\": ";
+            writeJsonString(os, entries[i].name);
+            os << ", \"n\": " << entries[i].n << ", \"samples\": " << s.samples << ", \"iterations\": " << s.iterations
+               << ", \"median_ms\": " << s.median << ", \"mean_ms\": " << s.mean << ", \"p90_ms\": " << s.p90
+               << ", \"stddev_ms\": " << s.stddev << ", \"min_ms\": " << s.min << ", \"max_ms\": " << s.max
+               << ", \"outliers\": " << s.outliers << " }" << (i + 1 < entries.size() ? ",\n" : "\n");
+        }
+        os << "]\n";
+    }
+};
+
+} // namespace bench
+
+#endif // Benchmark_h
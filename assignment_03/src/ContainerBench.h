@@ -0,0 +1,65 @@
+// Programmer: Seiji Emery
+// Programmer ID: M00202623
+//
+// ContainerBench.h
+// Shared scaffolding for the container micro-benchmarks (Stack.bench, Queue.bench):
+//
+//  – counts global operator new calls (g_numAllocations; overloads global new / delete, w/out
+//    MemTracer's per-allocation size header, so it doesn't skew the timings)
+//  – measure(ops, f): runs f once, returns ns / op + the # of allocations it made
+//  – writeResult(name, result): prints one indented "name  ns / op  allocations" row
+//
+// Defines (replaces) global operator new / delete, so include it from the benchmark's
+// translation unit only.
+//
+// Remote source:
+// https://github.com/SeijiEmery/comp220/tree/master/assignment_03/src/ContainerBench.h
+//
+
+#ifndef ContainerBench_h
+#define ContainerBench_h
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <iostream>
+#include <iomanip>
+#include "Benchmark.h"      // bench::Clock
+
+//
+// Allocation counter (overloads global new / delete)
+//
+
+static size_t g_numAllocations = 0;
+
+void* operator new (size_t size) {
+    ++g_numAllocations;
+    if (void* mem = std::malloc(size ? size : 1)) {
+        return mem;
+    }
+    throw std::bad_alloc();
+}
+void operator delete (void* mem) noexcept {
+    std::free(mem);
+}
+
+struct BenchResult {
+    double ns;              // per op
+    size_t allocations;     // global operator new calls
+};
+
+template <typename F>
+BenchResult measure (size_t ops, const F& f) {
+    size_t allocs0 = g_numAllocations;
+    auto t0 = bench::Clock::now();
+    f();
+    auto t1 = bench::Clock::now();
+    return { bench::elapsedMs(t0, t1) * 1e6 / ops, g_numAllocations - allocs0 };
+}
+
+static void writeResult (const char* name, const BenchResult& result) {
+    std::cout << "    " << std::setw(26) << std::left << name << std::right
+        << std::setw(10) << std::setprecision(4) << result.ns << " ns / op"
+        << std::setw(10) << result.allocations << " allocations\n";
+}
+
+#endif // ContainerBench_h
@@ -34,6 +34,7 @@ using namespace std;
 
 #include "DynamicArray.h"
 #include "DynamicArray.h" // multiple include test
+#include "SmallDynamicArray.h"
 
 //
 // Minimalistic test 'framework' for comp220. Extremely simple, etc.
@@ -124,11 +125,19 @@ struct TestInfo {
 // Main program
 //
 
-template <typename T, size_t N>
-void _testArrayImpl (const char*, T, T, T, T);
+template <template <typename> class Array, typename T, size_t N>
+void _testArrayImpl (const char*, const char*, T, T, T, T);
+void _testSmallArraySpill ();
+
+// (alias templates, since the array types also take an allocator parameter)
+template <typename T> using DefaultDynamicArray = DynamicArray<T>;
+
+// SmallDynamicArray w/ inline capacity < 100, so that the generic tests also cover spilling to the heap
+template <typename T> using SmallDynamicArray8 = SmallDynamicArray<T, 8>;
 
 #define TEST_ARRAY_IMPL(T, first, second, third) \
-    _testArrayImpl<T,100>(#T, {}, first, second, third)
+    _testArrayImpl<DefaultDynamicArray, T,100>("DynamicArray", #T, {}, first, second, third); \
+    _testArrayImpl<SmallDynamicArray8, T,100>("SmallDynamicArray<8>", #T, {}, first, second, third)
 
 int main () {
     std::cout << "Programmer: Seiji Emery\n";
@@ -140,6 +149,7 @@ int main () {
         TEST_ARRAY_IMPL(double, 1.5, 2.5, 3.5);
         TEST_ARRAY_IMPL(char, '@', 'Z', 'a');
         TEST_ARRAY_IMPL(std::string, "bar", "baz", "foo");
+        _testSmallArraySpill();
     }
     // std::cout << "\033[32mAll tests passed\n\033[0m";
     return 0;
@@ -148,27 +158,27 @@ int main () {
 //
 // Test implementation
 //
-template <typename T, size_t N>
-void _testArrayImpl (const char* name, T init, T first, T second, T third) {
-    SECTION("Testing DynamicArray<" << name << ", " << N << ">") {
+template <template <typename> class Array, typename T, size_t N>
+void _testArrayImpl (const char* arrayName, const char* name, T init, T first, T second, T third) {
+    SECTION("Testing " << arrayName << "<" << name << ", " << N << ">") {
         SECTION("Sanity check") {
             // ASSERT_NE(first, first);     // To verify that test framework is working, try uncommenting this line (should fail).
             ASSERT_EQ(first, first);
             ASSERT_NE(first, second);   
         }
-        DynamicArray<T> array (100);
+        Array<T> array (100);
 
-        SECTION("Testing DynamicArray capacity (should equal " << N << ")") {
+        SECTION("Testing array capacity (should equal " << N << ")") {
             ASSERT_EQ(array.capacity(), N);
         }
-        SECTION("Testing DynamicArray initial values (should be default-initialized, equal '" << init << "')") {
+        SECTION("Testing array initial values (should be default-initialized, equal '" << init << "')") {
             int numNonEqualElements = 0;
             for (auto i = 0; i < array.capacity(); ++i) {
                 if (array[i] != init) ++numNonEqualElements;
             }
             ASSERT_EQ(numNonEqualElements, 0);
         }
-        SECTION("Testing DynamicArray getter / setter") {
+        SECTION("Testing array getter / setter") {
             array[0] = first;
             ASSERT_EQ(array[0], first);
 
@@ -186,11 +196,13 @@ void _testArrayImpl (const char* name, T init, T first, T second, T third) {
             ASSERT_EQ(array[-1], init);
             // ASSERT_EQ(array[N], array[-1]);
             // ASSERT_EQ(array[N], init);
+            // (grow the array before taking a reference to array[N-1], since growth relocates elements)
+            array[N];
             ASSERT_NE(array[N], array[N-1]);
         }
 
         SECTION("Const-object test") {
-            const DynamicArray<T> array2 = array;
+            const Array<T> array2 = array;
             ASSERT_EQ(array2[0], first);
             ASSERT_EQ(array[13], second);
             ASSERT_EQ(array[N-1], third);
@@ -203,7 +215,7 @@ void _testArrayImpl (const char* name, T init, T first, T second, T third) {
         }
 
         SECTION("Object copy test") {
-            DynamicArray<T> array2 (array);
+            Array<T> array2 (array);
             ASSERT_EQ(array2[0], first);
             ASSERT_EQ(array[13], second);
             ASSERT_EQ(array[N-1], third);
@@ -216,7 +228,7 @@ void _testArrayImpl (const char* name, T init, T first, T second, T third) {
         }
 
         SECTION("Object assignment test") {
-            DynamicArray<T> array2; array2 = array;
+            Array<T> array2; array2 = array;
             ASSERT_EQ(array2[0], first);
             ASSERT_EQ(array[13], second);
             ASSERT_EQ(array[N-1], third);
@@ -227,5 +239,78 @@ void _testArrayImpl (const char* name, T init, T first, T second, T third) {
             }
             ASSERT_EQ(numNonEqualElements, 0);
         }
+
+        SECTION("Unchecked accessors (data / begin / end / unchecked / view)") {
+            // (compared as void* so that char* isn't printed as a string)
+            ASSERT_EQ((const void*)array.data(), (const void*)&array[0]);
+            ASSERT_EQ((const void*)array.begin(), (const void*)array.data());
+            ASSERT_EQ((size_t)(array.end() - array.begin()), array.size());
+            ASSERT_EQ(array.unchecked(0), first);
+            ASSERT_EQ(array.unchecked(13), second);
+
+            const Array<T>& constArray = array;
+            auto view = constArray.view();
+            ASSERT_EQ(view.size(), array.size());
+            ASSERT_EQ((const void*)view.data(), (const void*)array.data());
+            ASSERT_EQ(view[13], second);
+            ASSERT_EQ(view.slice(13, 14).size(), (size_t)1);
+            ASSERT_EQ(view.slice(13, 14)[0], second);
+
+            int numIteratedElements = 0;
+            for (auto& value : array) { (void)value; ++numIteratedElements; }
+            ASSERT_EQ((size_t)numIteratedElements, array.size());
+        }
+
+        SECTION("capacity(cap) reserves (size unchanged); resize(n) sets size") {
+            size_t size = array.size();
+            array.capacity(array.capacity() * 4);
+            ASSERT_EQ(array.size(), size);
+            ASSERT_EQ(array[13], second);
+            array.resize(size + 3);
+            ASSERT_EQ(array.size(), size + 3);
+            ASSERT_EQ(array[(int)size + 2], init);
+            array.resize(size);
+            ASSERT_EQ(array.size(), size);
+        }
+    }
+}
+
+void _testSmallArraySpill () {
+    SECTION("Testing SmallDynamicArray<std::string, 4> inline storage + heap spill") {
+        SmallDynamicArray<std::string, 4> array;
+        ASSERT_EQ(array.size(), (size_t)0);
+        ASSERT_EQ(array.small(), true);
+
+        for (auto i = 0; i < 4; ++i) { array[i] = std::to_string(i); }
+        ASSERT_EQ(array.size(), (size_t)4);
+        ASSERT_EQ(array.small(), true);
+
+        array[4] = "4";
+        ASSERT_EQ(array.small(), false);
+        ASSERT_EQ(array.size(), (size_t)5);
+        int numWrongElements = 0;
+        for (auto i = 0; i < 5; ++i) {
+            if (array[i] != std::to_string(i)) ++numWrongElements;
+        }
+        ASSERT_EQ(numWrongElements, 0);
+
+        SECTION("Move inline array") {
+            SmallDynamicArray<std::string, 4> a; a[0] = "foo"; a[1] = "bar";
+            SmallDynamicArray<std::string, 4> b (std::move(a));
+            ASSERT_EQ(b.small(), true);
+            ASSERT_EQ(b.size(), (size_t)2);
+            ASSERT_EQ(b[1], "bar");
+            ASSERT_EQ(a.size(), (size_t)0);
+        }
+        SECTION("Move heap array") {
+            SmallDynamicArray<std::string, 4> b;
+            const std::string* data = array.data();
+            b = std::move(array);
+            ASSERT_EQ(b.small(), false);
+            ASSERT_EQ((const void*)b.data(), (const void*)data);
+            ASSERT_EQ(b[4], "4");
+            ASSERT_EQ(array.small(), true);
+            ASSERT_EQ(array.size(), (size_t)0);
+        }
     }
 }
@@ -0,0 +1,193 @@
+// Programmer: Seiji Emery
+// Programmer ID: M00202623
+//
+// DynamicArray.bench.cpp
+//
+// Benchmarks DynamicArray<std::string> growth: appends n strings one at a time (so the
+// array grows geometrically through operator[]) and reports time + # of heap allocations.
+//
+// Compares against LegacyDynamicArray, a copy of the original growth path (new T[cap],
+// copy-assign every old element, then fill the rest w/ T()), and against the current
+// DynamicArray w/ a reserve() up front, and w/ an ArenaAllocator / MallocAllocator (Allocators.h).
+//
+// Also times fill + sum loops over a Bitset-style DynamicArray<size_t> through each accessor:
+// the bounds checked (+ growing) operator[] vs unchecked(i), begin() / end() and view(); the
+// latter three have no per-access branches, so the compiler can auto-vectorize them.
+//
+// Remote source:
+// https://github.com/SeijiEmery/comp220/tree/master/assignment_03/src/DynamicArray.bench.cpp
+//
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include "DynamicArray.h"
+#include "Allocators.h"
+
+//
+// Allocation counter (overloads global new / delete)
+//
+
+static size_t g_numAllocations = 0;
+
+void* operator new (size_t size) {
+    ++g_numAllocations;
+    if (void* mem = std::malloc(size ? size : 1)) {
+        return mem;
+    }
+    throw std::bad_alloc();
+}
+void operator delete (void* mem) noexcept {
+    std::free(mem);
+}
+
+//
+// Original DynamicArray growth path (minus the parts we don't need here), for comparison
+//
+
+template <typename T>
+class LegacyDynamicArray {
+    size_t _capacity = 0;
+    T*     _data = nullptr;
+    T      _dummy;
+public:
+    LegacyDynamicArray (size_t capacity = 2) : _capacity(capacity), _data(new T[capacity]) {
+        detail::fill(&_data[0], &_data[_capacity], T());
+    }
+    ~LegacyDynamicArray () { delete[] _data; }
+
+    void capacity (size_t cap) {
+        if (cap < 10) cap = 10;
+        if (cap > _capacity) {
+            T* newData = new T[cap];
+            detail::copy(&_data[0], &_data[_capacity], &newData[0]);
+            detail::fill(&newData[_capacity], &newData[cap], T());
+            delete[] _data;
+            _data = newData;
+            _capacity = cap;
+        }
+    }
+    T& operator[] (int i) {
+        if (i < 0) return _dummy = {};
+        if (i >= _capacity) {
+            capacity(detail::nextPow2(i+1));
+        }
+        return _data[i];
+    }
+};
+
+struct NoPrepare {
+    template <typename Array>
+    void operator() (Array&, size_t) const {}
+};
+
+struct BenchResult {
+    double ms;
+    size_t allocations;
+};
+
+// Appends n copies of value to a fresh Array (via operator[], ie. w/ geometric growth)
+template <typename Array, typename Prepare>
+BenchResult benchGrowth (size_t n, const std::string& value, const Prepare& prepare) {
+    using namespace std::chrono;
+    size_t allocs0 = g_numAllocations;
+    auto t0 = high_resolution_clock::now();
+    {
+        Array array;
+        prepare(array, n);
+        for (size_t i = 0; i < n; ++i) {
+            array[static_cast<int>(i)] = value;
+        }
+        if (array[static_cast<int>(n / 2)] != value) {
+            std::cerr << "FAILED: array contents are wrong (n = " << n << ")" << std::endl;
+            exit(-1);
+        }
+    }
+    auto t1 = high_resolution_clock::now();
+    return { duration_cast<duration<double>>(t1 - t0).count() * 1e3, g_numAllocations - allocs0 };
+}
+
+// Runs fill(array, value) + sum(array) reps times; returns ns / element (for fill + sum)
+template <typename Fill, typename Sum>
+double benchFillSum (DynamicArray<size_t>& array, size_t reps, const Fill& fill, const Sum& sum) {
+    using namespace std::chrono;
+    size_t total = 0;
+    auto t0 = high_resolution_clock::now();
+    for (size_t i = 0; i < reps; ++i) {
+        fill(array, i);
+        total += sum(array);
+    }
+    auto t1 = high_resolution_clock::now();
+
+    size_t expected = 0;
+    for (size_t i = 0; i < reps; ++i) { expected += i * array.size(); }
+    if (total != expected) {
+        std::cerr << "FAILED: fill / sum mismatch (" << total << " != " << expected << ")" << std::endl;
+        exit(-1);
+    }
+    return duration_cast<duration<double>>(t1 - t0).count() * 1e9 / (reps * array.size());
+}
+
+static void benchAccessors (size_t n, size_t reps) {
+    DynamicArray<size_t> array (n);
+    int count = static_cast<int>(n);
+    std::cout << "DynamicArray<size_t> fill + sum, n = " << n << " (ns / element):\n";
+
+    std::cout << "  " << std::setw(24) << std::left << "operator[]" << std::right << std::setw(10)
+        << benchFillSum(array, reps,
+            [=](DynamicArray<size_t>& a, size_t v) { for (int i = 0; i < count; ++i) { a[i] = v; } },
+            [=](DynamicArray<size_t>& a) { size_t s = 0; for (int i = 0; i < count; ++i) { s += a[i]; } return s; })
+        << '\n';
+    std::cout << "  " << std::setw(24) << std::left << "unchecked(i)" << std::right << std::setw(10)
+        << benchFillSum(array, reps,
+            [](DynamicArray<size_t>& a, size_t v) { for (size_t i = 0, n = a.size(); i < n; ++i) { a.unchecked(i) = v; } },
+            [](DynamicArray<size_t>& a) { size_t s = 0; for (size_t i = 0, n = a.size(); i < n; ++i) { s += a.unchecked(i); } return s; })
+        << '\n';
+    std::cout << "  " << std::setw(24) << std::left << "begin() / end()" << std::right << std::setw(10)
+        << benchFillSum(array, reps,
+            [](DynamicArray<size_t>& a, size_t v) { for (auto& x : a) { x = v; } },
+            [](DynamicArray<size_t>& a) { size_t s = 0; for (auto x : a) { s += x; } return s; })
+        << '\n';
+    std::cout << "  " << std::setw(24) << std::left << "view()" << std::right << std::setw(10)
+        << benchFillSum(array, reps,
+            [](DynamicArray<size_t>& a, size_t v) { auto view = a.view(); for (size_t i = 0; i < view.size(); ++i) { view[i] = v; } },
+            [](DynamicArray<size_t>& a) { auto view = a.view(); size_t s = 0; for (size_t i = 0; i < view.size(); ++i) { s += view[i]; } return s; })
+        << "\n\n";
+}
+
+static void writeResult (const char* name, const BenchResult& result) {
+    std::cout << "  " << std::setw(24) << std::left << name << std::right
+        << std::setw(10) << std::setprecision(4) << result.ms << " ms"
+        << std::setw(10) << result.allocations << " allocations\n";
+}
+
+int main () {
+    std::cout << "Programmer: Seiji Emery\n"
+              << "Programmer's id: M00202623\n"
+              << "File: " __FILE__ "\n\n";
+
+    // Long enough to defeat the small string optimization, so that every string copy allocates
+    const std::string value = "a string that is too long for the sso buffer";
+    NoPrepare noPrepare;
+
+    for (size_t n = 1000; n <= 1000000; n *= 10) {
+        std::cout << "DynamicArray<std::string> growth, n = " << n << ":\n";
+        writeResult("legacy (copy + fill)", benchGrowth<LegacyDynamicArray<std::string>>(n, value, noPrepare));
+        writeResult("move + lazy construct", benchGrowth<DynamicArray<std::string>>(n, value, noPrepare));
+        writeResult("reserve(n) up front", benchGrowth<DynamicArray<std::string>>(n, value,
+            [](DynamicArray<std::string>& array, size_t n) { array.reserve(n); }));
+        writeResult("MallocAllocator", benchGrowth<DynamicArray<std::string, MallocAllocator<std::string>>>(n, value, noPrepare));
+        {
+            LinearArena arena;
+            LinearArena::Scope scope (arena);
+            writeResult("ArenaAllocator", benchGrowth<DynamicArray<std::string, ArenaAllocator<std::string>>>(n, value, noPrepare));
+        }
+        std::cout << '\n';
+    }
+    benchAccessors(4096, 20000);        // fits in L1 / L2
+    benchAccessors(1 << 22, 20);        // memory bound
+    return 0;
+}
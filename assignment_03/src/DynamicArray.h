@@ -4,6 +4,18 @@
 // Array.h
 // Implements a templated dynamic array with non-throwing bounds checking.
 //
+// Storage is split into capacity (raw, uninitialized slots; see reserve()) and size (the
+// number of live, constructed elements). Growth only moves the live range into the new
+// storage (memcpy for trivially copyable types), and new elements are default-constructed
+// on first access instead of being filled in up front.
+//
+// operator[] is bounds checked (and may grow the array); hot loops can use data(),
+// begin() / end(), unchecked(i) or view() instead, which only cover the live range
+// and do no per-access branching (so the compiler can vectorize them).
+//
+// Memory comes from an (std-compatible) Allocator template parameter, so callers can
+// use arena / pool allocators per container (see Allocators.h).
+//
 // Remote source:
 // https://github.com/SeijiEmery/comp220/tree/master/assignment_03/src/Array.hpp
 //
@@ -11,36 +23,101 @@
 #ifndef DynamicArray_h
 #define DynamicArray_h
 #include <cassert>
+#include <cstring>      // memcpy
+#include <memory>       // std::allocator, std::allocator_traits
+#include <new>          // placement new
+#include <type_traits>  // std::is_trivially_copyable
+#include <utility>      // std::move, std::swap
 
+// Non-owning view of a contiguous range of T (pointer + length), w/ no bounds checking.
 template <typename T>
+class ArrayView {
+    T*     _data = nullptr;
+    size_t _size = 0;
+public:
+    ArrayView () {}
+    ArrayView (T* data, size_t size) : _data(data), _size(size) {}
+
+    T*     data  () const { return _data; }
+    size_t size  () const { return _size; }
+    bool   empty () const { return _size == 0; }
+
+    T* begin () const { return _data; }
+    T* end   () const { return _data + _size; }
+
+    T& operator[] (size_t i) const { assert(i < _size); return _data[i]; }
+
+    // Sub-view of elements [start, end)
+    ArrayView<T> slice (size_t start, size_t end) const {
+        assert(start <= end && end <= _size);
+        return { _data + start, end - start };
+    }
+};
+
+template <typename T, typename Allocator = std::allocator<T>>
 class DynamicArray {
-    size_t _capacity = 0;
-    T*     _data = nullptr;           // dummy incorporated into array at index N. (reserves N+1 elements for data)
-    T      _dummy;
+    typedef std::allocator_traits<Allocator> AllocTraits;
+
+    size_t    _capacity = 0;          // allocated (raw) slots
+    size_t    _size = 0;              // constructed elements; always <= _capacity
+    T*        _data = nullptr;
+    T         _dummy;
+    Allocator _alloc;
     
 public:
+    typedef Allocator allocator_type;
+
     // Constructors, assignment operators, destructor
-    DynamicArray (size_t capacity = 2);
-    DynamicArray (const DynamicArray<T>&);
-    DynamicArray& operator= (const DynamicArray<T>&);
+    DynamicArray (size_t capacity = 2, const Allocator& alloc = Allocator());
+    DynamicArray (const DynamicArray&);
+    DynamicArray& operator= (const DynamicArray&);
     ~DynamicArray ();
 
     // Move operations
-    DynamicArray (DynamicArray<T>&& other) { *this = std::move(other); }
-    DynamicArray<T>& operator= (DynamicArray<T>&& other) { 
+    DynamicArray (DynamicArray&& other) : _alloc(other._alloc) { *this = std::move(other); }
+    DynamicArray& operator= (DynamicArray&& other) { 
+        std::swap(_alloc, other._alloc);
         std::swap(_capacity, other._capacity);
+        std::swap(_size, other._size);
         std::swap(_data, other._data);
         std::swap(_dummy, other._dummy);
         return *this; 
     }
 
-    // Get / set array capacity
+    // Get / set array capacity. capacity(cap) reserves storage for at least cap (min 10) elements,
+    // like reserve(); it never changes size() (use resize() for that).
     void capacity (size_t cap);
     size_t capacity () const { return _capacity; }
 
+    // Number of live (constructed) elements
+    size_t size () const { return _size; }
+
+    // Allocates storage for at least cap elements without constructing any
+    void reserve (size_t cap);
+
+    // Grows / shrinks the live range to exactly n elements (new elements are default-constructed)
+    void resize (size_t n);
+
     // Get / set array elements. Elements out of range returns reference to dummy variable.
     const T& operator[] (int i) const;
     T& operator[] (int i);
+
+    // Unchecked access to the live range [0, size()): no bounds checks and no growth.
+    T*       data ()       { return _data; }
+    const T* data () const { return _data; }
+
+    T*       begin ()       { return _data; }
+    T*       end   ()       { return _data + _size; }
+    const T* begin () const { return _data; }
+    const T* end   () const { return _data + _size; }
+
+    T&       unchecked (size_t i)       { assert(i < _size); return _data[i]; }
+    const T& unchecked (size_t i) const { assert(i < _size); return _data[i]; }
+
+    ArrayView<T>       view ()       { return { _data, _size }; }
+    ArrayView<const T> view () const { return { _data, _size }; }
+
+    const Allocator& get_allocator () const { return _alloc; }
 };
 
 //
@@ -62,6 +139,25 @@ namespace detail {
         }
         return out;
     }
+    // Moves count elements from src into uninitialized storage at dst, and destroys the originals.
+    // Trivially copyable types are just memcpy-ed.
+    template <typename T>
+    void relocate (T* src, size_t count, T* dst, std::true_type) {
+        if (count) memcpy(dst, src, count * sizeof(T));
+    }
+    template <typename T>
+    void relocate (T* src, size_t count, T* dst, std::false_type) {
+        for (size_t i = 0; i < count; ++i) {
+            new (&dst[i]) T(std::move(src[i]));
+            src[i].~T();
+        }
+    }
+    template <typename T>
+    void destroy (T* first, T* last) {
+        for (; first != last; ++first) {
+            first->~T();
+        }
+    }
     // Round number up to next power of 2
     size_t nextPow2 (size_t n) {
         --n;
@@ -75,91 +171,92 @@ namespace detail {
     }
 }; // namespace detail
 
-template <typename T>
-DynamicArray<T>::DynamicArray (size_t count) 
-    : _capacity(count),
-      _data(new T[_capacity]),
-      _dummy(T())
+template <typename T, typename Allocator>
+DynamicArray<T, Allocator>::DynamicArray (size_t count, const Allocator& alloc) 
+    : _dummy(T()),
+      _alloc(alloc)
 {
-    // std::cout << "\033[36mALLOC " << _capacity << " (" << _capacity * sizeof(T) << ")\033[0m\n";
-    detail::fill(&_data[0], &_data[_capacity], T());
+    resize(count);
 }
 
-template <typename T>
-DynamicArray<T>::DynamicArray (const DynamicArray<T>& other) 
-    : _capacity(other._capacity),
-      _data(new T[_capacity]),
-      _dummy(T())
+template <typename T, typename Allocator>
+DynamicArray<T, Allocator>::DynamicArray (const DynamicArray& other) 
+    : _dummy(T()),
+      _alloc(AllocTraits::select_on_container_copy_construction(other._alloc))
 {
-    // std::cout << "\033[36mALLOC " << _capacity << " (" << _capacity * sizeof(T) << ")\033[0m\n";
-    detail::copy(&other._data[0], &other._data[_capacity], &_data[0]);
+    *this = other;
 }
 
-template <typename T>
-DynamicArray<T>& DynamicArray<T>::operator= (const DynamicArray<T>& other) {
+template <typename T, typename Allocator>
+DynamicArray<T, Allocator>& DynamicArray<T, Allocator>::operator= (const DynamicArray& other) {
     if (this != &other) {
-        // std::cout << "\033[35mDEALLOC " << _capacity << " (" << _capacity * sizeof(T) << ")\033[0m\n";
-        delete[] _data;
-
-        _capacity = other._capacity;
-        _data = new T[_capacity];
+        resize(0);
+        reserve(other._size);
+        for (; _size < other._size; ++_size) {
+            new (&_data[_size]) T(other._data[_size]);
+        }
         _dummy = T();
-        // std::cout << "\033[36mALLOC " << _capacity << " (" << _capacity * sizeof(T) << ")\033[0m\n";
-        detail::copy(&other._data[0], &other._data[_capacity], &_data[0]);
     }
     return *this;
 }
 
-template <typename T>
-DynamicArray<T>::~DynamicArray () {
+template <typename T, typename Allocator>
+DynamicArray<T, Allocator>::~DynamicArray () {
     if (_data) {
-        delete[] _data;
+        detail::destroy(&_data[0], &_data[_size]);
+        AllocTraits::deallocate(_alloc, _data, _capacity);
         _data = nullptr;
-        // std::cout << "\033[35mDEALLOC " << _capacity << " (" << _capacity * sizeof(T) << ")\033[0m\n";
     }
 }
 
-template <typename T>
-void DynamicArray<T>::capacity (size_t cap) {
-    if (cap < 10) cap = 10;
-
-    // std::cout << "\033[34mresizing " << _capacity << " => " << cap << "\033[0m\n";
-
+template <typename T, typename Allocator>
+void DynamicArray<T, Allocator>::reserve (size_t cap) {
     if (cap > _capacity) {
-        // Allocate new array
-        T* newData = new T[cap];
-        // std::cout << "\033[36mALLOC " << _capacity << " (" << _capacity * sizeof(T) << ")\033[0m\n";
-
-        // Copy existing data
-        if (_capacity != 0) {
-            detail::copy(&_data[0], &_data[_capacity], &newData[0]);
-        }
-        // Fill remaining data with zeroes
-        assert(_capacity < cap);
-        detail::fill(&newData[_capacity], &newData[cap], T());
-
-        // Delete old array, and replace array / capacity
+        // Allocate new (uninitialized) storage + move live elements into it
+        T* newData = AllocTraits::allocate(_alloc, cap);
         if (_data != nullptr) {
-            delete[] _data;
-            _data = nullptr;
-            // std::cout << "\033[35mDEALLOC " << _capacity << " (" << _capacity * sizeof(T) << ")\033[0m\n";
+            detail::relocate(_data, _size, newData, std::is_trivially_copyable<T>());
+            AllocTraits::deallocate(_alloc, _data, _capacity);
         }
         _data = newData;
         _capacity = cap;
     }
 }
 
-template <typename T>
-const T& DynamicArray<T>::operator[] (int i) const {
-    return i < 0 || i > _capacity ? _dummy : _data[i];
+template <typename T, typename Allocator>
+void DynamicArray<T, Allocator>::resize (size_t n) {
+    if (n > _size) {
+        reserve(n);
+        for (; _size < n; ++_size) {
+            new (&_data[_size]) T();
+        }
+    } else {
+        detail::destroy(&_data[n], &_data[_size]);
+        _size = n;
+    }
 }
-template <typename T>
-T& DynamicArray<T>::operator[] (int i) {
+
+template <typename T, typename Allocator>
+void DynamicArray<T, Allocator>::capacity (size_t cap) {
+    if (cap < 10) cap = 10;
+    reserve(cap);
+}
+
+template <typename T, typename Allocator>
+const T& DynamicArray<T, Allocator>::operator[] (int i) const {
+    // Slots past size() were never written, so they'd read as T() anyway
+    return i < 0 || static_cast<size_t>(i) >= _size ? _dummy : _data[i];
+}
+template <typename T, typename Allocator>
+T& DynamicArray<T, Allocator>::operator[] (int i) {
     if (i < 0) return _dummy = {};
-    if (i >= _capacity) {
-        // Resize capacity
-        capacity(detail::nextPow2(i+1));
-        assert(_capacity >= i);
+    if (static_cast<size_t>(i) >= _size) {
+        // Grow capacity geometrically, but only construct elements up to i
+        if (static_cast<size_t>(i) >= _capacity) {
+            reserve(detail::nextPow2(i+1));
+        }
+        resize(i+1);
+        assert(_size > static_cast<size_t>(i));
     }
     return _data[i]; 
 }
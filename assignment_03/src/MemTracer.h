@@ -0,0 +1,93 @@
+// Programmer: Seiji Emery
+// Programmer ID: M00202623
+//
+// MemTracer.h
+//
+// Memory + time benchmarking code: this hijacks (overloads) global new / delete
+// to trace memory allocations (very simple: # of allocations / frees + # bytes
+// allocated / freed), and adds a global variable that displays this stuff
+// from its dtor (guaranteed to be called after main() but before program exits).
+//
+// It also adds basic time profiling (global ctor / dtor) using std::chrono.
+//
+// LocalMemoryTracer measures the allocations made between enter() and exit().
+//
+// Defines (replaces) global operator new / delete, so include it from the program's main
+// translation unit only. This can all be disabled if compiling with -D NO_MEM_DEBUG.
+//
+// Remote source:
+// https://github.com/SeijiEmery/comp220/tree/master/assignment_03/src/MemTracer.h
+//
+
+#ifndef MemTracer_h
+#define MemTracer_h
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <chrono>
+#include <iostream>
+
+#ifndef NO_MEM_DEBUG
+
+struct MemTracer {
+    void traceAlloc (size_t bytes) { ++numAllocations; allocatedMem += bytes; }
+    void traceFreed (size_t bytes) { ++numFrees; freedMem += bytes;}
+private:
+    size_t numAllocations = 0;  // number of allocations in this program
+    size_t numFrees       = 0;  // number of deallocations in this program
+    size_t allocatedMem   = 0;  // bytes allocated
+    size_t freedMem       = 0;  // bytes freed
+
+    std::chrono::high_resolution_clock::time_point t0;  // time at program start
+public:
+    MemTracer () : t0(std::chrono::high_resolution_clock::now()) {}
+    ~MemTracer () {
+        using namespace std::chrono;
+        auto t1 = high_resolution_clock::now();
+        std::cout << "\nUsed  memory: " << ((double)allocatedMem) * 1e-6 << " MB (" << numAllocations << " allocations)\n";
+        std::cout << "Freed memory: "   << ((double)freedMem)     * 1e-6 << " MB (" << numFrees       << " deallocations)\n";
+        std::cout << "Ran in " << duration_cast<duration<double>>(t1 - t0).count() * 1e3 << " ms\n";
+    }
+    size_t totalMemory () const { return allocatedMem; }
+    size_t totalAllocations () const { return numAllocations;  }
+} g_memTracer;
+
+void* operator new (size_t size) {
+    g_memTracer.traceAlloc(size);
+    size_t* mem = (size_t*)std::malloc(size + sizeof(size_t));
+    if (!mem) {
+        throw std::bad_alloc();
+    }
+    mem[0] = size;
+    return (void*)(&mem[1]);
+}
+void operator delete (void* mem) noexcept {
+    if (!mem) return;
+    auto ptr = &((size_t*)mem)[-1];
+    g_memTracer.traceFreed(ptr[0]);
+    std::free(ptr);
+}
+
+#endif // NO_MEM_DEBUG
+
+struct LocalMemoryTracer {
+    size_t initialMemory = 0;
+    size_t initialAllocs = 0;
+    size_t usedMemory = 0;  // # bytes of memory allocated
+    size_t usedAllocs = 0;  // # allocations
+
+    void enter () {
+        #ifndef NO_MEM_DEBUG
+        initialMemory = g_memTracer.totalMemory();
+        initialAllocs = g_memTracer.totalAllocations();
+        #endif
+    }
+    void exit () {
+        #ifndef NO_MEM_DEBUG
+        usedMemory = g_memTracer.totalMemory() - initialMemory;
+        usedAllocs = g_memTracer.totalAllocations() - initialAllocs;
+        #endif
+    }
+};
+
+#endif // MemTracer_h
@@ -0,0 +1,174 @@
+// Programmer: Seiji Emery
+// Programmer ID: M00202623
+//
+// PoolAllocator.h
+// Fixed-size node pool + std-compatible PoolAllocator<T>, for node based containers (Stack, Queue)
+// that allocate and free one node at a time.
+//
+// Nodes are carved out of slabs of (at least) 64 nodes, so a container does one heap allocation
+// per 64+ pushes instead of one per push. Free nodes are kept on intrusive free lists:
+//
+//  – each thread has a local cache (no locking on the fast path), which refills from / spills
+//    back to a shared, mutex-protected pool in batches of one slab's worth of nodes
+//  – slabs are owned by the shared pool (and are only released at program exit), so a node
+//    may be freed on a different thread than the one that allocated it
+//  – slabs come from the global operator new, so programs that trace it (the MemTracer in
+//    MyRPNCalculator / Simulation) still count node memory: one allocation per slab
+//
+// Remote source:
+// https://github.com/SeijiEmery/comp220/tree/master/assignment_03/src/PoolAllocator.h
+//
+
+#ifndef PoolAllocator_h
+#define PoolAllocator_h
+#include <cstddef>      // size_t, std::max_align_t
+#include <new>          // operator new / delete
+#include <mutex>
+#include <atomic>
+
+namespace detail {
+
+// Total # of slabs allocated by all FixedSizePools (for benchmarks / diagnostics)
+inline std::atomic<size_t>& poolSlabsAllocated () {
+    static std::atomic<size_t> count (0);
+    return count;
+}
+
+// Pool of fixed-size blocks (one pool per block size + alignment)
+template <size_t Size, size_t Align>
+class FixedSizePool {
+    static_assert(Align <= alignof(std::max_align_t), "FixedSizePool slabs are only aligned to max_align_t");
+    struct FreeBlock { FreeBlock* next; };
+    struct Slab      { Slab* prev; };
+
+public:
+    static const size_t blockSize  = ((Size > sizeof(FreeBlock) ? Size : sizeof(FreeBlock)) + Align - 1) / Align * Align;
+    static const size_t slabHeader = (sizeof(Slab) + Align - 1) / Align * Align;
+    static const size_t blocksPerSlab = 4096 / blockSize > 64 ? 4096 / blockSize : 64;
+
+private:
+    // Free list: singly linked through the free blocks themselves
+    struct FreeList {
+        FreeBlock* head  = nullptr;
+        size_t     count = 0;
+
+        void push (void* ptr) {
+            FreeBlock* block = static_cast<FreeBlock*>(ptr);
+            block->next = head;
+            head = block;
+            ++count;
+        }
+        void* pop () {
+            FreeBlock* block = head;
+            head = block->next;
+            --count;
+            return block;
+        }
+        // Moves (up to) n blocks from this list onto other
+        void transfer (FreeList& other, size_t n) {
+            while (n-- && head) {
+                other.push(pop());
+            }
+        }
+    };
+
+    // Shared pool: owns all slabs
+    struct SharedPool {
+        std::mutex mutex;
+        FreeList   free;
+        Slab*      slabs = nullptr;
+        size_t     numSlabs = 0;
+
+        ~SharedPool () {
+            while (slabs) {
+                Slab* prev = slabs->prev;
+                ::operator delete(static_cast<void*>(slabs));
+                slabs = prev;
+            }
+        }
+        // Hands out one slab's worth of blocks to cache (allocating a new slab if we're out)
+        void refill (FreeList& cache) {
+            std::lock_guard<std::mutex> lock (mutex);
+            if (free.count == 0) {
+                char* mem = static_cast<char*>(::operator new(slabHeader + blockSize * blocksPerSlab));
+                Slab* slab = reinterpret_cast<Slab*>(mem);
+                slab->prev = slabs;
+                slabs = slab;
+                ++numSlabs;
+                ++poolSlabsAllocated();
+                for (size_t i = blocksPerSlab; i --> 0; ) {
+                    cache.push(mem + slabHeader + i * blockSize);
+                }
+            } else {
+                free.transfer(cache, blocksPerSlab);
+            }
+        }
+        void release (FreeList& cache, size_t n) {
+            std::lock_guard<std::mutex> lock (mutex);
+            cache.transfer(free, n);
+        }
+    };
+    static SharedPool& shared () {
+        static SharedPool pool;
+        return pool;
+    }
+
+    // Per thread cache: returns its blocks to the shared pool when the thread exits
+    struct LocalCache {
+        FreeList free;
+        LocalCache () { shared(); }     // (ensures the shared pool outlives us)
+        ~LocalCache () { shared().release(free, free.count); }
+    };
+    static LocalCache& local () {
+        static thread_local LocalCache cache;
+        return cache;
+    }
+
+public:
+    static void* allocate () {
+        LocalCache& cache = local();
+        if (!cache.free.head) {
+            shared().refill(cache.free);
+        }
+        return cache.free.pop();
+    }
+    static void deallocate (void* ptr) {
+        LocalCache& cache = local();
+        cache.free.push(ptr);
+        if (cache.free.count >= 2 * blocksPerSlab) {
+            shared().release(cache.free, blocksPerSlab);
+        }
+    }
+
+    // # of slabs allocated so far (all threads)
+    static size_t slabCount () {
+        std::lock_guard<std::mutex> lock (shared().mutex);
+        return shared().numSlabs;
+    }
+};
+
+} // namespace detail
+
+// Single object allocations (count == 1) come from the FixedSizePool for sizeof(T) / alignof(T);
+// array allocations fall back to operator new. Stateless: all PoolAllocators compare equal.
+template <typename T>
+struct PoolAllocator {
+    typedef T value_type;
+    typedef detail::FixedSizePool<sizeof(T), alignof(T)> Pool;
+
+    PoolAllocator () {}
+    template <typename U> PoolAllocator (const PoolAllocator<U>&) {}
+
+    T* allocate (size_t count) {
+        return static_cast<T*>(count == 1 ? Pool::allocate() : ::operator new(count * sizeof(T)));
+    }
+    void deallocate (T* ptr, size_t count) {
+        if (count == 1) Pool::deallocate(ptr);
+        else            ::operator delete(static_cast<void*>(ptr));
+    }
+
+    template <typename U> bool operator== (const PoolAllocator<U>&) const { return true; }
+    template <typename U> bool operator!= (const PoolAllocator<U>&) const { return false; }
+};
+
+#endif // PoolAllocator_h
@@ -0,0 +1,69 @@
+// Programmer: Seiji Emery
+// Programmer ID: M00202623
+//
+// SmallDynamicArray.bench.cpp
+//
+// Allocation-count benchmark for SmallDynamicArray<T, N> vs DynamicArray<T>: builds a large
+// number of short-lived arrays w/ k elements each (like the per-course lists / filter keys
+// in the dvc programs), and reports heap allocations, bytes + time per array (via MemTracer).
+//
+// Remote source:
+// https://github.com/SeijiEmery/comp220/tree/master/assignment_03/src/SmallDynamicArray.bench.cpp
+//
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include "DynamicArray.h"
+#include "SmallDynamicArray.h"
+#include "MemTracer.h"
+
+const size_t NUM_ARRAYS = 100000;
+
+// Builds NUM_ARRAYS arrays of k elements (via operator[], so they grow as needed);
+// displays allocations / bytes / ns per array
+template <typename Array, typename T>
+void benchArrays (const char* name, size_t k, const T& value) {
+    using namespace std::chrono;
+    LocalMemoryTracer memory;
+    size_t numCorrect = 0;
+
+    memory.enter();
+    auto t0 = high_resolution_clock::now();
+    for (size_t n = 0; n < NUM_ARRAYS; ++n) {
+        Array array;
+        for (size_t i = 0; i < k; ++i) {
+            array[static_cast<int>(i)] = value;
+        }
+        numCorrect += array[static_cast<int>(k - 1)] == value;
+    }
+    auto t1 = high_resolution_clock::now();
+    memory.exit();
+
+    if (numCorrect != NUM_ARRAYS) {
+        std::cerr << "FAILED: " << name << " has the wrong contents" << std::endl;
+        exit(-1);
+    }
+    std::cout << "  " << std::setw(36) << std::left << name << std::right
+        << std::setw(8) << std::setprecision(3) << (double)memory.usedAllocs / NUM_ARRAYS << " allocs"
+        << std::setw(10) << std::setprecision(4) << (double)memory.usedMemory / NUM_ARRAYS << " bytes"
+        << std::setw(10) << std::setprecision(4) << duration_cast<duration<double>>(t1 - t0).count() * 1e9 / NUM_ARRAYS << " ns"
+        << "  (per array)\n";
+}
+
+int main () {
+    std::cout << "Programmer: Seiji Emery\n"
+              << "Programmer's id: M00202623\n"
+              << "File: " __FILE__ "\n";
+
+    for (size_t k : { 1, 2, 4, 8, 16, 32 }) {
+        std::cout << "\n" << NUM_ARRAYS << " arrays of " << k << " elements:\n";
+        benchArrays<DynamicArray<size_t>>           ("DynamicArray<size_t>", k, (size_t)42);
+        benchArrays<SmallDynamicArray<size_t, 8>>   ("SmallDynamicArray<size_t, 8>", k, (size_t)42);
+        benchArrays<DynamicArray<std::string>>      ("DynamicArray<std::string>", k, std::string("COMSC"));
+        benchArrays<SmallDynamicArray<std::string, 8>>("SmallDynamicArray<std::string, 8>", k, std::string("COMSC"));
+    }
+    return 0;
+}
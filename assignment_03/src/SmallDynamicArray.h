@@ -0,0 +1,177 @@
+// Programmer: Seiji Emery
+// Programmer ID: M00202623
+//
+// SmallDynamicArray.h
+// Implements a DynamicArray variant w/ inline capacity: the first N elements are stored
+// inside the object itself, and the array only spills to the heap once it grows past N.
+// Most of the DynamicArrays in the dvc programs hold a handful of elements, and a plain
+// DynamicArray always heap-allocates (and grows to at least 10 elements).
+//
+// Has the same accessor API as DynamicArray (bounds checked + growing operator[], capacity,
+// size / reserve / resize, data / begin / end / unchecked / view), and the same
+// Allocator parameter (only used once the array spills to the heap).
+//
+// Remote source:
+// https://github.com/SeijiEmery/comp220/tree/master/assignment_03/src/SmallDynamicArray.h
+//
+
+#ifndef SmallDynamicArray_h
+#define SmallDynamicArray_h
+#include "DynamicArray.h"   // ArrayView + detail helpers
+
+template <typename T, size_t N, typename Allocator = std::allocator<T>>
+class SmallDynamicArray {
+    static_assert(N > 0, "SmallDynamicArray requires an inline capacity of at least 1");
+    typedef std::allocator_traits<Allocator> AllocTraits;
+
+    size_t    _capacity = N;
+    size_t    _size = 0;
+    T*        _data;            // points to _inline until we spill to the heap
+    T         _dummy;
+    Allocator _alloc;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type _inline[N];
+
+    T*   inlineData () { return reinterpret_cast<T*>(&_inline[0]); }
+    bool isInline () const { return _data == reinterpret_cast<const T*>(&_inline[0]); }
+
+public:
+    // Constructors, assignment operators, destructor
+    SmallDynamicArray (size_t count = 0, const Allocator& alloc = Allocator())
+        : _data(inlineData()), _dummy(T()), _alloc(alloc) { resize(count); }
+    SmallDynamicArray (const SmallDynamicArray& other)
+        : _data(inlineData()), _dummy(T()), _alloc(AllocTraits::select_on_container_copy_construction(other._alloc)) { *this = other; }
+    SmallDynamicArray (SmallDynamicArray&& other)
+        : _data(inlineData()), _dummy(T()), _alloc(other._alloc) { *this = std::move(other); }
+    SmallDynamicArray& operator= (const SmallDynamicArray& other);
+    SmallDynamicArray& operator= (SmallDynamicArray&& other);
+    ~SmallDynamicArray ();
+
+    // Get / set array capacity. capacity(cap) reserves storage for at least cap elements, like
+    // reserve(); it never changes size() (use resize() for that).
+    void capacity (size_t cap) { reserve(cap); }
+    size_t capacity () const { return _capacity; }
+
+    // Number of live (constructed) elements
+    size_t size () const { return _size; }
+
+    // True iff elements are still stored inline (no heap allocation)
+    bool small () const { return isInline(); }
+
+    // Allocates storage for at least cap elements without constructing any
+    void reserve (size_t cap);
+
+    // Grows / shrinks the live range to exactly n elements (new elements are default-constructed)
+    void resize (size_t n);
+
+    // Get / set array elements. Elements out of range returns reference to dummy variable.
+    const T& operator[] (int i) const {
+        return i < 0 || static_cast<size_t>(i) >= _size ? _dummy : _data[i];
+    }
+    T& operator[] (int i) {
+        if (i < 0) return _dummy = {};
+        if (static_cast<size_t>(i) >= _size) {
+            if (static_cast<size_t>(i) >= _capacity) {
+                reserve(detail::nextPow2(i+1));
+            }
+            resize(i+1);
+        }
+        return _data[i];
+    }
+
+    // Unchecked access to the live range [0, size()): no bounds checks and no growth.
+    T*       data ()       { return _data; }
+    const T* data () const { return _data; }
+
+    T*       begin ()       { return _data; }
+    T*       end   ()       { return _data + _size; }
+    const T* begin () const { return _data; }
+    const T* end   () const { return _data + _size; }
+
+    T&       unchecked (size_t i)       { assert(i < _size); return _data[i]; }
+    const T& unchecked (size_t i) const { assert(i < _size); return _data[i]; }
+
+    ArrayView<T>       view ()       { return { _data, _size }; }
+    ArrayView<const T> view () const { return { _data, _size }; }
+
+    const Allocator& get_allocator () const { return _alloc; }
+};
+
+//
+// SmallDynamicArray implementation
+//
+
+template <typename T, size_t N, typename Allocator>
+SmallDynamicArray<T,N,Allocator>& SmallDynamicArray<T,N,Allocator>::operator= (const SmallDynamicArray& other) {
+    if (this != &other) {
+        resize(0);
+        reserve(other._size);
+        for (; _size < other._size; ++_size) {
+            new (&_data[_size]) T(other._data[_size]);
+        }
+        _dummy = T();
+    }
+    return *this;
+}
+
+template <typename T, size_t N, typename Allocator>
+SmallDynamicArray<T,N,Allocator>& SmallDynamicArray<T,N,Allocator>::operator= (SmallDynamicArray&& other) {
+    if (this != &other) {
+        resize(0);
+        if (!other.isInline()) {
+            // Steal other's heap storage; other falls back to its (empty) inline buffer
+            if (!isInline()) {
+                AllocTraits::deallocate(_alloc, _data, _capacity);
+            }
+            std::swap(_alloc, other._alloc);
+            _data = other._data;
+            _capacity = other._capacity;
+            _size = other._size;
+            other._data = other.inlineData();
+            other._capacity = N;
+        } else {
+            // Inline elements can't be stolen, so move them one by one
+            reserve(other._size);
+            detail::relocate(other._data, other._size, _data, std::is_trivially_copyable<T>());
+            _size = other._size;
+        }
+        other._size = 0;
+        std::swap(_dummy, other._dummy);
+    }
+    return *this;
+}
+
+template <typename T, size_t N, typename Allocator>
+SmallDynamicArray<T,N,Allocator>::~SmallDynamicArray () {
+    detail::destroy(&_data[0], &_data[_size]);
+    if (!isInline()) {
+        AllocTraits::deallocate(_alloc, _data, _capacity);
+    }
+}
+
+template <typename T, size_t N, typename Allocator>
+void SmallDynamicArray<T,N,Allocator>::reserve (size_t cap) {
+    if (cap > _capacity) {
+        T* newData = AllocTraits::allocate(_alloc, cap);
+        detail::relocate(_data, _size, newData, std::is_trivially_copyable<T>());
+        if (!isInline()) {
+            AllocTraits::deallocate(_alloc, _data, _capacity);
+        }
+        _data = newData;
+        _capacity = cap;
+    }
+}
+
+template <typename T, size_t N, typename Allocator>
+void SmallDynamicArray<T,N,Allocator>::resize (size_t n) {
+    if (n > _size) {
+        reserve(n);
+        for (; _size < n; ++_size) {
+            new (&_data[_size]) T();
+        }
+    } else {
+        detail::destroy(&_data[n], &_data[_size]);
+        _size = n;
+    }
+}
+
+#endif // SmallDynamicArray_h
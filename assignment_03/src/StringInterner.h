@@ -0,0 +1,122 @@
+// Programmer: Seiji Emery
+// Programmer ID: M00202623
+//
+// StringInterner.h
+// Maps strings (pointer + length, no std::string needed) to dense uint16 ids: 0, 1, 2... in the
+// order they were first seen. Meant for small sets of short, heavily repeated keys, like the DVC
+// subjects ("MATH", "COMSC") or courses: count / group by id (an array index) instead of
+// re-materializing + comparing std::strings.
+//
+// Each distinct string's bytes are copied once, '\0' terminated, into a LinearArena (Allocators.h);
+// lookups hash the key (FNV-1a) into an open addressed table of ids (linear probing, power of 2
+// size, <= 50% load), so interning a string that was already seen doesn't allocate.
+//
+// Remote source:
+// https://github.com/SeijiEmery/comp220/tree/master/assignment_03/src/StringInterner.h
+//
+
+#ifndef StringInterner_h
+#define StringInterner_h
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include "Allocators.h"
+
+class StringInterner {
+public:
+    typedef uint16_t Id;
+    enum : Id     { NOT_FOUND   = 0xFFFF };    // (also marks empty table slots)
+    enum : size_t { MAX_STRINGS = 0xFFFF };
+private:
+    struct Entry {
+        const char* str;        // '\0' terminated copy, in arena
+        uint32_t    length;
+        uint32_t    hash;
+    };
+    std::vector<Entry> entries;                 // by id
+    std::vector<Id>    table;
+    LinearArena        arena;
+
+    static uint32_t hashString (const char* str, size_t length) {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < length; ++i) {
+            hash = (hash ^ (uint8_t)str[i]) * 16777619u;
+        }
+        return hash;
+    }
+    // Slot of str in table: either the slot holding its id, or the empty slot it would go in
+    size_t slot (const char* str, size_t length, uint32_t hash) const {
+        size_t mask = table.size() - 1;
+        for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+            Id id = table[i];
+            if (id == NOT_FOUND) return i;
+            const Entry& entry = entries[id];
+            if (entry.hash == hash && entry.length == length && memcmp(entry.str, str, length) == 0) return i;
+        }
+    }
+    void rehash (size_t size) {
+        table.assign(size, (Id)NOT_FOUND);
+        for (size_t id = 0; id < entries.size(); ++id) {
+            size_t mask = size - 1, i = entries[id].hash & mask;
+            while (table[i] != NOT_FOUND) i = (i + 1) & mask;
+            table[i] = (Id)id;
+        }
+    }
+public:
+    StringInterner (size_t expectedStrings = 128) : arena(4 * 1024) {
+        size_t size = 16;
+        while (size < expectedStrings * 2) size *= 2;
+        table.assign(size, (Id)NOT_FOUND);
+        entries.reserve(expectedStrings);
+    }
+
+    // Returns str's id, adding it if it's new. Throws std::length_error past MAX_STRINGS strings.
+    Id intern (const char* str, size_t length) {
+        uint32_t hash = hashString(str, length);
+        size_t   i    = slot(str, length, hash);
+        if (table[i] != NOT_FOUND) return table[i];
+
+        if (entries.size() >= MAX_STRINGS) {
+            throw std::length_error("StringInterner: too many strings");
+        }
+        char* copy = static_cast<char*>(arena.allocate(length + 1, 1));
+        memcpy(copy, str, length);
+        copy[length] = '\0';
+        Id id = (Id)entries.size();
+        entries.push_back({ copy, (uint32_t)length, hash });
+        table[i] = id;
+        if (entries.size() * 2 > table.size()) {
+            rehash(table.size() * 2);
+        }
+        return id;
+    }
+    Id intern (const char* str)        { return intern(str, strlen(str)); }
+    Id intern (const std::string& str) { return intern(str.data(), str.size()); }
+
+    // str's id, or NOT_FOUND (doesn't add it)
+    Id find (const char* str, size_t length) const {
+        return table[slot(str, length, hashString(str, length))];
+    }
+
+    const char* str    (Id id) const { return entries[id].str; }     // ('\0' terminated)
+    size_t      length (Id id) const { return entries[id].length; }
+    size_t      size   () const { return entries.size(); }
+
+    size_t stringBytes () const { return arena.bytesAllocated(); }   // (interned strings only)
+
+    // Bytes used by the interned strings (arena) + the id / lookup tables
+    size_t memoryUsed () const {
+        return arena.bytesAllocated() + entries.capacity() * sizeof(Entry) + table.capacity() * sizeof(Id);
+    }
+
+    void clear () {
+        entries.clear();
+        table.assign(table.size(), (Id)NOT_FOUND);
+        arena.reset();
+    }
+};
+
+#endif // StringInterner_h
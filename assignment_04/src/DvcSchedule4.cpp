@@ -44,6 +44,7 @@
 using namespace std;
 
 #include <cstring>
+#include <cctype>
 
 // Our dynamic array impl from assignment 3.
 #include "DynamicArray.h"
@@ -103,7 +104,7 @@ int main (int argc, const char** argv) {
     const char* path = nullptr;
     switch (argc) {
         case 1: path = "dvc-schedule.txt"; break;
-        case 2: path = argv[0]; break;
+        case 2: path = argv[1]; break;
         default: {
             std::cerr << "usage: " << argv[0] << " [path-to-dvc-schedule.txt]" << std::endl;
             exit(-1);
@@ -154,12 +155,12 @@ int main (int argc, const char** argv) {
 
         // 2. 5-bit hash code for year, normalized to starting year (2000 = 0).
         //    This is sufficient to accomodate years in range [2000, 2032), and will fail / hash collide after that
-        assert(isnumber(s[0]) && s[4] == '\t');
+        assert(isdigit(s[0]) && s[4] == '\t');
         size_t hash = semester | (((atoi(s) - 2000) & 31) << 2);
         s += 5;
 
         // 3. n-bit section # (4 digits => should be at most 14 bits, but can be whatever)
-        assert(isnumber(s[0]) && s[4] == '\t');
+        assert(isdigit(s[0]) && s[4] == '\t');
         size_t code = atoi(s);
         hash |= (code << 8);
         s += 5;
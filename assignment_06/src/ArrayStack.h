@@ -0,0 +1,213 @@
+// Programmer: Seiji Emery
+// Programmer ID: M00202623
+//
+// ArrayStack.h
+// Stack implementation backed by a contiguous (geometrically growing) array. Same API as
+// Stack (push / pop / peek / size / empty / clear / swap), plus const iterators that walk the
+// stack top to bottom without modifying it (ie. no need to copy + pop to display it).
+//
+// With CopyOnWrite = true (CowStack<T>), copies are O(1) snapshots: they share the array
+// (refcounted) until one of them is mutated. pop() on a shared array only shrinks the
+// popping stack's view of it; push / swap / non-const peek copy the live elements into a new
+// array first. Refcounts are not atomic, so snapshots must not be shared between threads.
+//
+// Remote source:
+// https://github.com/SeijiEmery/comp220/tree/master/assignment_06/src/ArrayStack.h
+//
+
+#ifndef ArrayStack_h
+#define ArrayStack_h
+#include <cassert>
+#include <cstddef>      // size_t
+#include <cstdint>      // uint8_t
+#include <iterator>     // std::reverse_iterator
+#include <memory>       // std::allocator, std::allocator_traits
+#include <utility>      // std::move, std::swap
+
+template <typename T, bool CopyOnWrite = false, typename Allocator = std::allocator<T>>
+class ArrayStack {
+    // Array block: header followed by capacity elements, of which [0, constructed) are live
+    struct Header {
+        size_t refs;
+        size_t capacity;
+        size_t constructed;
+    };
+    static const size_t dataOffset = (sizeof(Header) + alignof(T) - 1) / alignof(T) * alignof(T);
+
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<uint8_t> ByteAllocator;
+    typedef std::allocator_traits<ByteAllocator>                                      ByteTraits;
+
+    Header*       block  = nullptr;
+    size_t        length = 0;       // # of elements in this stack (<= block->constructed)
+    ByteAllocator alloc;
+
+    static T* elements (Header* block) {
+        return reinterpret_cast<T*>(reinterpret_cast<uint8_t*>(block) + dataOffset);
+    }
+    static size_t blockSize (size_t capacity) { return dataOffset + capacity * sizeof(T); }
+
+    Header* allocateBlock (size_t capacity) {
+        Header* header = reinterpret_cast<Header*>(ByteTraits::allocate(alloc, blockSize(capacity)));
+        header->refs = 1;
+        header->capacity = capacity;
+        header->constructed = 0;
+        return header;
+    }
+    static void destroy (T* begin, T* end) {
+        for (; begin != end; ++begin) {
+            begin->~T();
+        }
+    }
+    void release () {
+        if (block && --block->refs == 0) {
+            destroy(elements(block), elements(block) + block->constructed);
+            ByteTraits::deallocate(alloc, reinterpret_cast<uint8_t*>(block), blockSize(block->capacity));
+        }
+        block = nullptr;
+    }
+    // Copies (if shared) or moves (if unique) our live elements into a new block w/ capacity cap
+    void reallocate (size_t cap) {
+        assert(cap >= length);
+        Header* newBlock = allocateBlock(cap);
+        T* src = elements(block), *dst = elements(newBlock);
+        if (shared()) {
+            for (size_t i = 0; i < length; ++i) new (&dst[i]) T(src[i]);
+        } else {
+            for (size_t i = 0; i < length; ++i) new (&dst[i]) T(std::move(src[i]));
+        }
+        newBlock->constructed = length;
+        release();
+        block = newBlock;
+    }
+    // Makes the block unique (copy on write), w/ room for at least minCapacity elements and
+    // exactly length constructed elements
+    void prepareWrite (size_t minCapacity) {
+        if (!block) {
+            block = allocateBlock(minCapacity > 8 ? minCapacity : 8);
+        } else if (shared() || minCapacity > block->capacity) {
+            size_t cap = block->capacity;
+            while (cap < minCapacity) cap *= 2;
+            reallocate(cap);
+        } else if (block->constructed > length) {
+            destroy(elements(block) + length, elements(block) + block->constructed);
+            block->constructed = length;
+        }
+    }
+    bool needsWrite (size_t minCapacity) const {
+        return !block || block->refs > 1 || minCapacity > block->capacity || block->constructed != length;
+    }
+    void copyFrom (const ArrayStack& other) {
+        if (CopyOnWrite) {
+            block = other.block;
+            length = other.length;
+            if (block) ++block->refs;
+        } else if (other.length) {
+            block = allocateBlock(other.length);
+            T* src = elements(other.block), *dst = elements(block);
+            for (size_t i = 0; i < other.length; ++i) new (&dst[i]) T(src[i]);
+            block->constructed = length = other.length;
+        }
+    }
+public:
+    typedef T value_type;
+
+    ArrayStack (const Allocator& alloc = Allocator()) : alloc(alloc) {}
+    ArrayStack (const T& value, const Allocator& alloc = Allocator()) : alloc(alloc) { push(value); }
+    ArrayStack (const ArrayStack& other) :
+        alloc(ByteTraits::select_on_container_copy_construction(other.alloc))
+    { copyFrom(other); }
+    ArrayStack (ArrayStack&& other) : alloc(other.alloc) {
+        std::swap(block, other.block);
+        std::swap(length, other.length);
+    }
+    ~ArrayStack () { release(); }
+
+    ArrayStack& operator= (const ArrayStack& other) {
+        if (this != &other) {
+            release();
+            length = 0;
+            copyFrom(other);
+        }
+        return *this;
+    }
+    ArrayStack& operator= (ArrayStack&& other) {
+        if (this != &other) {
+            std::swap(block, other.block);
+            std::swap(length, other.length);
+            std::swap(alloc, other.alloc);
+        }
+        return *this;
+    }
+
+    void push (T&& value) {
+        if (needsWrite(length + 1)) {
+            T temp (std::move(value));     // (value may live in our current block)
+            prepareWrite(length + 1);
+            new (&elements(block)[length]) T(std::move(temp));
+        } else {
+            new (&elements(block)[length]) T(std::move(value));
+        }
+        block->constructed = ++length;
+    }
+    void push (const T& value) {
+        if (needsWrite(length + 1)) {
+            T temp (value);
+            prepareWrite(length + 1);
+            new (&elements(block)[length]) T(std::move(temp));
+        } else {
+            new (&elements(block)[length]) T(value);
+        }
+        block->constructed = ++length;
+    }
+    T& peek () {
+        assert(!empty());
+        if (needsWrite(length)) prepareWrite(length);
+        return elements(block)[length - 1];
+    }
+    const T& peek () const {
+        assert(!empty());
+        return elements(block)[length - 1];
+    }
+    void pop () {
+        if (length) {
+            if (!shared() && block->constructed == length) {
+                elements(block)[length - 1].~T();
+                --block->constructed;
+            }
+            --length;
+        }
+    }
+    size_t size () const { return length; }
+    bool empty () const { return length == 0; }
+    size_t capacity () const { return block ? block->capacity : 0; }
+
+    // True iff this stack currently shares its array w/ a snapshot (CopyOnWrite only)
+    bool shared () const { return block && block->refs > 1; }
+
+    void clear () {
+        if (shared()) {
+            release();
+        } else if (block) {
+            destroy(elements(block), elements(block) + block->constructed);
+            block->constructed = 0;
+        }
+        length = 0;
+    }
+    void swap () {
+        if (size() >= 2) {
+            if (needsWrite(length)) prepareWrite(length);
+            std::swap(elements(block)[length - 1], elements(block)[length - 2]);
+        }
+    }
+
+    // Iterates elements from the top of the stack to the bottom
+    typedef std::reverse_iterator<const T*> const_iterator;
+
+    const_iterator begin () const { return const_iterator(block ? elements(block) + length : nullptr); }
+    const_iterator end   () const { return const_iterator(block ? elements(block) : nullptr); }
+};
+
+template <typename T, typename Allocator = std::allocator<T>>
+using CowStack = ArrayStack<T, true, Allocator>;
+
+#endif // ArrayStack_h
@@ -37,7 +37,7 @@ using namespace std;
 
 #include <cstdlib>
 #include <cmath>
-#include "Stack.h"
+#include "ArrayStack.h"
 
 // #define ASSIGNMENT_SPEC     // for a more interesting program, comment out this line
 
@@ -105,13 +105,16 @@ void operator delete (void* mem) throw() {
 
 #endif // NO_MEM_DEBUG
 
-template <typename T>
-T popBack (Stack<T>& stack, T default_ = T()) {
+template <typename Stack, typename T = typename Stack::value_type>
+T popBack (Stack& stack, T default_ = T()) {
     T back = stack.empty() ? default_ : stack.peek();
     stack.pop();
     return back;
 }
 
+// Unfinished sketch of a more general (typed, extensible) interpreter. Doesn't compile yet,
+// so it's excluded from the build; the calculator in main() doesn't depend on it.
+#ifdef RPN_INTERPRETER_WIP
 struct InterpreterState;
 struct Type;
 
@@ -395,6 +398,7 @@ void example () {
         animal->speak();
     }
 }
+#endif // RPN_INTERPRETER_WIP
 
 
 int main () {
@@ -402,7 +406,7 @@ int main () {
     std::cout << "Programmer's ID:  M00202623\n";
     std::cout << "File:             " << __FILE__ << '\n' << std::endl;
 
-    Stack<double> values;
+    ArrayStack<double> values;
     std::string line, input;
     bool        running = true;
 
@@ -416,10 +420,8 @@ int main () {
                 std::cout << "empty ";
             #endif
         } else {
-            auto copy = values;
-            while (!copy.empty()) {
-                std::cout << copy.peek() << " ";
-                copy.pop();
+            for (auto value : values) {     // (top to bottom)
+                std::cout << value << " ";
             }
         }
     };
@@ -433,7 +435,7 @@ int main () {
             writeStack();
         // #endif
         std::cout << "\033[0m";
-        while (!getline(cin, line));
+        if (!getline(cin, line)) break;     // (EOF: used to spin forever here)
         // std::cin >> line;
         std::cout << "\033[36;1m";
         int opcount = 0;    // # operations since last disp / eol
@@ -11,10 +11,18 @@ using namespace std;
 
 #include "Stack.h"
 #include "Stack.h" // multiple include test
+#include "ArrayStack.h"
+#include "ArrayStack.h" // multiple include test
+
+template <typename T> using DefaultArrayStack = ArrayStack<T>;
+template <typename T> using DefaultCowStack   = CowStack<T>;
 
 template <typename Stack, typename T>
 void _testStackImpl (const char*, const char*, T, T, T, T);
 
+template <template <typename> class Stack>
+void _testStackSnapshots (const char*, bool);
+
 #define TEST_STACK_IMPL(Stack, T, first, second, third) \
     _testStackImpl<Stack<T>,T>(#Stack, #T, {}, first, second, third)
 
@@ -30,6 +38,10 @@ int main () {
         TEST_STACK_IMPL(Stack, std::string, "bar", "baz", "foo");
 
     TEST_STACK_IMPL_WITH(Stack)
+    TEST_STACK_IMPL_WITH(DefaultArrayStack)
+    TEST_STACK_IMPL_WITH(DefaultCowStack)
+    _testStackSnapshots<DefaultArrayStack>("ArrayStack", false);
+    _testStackSnapshots<DefaultCowStack>("CowStack", true);
     std::cout << "\033[32mAll tests passed\n\033[0m";
     return 0;
 }
@@ -200,3 +212,54 @@ void _testStackImpl (const char* stackName, const char* typeName, T init, T firs
         }
     }
 }
+
+// ArrayStack / CowStack specific: iteration order, and copies (snapshots) are independent
+template <template <typename> class Stack>
+void _testStackSnapshots (const char* stackName, bool copyOnWrite) {
+    SECTION("Testing " << stackName << " iteration + snapshots") {
+        Stack<std::string> stack;
+        for (int i = 0; i < 20; ++i) {
+            stack.push(std::to_string(i) + " is a long enough string to heap allocate");
+        }
+        SECTION("Iteration visits elements top to bottom") {
+            int expected = 19, count = 0;
+            for (const auto& value : stack) {
+                ASSERT_EQ(value, std::to_string(expected) + " is a long enough string to heap allocate");
+                --expected; ++count;
+            }
+            ASSERT_EQ(count, 20);
+        }
+        SECTION("Copies share storage iff copy on write") {
+            Stack<std::string> snapshot = stack;
+            ASSERT_EQ(snapshot.shared(), copyOnWrite);
+            ASSERT_EQ(stack.shared(), copyOnWrite);
+            ASSERT_EQ(snapshot.size(), 20);
+            ASSERT_EQ(snapshot.peek(), stack.peek());
+        }
+        ASSERT_EQ(stack.shared(), false);
+        SECTION("Mutating the original doesn't affect a snapshot") {
+            Stack<std::string> snapshot = stack;
+            stack.pop();
+            stack.pop();
+            stack.push("foo");
+            stack.peek() = "bar";
+            stack.swap();
+            ASSERT_EQ(stack.size(), 19);
+            ASSERT_EQ(stack.shared(), false);
+            ASSERT_EQ(snapshot.size(), 20);
+            ASSERT_EQ(snapshot.peek(), "19 is a long enough string to heap allocate");
+            snapshot.pop();
+            ASSERT_EQ(snapshot.peek(), "18 is a long enough string to heap allocate");
+            ASSERT_EQ(stack.peek(), "17 is a long enough string to heap allocate");
+        }
+        SECTION("Mutating a snapshot doesn't affect the original") {
+            Stack<std::string> snapshot = stack;
+            snapshot.clear();
+            snapshot.push(stack.peek());
+            snapshot.push(snapshot.peek());
+            ASSERT_EQ(snapshot.size(), 2);
+            ASSERT_EQ(stack.size(), 19);
+            ASSERT_EQ(stack.peek(), "17 is a long enough string to heap allocate");
+        }
+    }
+}
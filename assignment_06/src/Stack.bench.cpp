@@ -0,0 +1,147 @@
+// Programmer: Seiji Emery
+// Programmer ID: M00202623
+//
+// Stack.bench.cpp
+//
+// Push / pop throughput of Stack<T> w/ its default PoolAllocator (slab + free list node pool)
+// vs std::allocator (one global new / delete per push / pop), and of the contiguous
+// ArrayStack<T> / CowStack<T> (copy on write snapshots). Reports ns / op and the # of
+// global operator new calls (incl. the pool slabs, which are also counted separately), for:
+//
+//  – fill + drain:  push n elements, then pop them all
+//  – steady state:  keep the stack at a fixed depth and alternate push / pop
+//  – copy:          copy an n element stack (what MyRPNCalculator used to do to display the stack)
+//  – display:       MyRPNCalculator's display-every-line loop: push one value, then visit the
+//                   whole stack top to bottom, either by copying + popping a copy, or (Array /
+//                   CowStack) by iterating it in place
+//
+// Remote source:
+// https://github.com/SeijiEmery/comp220/tree/master/assignment_06/src/Stack.bench.cpp
+//
+
+#include <iostream>
+#include <string>
+#include <ContainerBench.h>    // (allocation counter, measure(), writeResult())
+#include "Stack.h"
+#include "ArrayStack.h"
+
+template <typename T> using PooledStack = Stack<T>;
+template <typename T> using GlobalNewStack = Stack<T, std::allocator<T>>;
+
+template <typename Stack, typename T>
+BenchResult benchFillDrain (size_t n, size_t reps, const T& value) {
+    return measure(2 * n * reps, [&]() {
+        Stack stack;
+        for (size_t r = 0; r < reps; ++r) {
+            for (size_t i = 0; i < n; ++i) stack.push(value);
+            for (size_t i = 0; i < n; ++i) stack.pop();
+        }
+    });
+}
+
+template <typename Stack, typename T>
+BenchResult benchSteadyState (size_t depth, size_t ops, const T& value) {
+    Stack stack;
+    for (size_t i = 0; i < depth; ++i) stack.push(value);
+    return measure(2 * ops, [&]() {
+        for (size_t i = 0; i < ops; ++i) {
+            stack.push(value);
+            stack.pop();
+        }
+    });
+}
+
+template <typename Stack, typename T>
+BenchResult benchCopy (size_t n, size_t reps, const T& value) {
+    Stack stack;
+    for (size_t i = 0; i < n; ++i) stack.push(value);
+    size_t total = 0;
+    auto result = measure(n * reps, [&]() {
+        for (size_t r = 0; r < reps; ++r) {
+            Stack copy (stack);
+            total += copy.size();
+        }
+    });
+    if (total != n * reps) {
+        std::cerr << "FAILED: stack copy has the wrong size" << std::endl;
+        exit(-1);
+    }
+    return result;
+}
+
+// Display by copy + pop (the original writeStack): ops = elements visited
+template <typename Stack>
+struct DisplayByCopy {
+    template <typename F>
+    void operator() (const Stack& stack, const F& visit) const {
+        for (Stack copy = stack; !copy.empty(); copy.pop()) visit(copy.peek());
+    }
+};
+// Display by iterating top to bottom in place
+template <typename Stack>
+struct DisplayByIteration {
+    template <typename F>
+    void operator() (const Stack& stack, const F& visit) const {
+        for (const auto& value : stack) visit(value);
+    }
+};
+
+template <typename Stack, typename Display, typename T>
+BenchResult benchDisplay (size_t lines, const T& value) {
+    Stack stack;
+    size_t visited = 0;
+    Display display;
+    auto result = measure(lines * (lines + 1) / 2, [&]() {
+        for (size_t i = 0; i < lines; ++i) {
+            stack.push(value);
+            display(stack, [&](const T& v) { visited += (v == value); });
+        }
+    });
+    if (visited != lines * (lines + 1) / 2) {
+        std::cerr << "FAILED: display visited the wrong elements" << std::endl;
+        exit(-1);
+    }
+    return result;
+}
+
+template <typename T>
+void benchStack (const char* typeName, const T& value) {
+    const size_t n = 100000;
+    size_t slabs0 = detail::poolSlabsAllocated();
+    std::cout << "Stack<" << typeName << ">:\n";
+
+    std::cout << "  fill + drain (n = " << n << ", 10x):\n";
+    writeResult("std::allocator (global new)", benchFillDrain<GlobalNewStack<T>>(n, 10, value));
+    writeResult("PoolAllocator", benchFillDrain<PooledStack<T>>(n, 10, value));
+    writeResult("ArrayStack", benchFillDrain<ArrayStack<T>>(n, 10, value));
+
+    std::cout << "  steady state (depth = 64, 1e6 push + pop):\n";
+    writeResult("std::allocator (global new)", benchSteadyState<GlobalNewStack<T>>(64, 1000000, value));
+    writeResult("PoolAllocator", benchSteadyState<PooledStack<T>>(64, 1000000, value));
+    writeResult("ArrayStack", benchSteadyState<ArrayStack<T>>(64, 1000000, value));
+
+    std::cout << "  copy (n = 1000, 1000x):\n";
+    writeResult("std::allocator (global new)", benchCopy<GlobalNewStack<T>>(1000, 1000, value));
+    writeResult("PoolAllocator", benchCopy<PooledStack<T>>(1000, 1000, value));
+    writeResult("ArrayStack", benchCopy<ArrayStack<T>>(1000, 1000, value));
+    writeResult("CowStack", benchCopy<CowStack<T>>(1000, 1000, value));
+
+    std::cout << "  display every line (2000 lines, ns / element displayed):\n";
+    writeResult("copy + pop, global new", benchDisplay<GlobalNewStack<T>, DisplayByCopy<GlobalNewStack<T>>>(2000, value));
+    writeResult("copy + pop, PoolAllocator", benchDisplay<PooledStack<T>, DisplayByCopy<PooledStack<T>>>(2000, value));
+    writeResult("copy + pop, CowStack", benchDisplay<CowStack<T>, DisplayByCopy<CowStack<T>>>(2000, value));
+    writeResult("iterate, ArrayStack", benchDisplay<ArrayStack<T>, DisplayByIteration<ArrayStack<T>>>(2000, value));
+
+    std::cout << "  pool slabs allocated: " << (detail::poolSlabsAllocated() - slabs0) << "\n\n";
+}
+
+int main () {
+    std::cout << "Programmer: Seiji Emery\n"
+              << "Programmer's id: M00202623\n"
+              << "File: " __FILE__ "\n\n";
+
+    benchStack<double>("double", 1.5);
+    // (short enough for the small string optimization: only the nodes are allocated)
+    benchStack<std::string>("std::string", std::string("rpn"));
+    return 0;
+}
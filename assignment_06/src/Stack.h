@@ -10,9 +10,15 @@
 #ifndef Stack_h
 #define Stack_h
 #include <cassert>
+#include <memory>   // std::allocator, std::allocator_traits
+#include <utility>  // std::forward, std::move
+#include "PoolAllocator.h"
 
 // Simple reference stack implementation based on a linked list.
-template <typename T>
+// Nodes are allocated w/ an (std-compatible) Allocator template parameter;
+// the default PoolAllocator (assignment_03/src/PoolAllocator.h) hands them out from slabs of 64+
+// nodes w/ a per thread free list, instead of doing one heap allocation per push.
+template <typename T, typename Allocator = PoolAllocator<T>>
 class Stack {
     struct Node {
         T     value;
@@ -27,37 +33,57 @@ class Stack {
             value(value), 
             prev(prev) 
         {}
-        Node (const Node& node) : 
-            value(node.value), 
-            prev(node.prev ? new Node(*(node.prev)) : nullptr) 
-        {}
         ~Node () {}
     };
-    Node* head = nullptr;
-    size_t length = 0;
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Node>  NodeAllocator;
+    typedef std::allocator_traits<NodeAllocator>                                    NodeTraits;
+
+    Node*         head = nullptr;
+    size_t        length = 0;
+    NodeAllocator alloc;
+
+    template <typename V>
+    Node* createNode (V&& value, Node* prev) {
+        Node* node = NodeTraits::allocate(alloc, 1);
+        new (node) Node(std::forward<V>(value), prev);
+        return node;
+    }
+    void destroyNode (Node* node) {
+        node->~Node();
+        NodeTraits::deallocate(alloc, node, 1);
+    }
+    // Copies other's nodes (top to bottom), preserving order
+    void copyNodes (const Stack& other) {
+        Node** tail = &head;
+        for (Node* node = other.head; node; node = node->prev) {
+            *tail = createNode(node->value, nullptr);
+            tail = &(*tail)->prev;
+        }
+        length = other.length;
+    }
 public:
-    Stack () {}
-    Stack (const T& value) { push(value); }
-    Stack (const Stack<T>& other) : 
-        head(other.head ? new Node(*(other.head)) : nullptr), 
-        length(other.length) 
-    {}
+    typedef T value_type;
+
+    Stack (const Allocator& alloc = Allocator()) : alloc(alloc) {}
+    Stack (const T& value, const Allocator& alloc = Allocator()) : alloc(alloc) { push(value); }
+    Stack (const Stack& other) : 
+        alloc(NodeTraits::select_on_container_copy_construction(other.alloc))
+    { copyNodes(other); }
     ~Stack () { clear(); }
 
-    Stack<T>& operator= (const Stack<T>& other) {
-        clear();
-        if (other.head) {
-            head = new Node(*(other.head));
+    Stack& operator= (const Stack& other) {
+        if (this != &other) {
+            clear();
+            copyNodes(other);
         }
-        length = other.head;
         return *this;
     }
     void push (T&& value) {
-        head = new Node(value, head);
+        head = createNode(std::move(value), head);
         ++length;
     }
     void push (const T& value) {
-        head = new Node(value, head);
+        head = createNode(value, head);
         ++length;
     }
     T& peek () { 
@@ -71,7 +97,7 @@ public:
     void pop () {
         if (head) {
             Node* prev = head->prev;
-            delete head;
+            destroyNode(head);
             head = prev;
             --length;
         }
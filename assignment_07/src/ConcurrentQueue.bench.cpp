@@ -0,0 +1,180 @@
+// Programmer: Seiji Emery
+// Programmer ID: M00202623
+//
+// ConcurrentQueue.bench.cpp
+//
+// Benchmarks SpscQueue / MpmcQueue (ConcurrentQueue.h) against a mutex-protected RingQueue:
+//
+//  – throughput: P producer + C consumer threads pass N integers through one queue (w/ single
+//    and batched push / pop); reports millions of items / sec, and checks that every item
+//    arrived exactly once (sum of values)
+//  – latency:    two threads ping-pong one item through a pair of queues; reports the median +
+//    90th percentile round trip time
+//
+// Note that the numbers depend heavily on the # of cores: w/ fewer cores than threads, the
+// blocking push / pop (which yield while spinning) are dominated by context switches.
+//
+// Remote source:
+// https://github.com/SeijiEmery/comp220/tree/master/assignment_07/src/ConcurrentQueue.bench.cpp
+//
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include "ConcurrentQueue.h"
+#include "RingQueue.h"
+
+// Bounded RingQueue behind a std::mutex, w/ the same try_* interface (baseline)
+template <typename T>
+class LockedQueue {
+    std::mutex   mutex;
+    RingQueue<T> queue;
+    size_t       maxSize;
+public:
+    LockedQueue (size_t capacity = 1024) : maxSize(capacity) { queue.reserve(capacity); }
+
+    bool try_push (const T& value) { return try_push_n(&value, 1) == 1; }
+    bool try_pop (T& value) { return try_pop_n(&value, 1) == 1; }
+
+    template <typename It>
+    size_t try_push_n (It first, size_t n) {
+        std::lock_guard<std::mutex> lock (mutex);
+        size_t k = std::min(n, maxSize - queue.size());
+        for (size_t i = 0; i < k; ++i, ++first) queue.push(*first);
+        return k;
+    }
+    template <typename It>
+    size_t try_pop_n (It out, size_t n) {
+        std::lock_guard<std::mutex> lock (mutex);
+        size_t k = std::min(n, queue.size());
+        for (size_t i = 0; i < k; ++i, ++out) { *out = queue.front(); queue.pop(); }
+        return k;
+    }
+    void push (const T& value) { concurrent::spinUntil([&]() { return try_push(value); }); }
+    void pop (T& value) { concurrent::spinUntil([&]() { return try_pop(value); }); }
+};
+
+typedef std::chrono::high_resolution_clock Clock;
+
+template <typename Queue>
+double benchThroughput (size_t producers, size_t consumers, size_t items, size_t batch) {
+    Queue queue (1024);
+    std::atomic<size_t> consumed { 0 };
+    std::atomic<uint64_t> total { 0 };
+    std::vector<std::thread> threads;
+
+    auto t0 = Clock::now();
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            // producer p pushes values p, p + producers, p + 2 * producers, ... < items
+            std::vector<uint64_t> buffer (batch);
+            for (uint64_t next = p; next < items; ) {
+                size_t n = 0;
+                for (uint64_t v = next; n < batch && v < items; v += producers) buffer[n++] = v;
+                size_t pushed = 0;
+                while (pushed < n) {
+                    size_t k = batch == 1 ?
+                        (queue.try_push(buffer[0]) ? 1 : 0) :
+                        queue.try_push_n(&buffer[pushed], n - pushed);
+                    if (!k) std::this_thread::yield();
+                    pushed += k;
+                }
+                next += n * producers;
+            }
+        });
+    }
+    for (size_t c = 0; c < consumers; ++c) {
+        threads.emplace_back([&]() {
+            std::vector<uint64_t> buffer (batch);
+            uint64_t sum = 0;
+            while (consumed.load(std::memory_order_relaxed) < items) {
+                size_t k = batch == 1 ?
+                    (queue.try_pop(buffer[0]) ? 1 : 0) :
+                    queue.try_pop_n(&buffer[0], batch);
+                if (!k) { std::this_thread::yield(); continue; }
+                for (size_t i = 0; i < k; ++i) sum += buffer[i];
+                consumed += k;
+            }
+            total += sum;
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    auto t1 = Clock::now();
+
+    uint64_t expected = (uint64_t)items * (items - 1) / 2;
+    if (consumed != items || total != expected) {
+        std::cerr << "FAILED: consumed " << consumed << " / " << items << " items, sum "
+            << total << " (expected " << expected << ")" << std::endl;
+        exit(-1);
+    }
+    return items / std::chrono::duration<double>(t1 - t0).count() * 1e-6;
+}
+
+// Round trip latency: main thread -> (ping) -> echo thread -> (pong) -> main thread
+template <typename Queue>
+void benchLatency (const char* name, size_t roundTrips) {
+    Queue ping (64), pong (64);
+    std::thread echo ([&]() {
+        uint64_t value;
+        for (size_t i = 0; i < roundTrips; ++i) {
+            ping.pop(value);
+            pong.push(value + 1);
+        }
+    });
+    std::vector<double> samples (roundTrips);
+    for (size_t i = 0; i < roundTrips; ++i) {
+        uint64_t value = i;
+        auto t0 = Clock::now();
+        ping.push(value);
+        pong.pop(value);
+        auto t1 = Clock::now();
+        if (value != i + 1) {
+            std::cerr << "FAILED: ping-pong returned " << value << " (expected " << (i + 1) << ")" << std::endl;
+            exit(-1);
+        }
+        samples[i] = std::chrono::duration<double>(t1 - t0).count() * 1e9;
+    }
+    echo.join();
+    std::sort(samples.begin(), samples.end());
+    std::cout << "  " << std::setw(28) << std::left << name << std::right
+        << "  median " << std::setw(10) << samples[samples.size() / 2] << " ns"
+        << "  p90 " << std::setw(10) << samples[samples.size() * 9 / 10] << " ns\n";
+}
+
+template <typename Queue>
+void writeThroughput (const char* name, size_t producers, size_t consumers, size_t items) {
+    std::cout << "  " << std::setw(12) << std::left << name << std::right
+        << std::setw(3) << producers << " x " << std::setw(2) << consumers << ":"
+        << "  single " << std::setw(8) << std::setprecision(4) << benchThroughput<Queue>(producers, consumers, items, 1) << " M items / s"
+        << "  batch(32) " << std::setw(8) << benchThroughput<Queue>(producers, consumers, items, 32) << " M items / s\n";
+}
+
+int main () {
+    std::cout << "Programmer: Seiji Emery\n"
+              << "Programmer's id: M00202623\n"
+              << "File: " __FILE__ "\n\n";
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << "\n\n";
+
+    const size_t items = 1 << 20;
+    std::cout << "Throughput (" << items << " items, capacity 1024, producers x consumers):\n";
+    writeThroughput<SpscQueue<uint64_t>>  ("SpscQueue",   1, 1, items);
+    writeThroughput<MpmcQueue<uint64_t>>  ("MpmcQueue",   1, 1, items);
+    writeThroughput<LockedQueue<uint64_t>>("LockedQueue", 1, 1, items);
+    for (size_t threads : { 2, 4 }) {
+        writeThroughput<MpmcQueue<uint64_t>>  ("MpmcQueue",   threads, threads, items);
+        writeThroughput<LockedQueue<uint64_t>>("LockedQueue", threads, threads, items);
+    }
+    writeThroughput<MpmcQueue<uint64_t>>  ("MpmcQueue",   1, 4, items);
+    writeThroughput<MpmcQueue<uint64_t>>  ("MpmcQueue",   4, 1, items);
+
+    std::cout << "\nRound trip latency (ping-pong, 20000 round trips):\n";
+    benchLatency<SpscQueue<uint64_t>>  ("SpscQueue",   20000);
+    benchLatency<MpmcQueue<uint64_t>>  ("MpmcQueue",   20000);
+    benchLatency<LockedQueue<uint64_t>>("LockedQueue", 20000);
+    return 0;
+}
@@ -0,0 +1,289 @@
+// Programmer: Seiji Emery
+// Programmer ID: M00202623
+//
+// ConcurrentQueue.h
+// Bounded lock-free queues for passing work between threads (eg. reader -> parser -> counter
+// pipeline stages):
+//
+//  – SpscQueue<T>: single producer / single consumer ring buffer. head + tail live on their own
+//    cache lines, and each side caches the other side's index, so the fast path touches no
+//    shared cache lines unless the queue looks full / empty.
+//  – MpmcQueue<T>: multi producer / multi consumer bounded queue (Dmitry Vyukov's design:
+//    per-cell sequence numbers + CAS on the enqueue / dequeue positions).
+//
+// Both have a power-of-two capacity fixed at construction, non-blocking try_push / try_pop,
+// batched try_push_n / try_pop_n (one index update per batch), and blocking push / pop that
+// spin (yielding) until they succeed.
+//
+// Remote source:
+// https://github.com/SeijiEmery/comp220/tree/master/assignment_07/src/ConcurrentQueue.h
+//
+
+#ifndef ConcurrentQueue_h
+#define ConcurrentQueue_h
+#include <cassert>
+#include <cstddef>      // size_t
+#include <cstdint>      // intptr_t
+#include <atomic>
+#include <thread>       // std::this_thread::yield
+#include <new>          // placement new
+#include <type_traits>  // std::aligned_storage
+#include <utility>      // std::forward, std::move
+
+namespace concurrent {
+
+static const size_t cacheLineSize = 64;
+
+inline size_t roundUpPow2 (size_t n) {
+    size_t cap = 2;
+    while (cap < n) cap *= 2;
+    return cap;
+}
+
+// Spins (w/ yield, so this doesn't starve the other side on machines w/ few cores) until f()
+template <typename F>
+void spinUntil (const F& f) {
+    while (!f()) {
+        std::this_thread::yield();
+    }
+}
+
+} // namespace concurrent
+
+template <typename T>
+class SpscQueue {
+    typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Slot;
+
+    // Producer side
+    alignas(concurrent::cacheLineSize) std::atomic<size_t> tail { 0 };
+    size_t cachedHead = 0;
+    // Consumer side
+    alignas(concurrent::cacheLineSize) std::atomic<size_t> head { 0 };
+    size_t cachedTail = 0;
+    // Shared, read only
+    alignas(concurrent::cacheLineSize) Slot* slots;
+    size_t mask;
+
+    T* slot (size_t i) const { return reinterpret_cast<T*>(&slots[i & mask]); }
+
+    // # of free slots (producer side); only reloads head if we look full
+    size_t freeSlots (size_t t, size_t wanted) {
+        size_t free = mask + 1 - (t - cachedHead);
+        if (free < wanted) {
+            cachedHead = head.load(std::memory_order_acquire);
+            free = mask + 1 - (t - cachedHead);
+        }
+        return free;
+    }
+    // # of readable slots (consumer side); only reloads tail if we look empty
+    size_t usedSlots (size_t h, size_t wanted) {
+        size_t used = cachedTail - h;
+        if (used < wanted) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            used = cachedTail - h;
+        }
+        return used;
+    }
+public:
+    SpscQueue (size_t capacity = 1024)
+        : slots(new Slot[concurrent::roundUpPow2(capacity)]),
+          mask(concurrent::roundUpPow2(capacity) - 1) {}
+    SpscQueue (const SpscQueue&) = delete;
+    SpscQueue& operator= (const SpscQueue&) = delete;
+    ~SpscQueue () {
+        for (size_t h = head.load(), t = tail.load(); h != t; ++h) {
+            slot(h)->~T();
+        }
+        delete[] slots;
+    }
+
+    size_t capacity () const { return mask + 1; }
+
+    // Approximate (exact iff neither side is concurrently modifying the queue)
+    size_t size () const { return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire); }
+    bool empty () const { return size() == 0; }
+
+    // Producer only
+    template <typename V>
+    bool try_push (V&& value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (!freeSlots(t, 1)) return false;
+        new (slot(t)) T(std::forward<V>(value));
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+    // Pushes (copies of) up to n values from first; returns the # pushed
+    template <typename It>
+    size_t try_push_n (It first, size_t n) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t free = freeSlots(t, n);
+        if (n > free) n = free;
+        for (size_t i = 0; i < n; ++i, ++first) {
+            new (slot(t + i)) T(*first);
+        }
+        tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+    template <typename V>
+    void push (V&& value) {
+        concurrent::spinUntil([&]() { return try_push(std::forward<V>(value)); });
+    }
+
+    // Consumer only
+    bool try_pop (T& value) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (!usedSlots(h, 1)) return false;
+        value = std::move(*slot(h));
+        slot(h)->~T();
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+    // Pops up to n values into out; returns the # popped
+    template <typename It>
+    size_t try_pop_n (It out, size_t n) {
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t used = usedSlots(h, n);
+        if (n > used) n = used;
+        for (size_t i = 0; i < n; ++i, ++out) {
+            *out = std::move(*slot(h + i));
+            slot(h + i)->~T();
+        }
+        head.store(h + n, std::memory_order_release);
+        return n;
+    }
+    void pop (T& value) {
+        concurrent::spinUntil([&]() { return try_pop(value); });
+    }
+};
+
+template <typename T>
+class MpmcQueue {
+    struct Cell {
+        std::atomic<size_t> sequence;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+        T* value () { return reinterpret_cast<T*>(&storage); }
+    };
+
+    alignas(concurrent::cacheLineSize) Cell* cells;
+    size_t mask;
+    alignas(concurrent::cacheLineSize) std::atomic<size_t> enqueuePos { 0 };
+    alignas(concurrent::cacheLineSize) std::atomic<size_t> dequeuePos { 0 };
+
+    Cell& cell (size_t pos) const { return cells[pos & mask]; }
+
+    // Claims up to n consecutive positions (shared by push + pop): the cell at position p is
+    // ready once its sequence == p + offset (offset is 0 for producers, 1 for consumers).
+    // Only claims a run whose last cell is already ready: all earlier cells have then been
+    // claimed by the other side, so any that aren't ready yet are mid-operation, and the
+    // caller just has to wait briefly for them (see waitReady).
+    static size_t claim (std::atomic<size_t>& position, MpmcQueue& queue, size_t offset, size_t n, size_t& start) {
+        size_t pos = position.load(std::memory_order_relaxed);
+        auto readiness = [&](size_t k) -> intptr_t {
+            size_t last = pos + k - 1;
+            return (intptr_t)queue.cell(last).sequence.load(std::memory_order_acquire) - (intptr_t)(last + offset);
+        };
+        while (true) {
+            intptr_t dif = readiness(1);
+            if (dif < 0) return 0;      // full (producers) / empty (consumers)
+            if (dif > 0) {              // someone else claimed pos; reload + retry
+                pos = position.load(std::memory_order_relaxed);
+                continue;
+            }
+            // Binary search for the longest run (<= n) w/ a ready last cell
+            size_t lo = 1, hi = n;
+            while (lo < hi) {
+                size_t mid = (lo + hi + 1) / 2;
+                if (readiness(mid) == 0) lo = mid;
+                else                     hi = mid - 1;
+            }
+            if (position.compare_exchange_weak(pos, pos + lo, std::memory_order_relaxed)) {
+                start = pos;
+                return lo;
+            }
+        }
+    }
+    void waitReady (size_t pos, size_t offset) {
+        Cell& c = cell(pos);
+        concurrent::spinUntil([&]() { return c.sequence.load(std::memory_order_acquire) == pos + offset; });
+    }
+public:
+    MpmcQueue (size_t capacity = 1024)
+        : cells(new Cell[concurrent::roundUpPow2(capacity)]),
+          mask(concurrent::roundUpPow2(capacity) - 1)
+    {
+        for (size_t i = 0; i <= mask; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    MpmcQueue (const MpmcQueue&) = delete;
+    MpmcQueue& operator= (const MpmcQueue&) = delete;
+    ~MpmcQueue () {
+        for (size_t pos = dequeuePos.load(), end = enqueuePos.load(); pos != end; ++pos) {
+            cell(pos).value()->~T();
+        }
+        delete[] cells;
+    }
+
+    size_t capacity () const { return mask + 1; }
+
+    // Approximate (exact iff no other thread is modifying the queue)
+    size_t size () const {
+        size_t e = enqueuePos.load(std::memory_order_acquire), d = dequeuePos.load(std::memory_order_acquire);
+        return e > d ? e - d : 0;
+    }
+    bool empty () const { return size() == 0; }
+
+    template <typename V>
+    bool try_push (V&& value) {
+        size_t pos;
+        if (!claim(enqueuePos, *this, 0, 1, pos)) return false;
+        new (cell(pos).value()) T(std::forward<V>(value));
+        cell(pos).sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+    // Pushes (copies of) up to n values from first w/ a single CAS; returns the # pushed
+    template <typename It>
+    size_t try_push_n (It first, size_t n) {
+        size_t pos;
+        size_t k = n ? claim(enqueuePos, *this, 0, n, pos) : 0;
+        for (size_t i = 0; i < k; ++i, ++first) {
+            waitReady(pos + i, 0);
+            new (cell(pos + i).value()) T(*first);
+            cell(pos + i).sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        return k;
+    }
+    template <typename V>
+    void push (V&& value) {
+        concurrent::spinUntil([&]() { return try_push(std::forward<V>(value)); });
+    }
+
+    bool try_pop (T& value) {
+        size_t pos;
+        if (!claim(dequeuePos, *this, 1, 1, pos)) return false;
+        Cell& c = cell(pos);
+        value = std::move(*c.value());
+        c.value()->~T();
+        c.sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+    // Pops up to n values into out w/ a single CAS; returns the # popped
+    template <typename It>
+    size_t try_pop_n (It out, size_t n) {
+        size_t pos;
+        size_t k = n ? claim(dequeuePos, *this, 1, n, pos) : 0;
+        for (size_t i = 0; i < k; ++i, ++out) {
+            waitReady(pos + i, 1);
+            Cell& c = cell(pos + i);
+            *out = std::move(*c.value());
+            c.value()->~T();
+            c.sequence.store(pos + i + mask + 1, std::memory_order_release);
+        }
+        return k;
+    }
+    void pop (T& value) {
+        concurrent::spinUntil([&]() { return try_pop(value); });
+    }
+};
+
+#endif // ConcurrentQueue_h
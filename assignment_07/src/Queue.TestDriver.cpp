@@ -14,10 +14,22 @@ using namespace std;
 
 #include "Queue.h"
 #include "Queue.h" // multiple include test
+#include "RingQueue.h"
+#include "RingQueue.h" // multiple include test
+#include "ConcurrentQueue.h"
+#include "ConcurrentQueue.h" // multiple include test
+#include "TaskScheduler.h"
+#include "TaskScheduler.h" // multiple include test
+#include <chrono>
+#include <ctime>        // clock
 
 template <typename Queue, typename T>
 void _testQueueImpl (const char*, const char*, T, T, T, T);
 
+void _testRingQueueWrapAround ();
+template <typename Queue> void _testConcurrentQueue (const char*);
+void _testTaskScheduler ();
+
 #define TEST_QUEUE_IMPL(Queue, T, first, second, third) \
     _testQueueImpl<Queue<T>,T>(#Queue, #T, {}, first, second, third)
 
@@ -33,6 +45,11 @@ int main () {
         TEST_QUEUE_IMPL(Queue, std::string, "bar", "baz", "foo");
 
     TEST_QUEUE_IMPL_WITH(Queue)
+    TEST_QUEUE_IMPL_WITH(RingQueue)
+    _testRingQueueWrapAround();
+    _testConcurrentQueue<SpscQueue<std::string>>("SpscQueue");
+    _testConcurrentQueue<MpmcQueue<std::string>>("MpmcQueue");
+    _testTaskScheduler();
     std::cout << "\033[32mAll tests passed\n\033[0m";
     return 0;
 }
@@ -219,3 +236,188 @@ void _testQueueImpl (const char* queueName, const char* typeName, T init, T firs
         }
     }
 }
+
+// RingQueue specific: elements stay in order when the ring wraps around + grows
+void _testRingQueueWrapAround () {
+    SECTION("Testing RingQueue wrap around + growth") {
+        RingQueue<int> queue;
+        for (int i = 0; i < 6; ++i) queue.push(i);
+        for (int i = 0; i < 4; ++i) queue.pop();
+        for (int i = 6; i < 10; ++i) queue.push(i);     // wraps around (capacity 8)
+
+        SECTION("Wrapped queue has the right contents") {
+            ASSERT_EQ(queue.capacity(), 8);
+            ASSERT_EQ(queue.size(), 6);
+            ASSERT_EQ(queue.front(), 4);
+            ASSERT_EQ(queue.back(), 9);
+        }
+        SECTION("Iteration visits elements front to back") {
+            int expected = 4;
+            for (int value : queue) {
+                ASSERT_EQ(value, expected);
+                ++expected;
+            }
+            ASSERT_EQ(expected, 10);
+        }
+        SECTION("Growing a wrapped queue preserves order") {
+            for (int i = 10; i < 20; ++i) queue.push(i);
+            ASSERT_EQ(queue.capacity(), 16);
+            ASSERT_EQ(queue.size(), 16);
+            int expected = 4;
+            for (int value : queue) {
+                ASSERT_EQ(value, expected);
+                ++expected;
+            }
+            ASSERT_EQ(queue.front(), 4);
+            ASSERT_EQ(queue.back(), 19);
+        }
+        SECTION("Pushing an element of the queue while it grows") {
+            RingQueue<std::string> strings;
+            for (int i = 0; i < 8; ++i) strings.push(std::to_string(i) + " is a long enough string to heap allocate");
+            strings.push(strings.front());
+            ASSERT_EQ(strings.size(), 9);
+            ASSERT_EQ(strings.back(), strings.front());
+        }
+    }
+}
+
+// SpscQueue / MpmcQueue (single threaded: capacity limits, ordering, batches, wrap around;
+// the multithreaded cases are checked by concurrent_queue_bench). Note: ASSERT_EQ evaluates its
+// arguments more than once, so results of try_push / try_pop are stored first.
+template <typename Queue>
+void _testConcurrentQueue (const char* queueName) {
+    SECTION("Testing " << queueName << "<std::string>") {
+        Queue queue (5);
+        std::string value;
+
+        SECTION("Capacity is rounded up to a power of 2") {
+            ASSERT_EQ(queue.capacity(), 8);
+            ASSERT_EQ(queue.empty(), true);
+            bool popped = queue.try_pop(value);
+            ASSERT_EQ(popped, false);
+        }
+        SECTION("Push until full") {
+            for (int i = 0; i < 8; ++i) {
+                bool pushed = queue.try_push(std::to_string(i));
+                ASSERT_EQ(pushed, true);
+            }
+            bool pushed = queue.try_push("full");
+            ASSERT_EQ(pushed, false);
+            ASSERT_EQ(queue.size(), 8);
+        }
+        SECTION("Pop in FIFO order") {
+            for (int i = 0; i < 3; ++i) {
+                bool popped = queue.try_pop(value);
+                ASSERT_EQ(popped, true);
+                ASSERT_EQ(value, std::to_string(i));
+            }
+            ASSERT_EQ(queue.size(), 5);
+        }
+        SECTION("Batch push wraps around + stops when full") {
+            std::string values[] = { "a", "b", "c", "d", "e" };
+            size_t pushed = queue.try_push_n(&values[0], 5);
+            ASSERT_EQ(pushed, 3);
+            ASSERT_EQ(queue.size(), 8);
+            pushed = queue.try_push_n(&values[3], 2);
+            ASSERT_EQ(pushed, 0);
+        }
+        SECTION("Batch pop returns elements in order + stops when empty") {
+            std::string out[10];
+            size_t popped = queue.try_pop_n(&out[0], 10);
+            ASSERT_EQ(popped, 8);
+            ASSERT_EQ(out[0], "3");
+            ASSERT_EQ(out[4], "7");
+            ASSERT_EQ(out[5], "a");
+            ASSERT_EQ(out[7], "c");
+            ASSERT_EQ(queue.empty(), true);
+            popped = queue.try_pop_n(&out[0], 10);
+            ASSERT_EQ(popped, 0);
+        }
+        SECTION("Blocking push / pop") {
+            queue.push("foo");
+            queue.pop(value);
+            ASSERT_EQ(value, "foo");
+        }
+    }
+}
+
+static long _fib (TaskScheduler& scheduler, int n) {
+    if (n < 2) return n;
+    long a, b;
+    TaskGroup group (scheduler);
+    group.spawn([&]() { a = _fib(scheduler, n - 1); });
+    b = _fib(scheduler, n - 2);
+    group.sync();
+    return a + b;
+}
+
+struct _NoopTask : tasks::Task {
+    void run () override {}
+};
+
+void _testTaskScheduler () {
+    SECTION("Testing TaskScheduler") {
+        TaskScheduler scheduler (2);
+        ASSERT_EQ(scheduler.threadCount(), 2);
+
+        SECTION("Chase-Lev deque: owner pops LIFO, thieves steal FIFO, grows when full") {
+            tasks::ChaseLevDeque deque (4);
+            std::vector<_NoopTask*> items;
+            for (int i = 0; i < 10; ++i) {
+                items.push_back(new _NoopTask());
+                deque.push(items.back());
+            }
+            tasks::Task* task = deque.pop();
+            ASSERT_EQ(task, items[9]);
+            task = deque.steal();
+            ASSERT_EQ(task, items[0]);
+            task = deque.steal();
+            ASSERT_EQ(task, items[1]);
+            size_t remaining = 0;
+            while (deque.pop()) ++remaining;
+            ASSERT_EQ(remaining, 7);
+            ASSERT_EQ(deque.empty(), true);
+            task = deque.steal();
+            ASSERT_EQ(task, (tasks::Task*)nullptr);
+            for (auto item : items) delete item;
+        }
+        SECTION("spawn / sync (recursive fib)") {
+            long result = _fib(scheduler, 20);
+            ASSERT_EQ(result, 6765);
+        }
+        SECTION("parallel_for visits every index exactly once") {
+            std::vector<std::atomic<int>> visits (10000);
+            for (auto& v : visits) v.store(0);
+            parallel_for(0, visits.size(), 64, [&](size_t i0, size_t i1) {
+                for (size_t i = i0; i < i1; ++i) ++visits[i];
+            }, scheduler);
+            size_t once = 0;
+            for (auto& v : visits) once += v.load() == 1;
+            ASSERT_EQ(once, visits.size());
+        }
+        SECTION("parallel_reduce folds chunks in order (deterministic)") {
+            std::string letters = parallel_reduce(0, 26, 3, std::string(), [](size_t i0, size_t i1) {
+                std::string s;
+                for (size_t i = i0; i < i1; ++i) s += char('a' + i);
+                return s;
+            }, [](std::string a, const std::string& b) { return a + b; }, scheduler);
+            ASSERT_EQ(letters, "abcdefghijklmnopqrstuvwxyz");
+            long sum = parallel_reduce(0, 100001, 1000, 0L, [](size_t i0, size_t i1) {
+                long s = 0;
+                for (size_t i = i0; i < i1; ++i) s += i;
+                return s;
+            }, [](long a, long b) { return a + b; }, scheduler);
+            ASSERT_EQ(sum, 5000050000L);
+        }
+        SECTION("Idle workers sleep (don't burn CPU)") {
+            // give workers time to go idle, then measure process CPU time over a 300ms wall clock window
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            std::clock_t c0 = std::clock();
+            std::this_thread::sleep_for(std::chrono::milliseconds(300));
+            double cpuMs = double(std::clock() - c0) * 1000 / CLOCKS_PER_SEC;
+            bool idle = cpuMs < 30;
+            ASSERT_EQ(idle, true);
+            mintest::writeln() << "    (" << cpuMs << " ms CPU time while idle)";
+        }
+    }
+}
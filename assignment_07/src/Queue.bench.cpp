@@ -0,0 +1,132 @@
+// Programmer: Seiji Emery
+// Programmer ID: M00202623
+//
+// Queue.bench.cpp
+//
+// Push / pop throughput of Queue<T> w/ its default PoolAllocator (slab + free list node pool)
+// vs std::allocator (one global new / delete per push / pop), and of the contiguous RingQueue<T>
+// and std::queue<T> (std::deque based). Reports ns / op and the # of
+// global operator new calls (incl. the pool slabs, which are also counted separately), for:
+//
+//  – fill + drain:  push n elements, then pop them all
+//  – steady state:  keep the queue at a fixed length and alternate push / pop (what
+//                   Simulation.cpp does w/ its customer queues)
+//  – copy:          copy an n element queue
+//  – iterate:       walk an n element queue front to back (not supported by std::queue)
+//
+// Remote source:
+// https://github.com/SeijiEmery/comp220/tree/master/assignment_07/src/Queue.bench.cpp
+//
+
+#include <iostream>
+#include <string>
+#include <queue>
+#include <ContainerBench.h>    // (allocation counter, measure(), writeResult())
+#include "Queue.h"
+#include "RingQueue.h"
+
+template <typename T> using PooledQueue = Queue<T>;
+template <typename T> using GlobalNewQueue = Queue<T, std::allocator<T>>;
+
+template <typename Queue, typename T>
+BenchResult benchFillDrain (size_t n, size_t reps, const T& value) {
+    return measure(2 * n * reps, [&]() {
+        Queue queue;
+        for (size_t r = 0; r < reps; ++r) {
+            for (size_t i = 0; i < n; ++i) queue.push(value);
+            for (size_t i = 0; i < n; ++i) queue.pop();
+        }
+    });
+}
+
+template <typename Queue, typename T>
+BenchResult benchSteadyState (size_t length, size_t ops, const T& value) {
+    Queue queue;
+    for (size_t i = 0; i < length; ++i) queue.push(value);
+    return measure(2 * ops, [&]() {
+        for (size_t i = 0; i < ops; ++i) {
+            queue.push(value);
+            queue.pop();
+        }
+    });
+}
+
+template <typename Queue, typename T>
+BenchResult benchCopy (size_t n, size_t reps, const T& value) {
+    Queue queue;
+    for (size_t i = 0; i < n; ++i) queue.push(value);
+    size_t total = 0;
+    auto result = measure(n * reps, [&]() {
+        for (size_t r = 0; r < reps; ++r) {
+            Queue copy (queue);
+            total += copy.size();
+        }
+    });
+    if (total != n * reps) {
+        std::cerr << "FAILED: queue copy has the wrong size" << std::endl;
+        exit(-1);
+    }
+    return result;
+}
+
+template <typename Queue, typename T>
+BenchResult benchIterate (size_t n, size_t reps, const T& value) {
+    Queue queue;
+    for (size_t i = 0; i < n; ++i) queue.push(value);
+    size_t count = 0;
+    auto result = measure(n * reps, [&]() {
+        for (size_t r = 0; r < reps; ++r) {
+            for (const auto& element : queue) {
+                count += (element == value);
+            }
+        }
+    });
+    if (count != n * reps) {
+        std::cerr << "FAILED: queue iteration visited the wrong elements" << std::endl;
+        exit(-1);
+    }
+    return result;
+}
+
+template <typename T>
+void benchQueue (const char* typeName, const T& value) {
+    const size_t n = 100000;
+    size_t slabs0 = detail::poolSlabsAllocated();
+    std::cout << "Queue<" << typeName << ">:\n";
+
+    std::cout << "  fill + drain (n = " << n << ", 10x):\n";
+    writeResult("std::allocator (global new)", benchFillDrain<GlobalNewQueue<T>>(n, 10, value));
+    writeResult("PoolAllocator", benchFillDrain<PooledQueue<T>>(n, 10, value));
+    writeResult("RingQueue", benchFillDrain<RingQueue<T>>(n, 10, value));
+    writeResult("std::queue", benchFillDrain<std::queue<T>>(n, 10, value));
+
+    std::cout << "  steady state (length = 64, 1e6 push + pop):\n";
+    writeResult("std::allocator (global new)", benchSteadyState<GlobalNewQueue<T>>(64, 1000000, value));
+    writeResult("PoolAllocator", benchSteadyState<PooledQueue<T>>(64, 1000000, value));
+    writeResult("RingQueue", benchSteadyState<RingQueue<T>>(64, 1000000, value));
+    writeResult("std::queue", benchSteadyState<std::queue<T>>(64, 1000000, value));
+
+    std::cout << "  copy (n = 1000, 1000x):\n";
+    writeResult("std::allocator (global new)", benchCopy<GlobalNewQueue<T>>(1000, 1000, value));
+    writeResult("PoolAllocator", benchCopy<PooledQueue<T>>(1000, 1000, value));
+    writeResult("RingQueue", benchCopy<RingQueue<T>>(1000, 1000, value));
+    writeResult("std::queue", benchCopy<std::queue<T>>(1000, 1000, value));
+
+    std::cout << "  iterate (n = 1000, 1000x):\n";
+    writeResult("std::allocator (global new)", benchIterate<GlobalNewQueue<T>>(1000, 1000, value));
+    writeResult("PoolAllocator", benchIterate<PooledQueue<T>>(1000, 1000, value));
+    writeResult("RingQueue", benchIterate<RingQueue<T>>(1000, 1000, value));
+
+    std::cout << "  pool slabs allocated: " << (detail::poolSlabsAllocated() - slabs0) << "\n\n";
+}
+
+int main () {
+    std::cout << "Programmer: Seiji Emery\n"
+              << "Programmer's id: M00202623\n"
+              << "File: " __FILE__ "\n\n";
+
+    benchQueue<double>("double", 1.5);
+    // (short enough for the small string optimization: only the nodes are allocated)
+    benchQueue<std::string>("std::string", std::string("customer"));
+    return 0;
+}
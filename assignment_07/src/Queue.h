@@ -11,11 +11,17 @@
 #define Queue_h
 #include <cassert>
 #include <iterator>     // std::iterator
+#include <memory>       // std::allocator, std::allocator_traits
 #include <type_traits>  // std::remove_cv
+#include <utility>      // std::forward, std::move
+#include "PoolAllocator.h"
 
 
-// Simple reference stack implementation based on a linked list.
-template <typename T>
+// Simple reference queue implementation based on a linked list.
+// Nodes are allocated w/ an (std-compatible) Allocator template parameter;
+// the default PoolAllocator (assignment_03/src/PoolAllocator.h) hands them out from slabs of 64+
+// nodes w/ a per thread free list, instead of doing one heap allocation per push.
+template <typename T, typename Allocator = PoolAllocator<T>>
 class Queue {
     struct Node {
         T     value;
@@ -26,22 +32,38 @@ class Queue {
         Node (const T& value) : value(value) {}
         ~Node () {}
     };
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Node>  NodeAllocator;
+    typedef std::allocator_traits<NodeAllocator>                                    NodeTraits;
+
     Node* head = nullptr;
     Node* tail = nullptr;
     size_t length = 0;
+    NodeAllocator alloc;
 
+    template <typename V>
+    Node* createNode (V&& value) {
+        Node* node = NodeTraits::allocate(alloc, 1);
+        new (node) Node(std::forward<V>(value));
+        return node;
+    }
+    void destroyNode (Node* node) {
+        node->~Node();
+        NodeTraits::deallocate(alloc, node, 1);
+    }
 public:
-    Queue () {}
-    Queue (const T& value) { push(value); }
-    Queue (const Queue<T>& other) { *this = other; }
+    Queue (const Allocator& alloc = Allocator()) : alloc(alloc) {}
+    Queue (const T& value, const Allocator& alloc = Allocator()) : alloc(alloc) { push(value); }
+    Queue (const Queue& other) : alloc(NodeTraits::select_on_container_copy_construction(other.alloc)) { *this = other; }
     ~Queue () { clear(); }
 
-    Queue<T>& operator= (const Queue<T>& other) {
-        clear();
-        for (Node* node = other.head; node; node = node->prev) {
-            push(new Node(node->value));
+    Queue& operator= (const Queue& other) {
+        if (this != &other) {
+            clear();
+            for (Node* node = other.head; node; node = node->prev) {
+                push(createNode(node->value));
+            }
+            assert(size() == other.size());
         }
-        assert(size() == other.size());
         return *this;
     }
 protected:
@@ -53,14 +75,14 @@ protected:
         ++length;
     }
 public:
-    void push (T&& value)      { push(new Node(value)); }
-    void push (const T& value) { push(new Node(value)); }
+    void push (T&& value)      { push(createNode(std::move(value))); }
+    void push (const T& value) { push(createNode(value)); }
 
     void pop () {
         assert(!empty());
         auto prev = head->prev;
-        delete head;
-        head = head->prev;
+        destroyNode(head);
+        head = prev;
         if (!head) { tail = head; }
         --length;
     }
@@ -92,7 +114,7 @@ private:
     class Iterator : std::iterator<std::forward_iterator_tag, UT, std::ptrdiff_t, V*, V&> {
         Node* node = nullptr;
         Iterator (Node* node) : node(node) {}
-        friend class Queue<T>;
+        friend class Queue;
     public:
         Iterator () {}
         operator bool () const { return node != nullptr; }
@@ -0,0 +1,187 @@
+// Programmer: Seiji Emery
+// Programmer ID: M00202623
+//
+// RingQueue.h
+// Queue implementation backed by a contiguous ring buffer (power-of-two capacity, grows
+// geometrically). Same API as Queue (push / pop / front / back / size / empty / clear /
+// iterators), but push only allocates when the buffer is full, and iteration walks an array
+// instead of chasing node pointers.
+//
+// Remote source:
+// https://github.com/SeijiEmery/comp220/tree/master/assignment_07/src/RingQueue.h
+//
+
+#ifndef RingQueue_h
+#define RingQueue_h
+#include <cassert>
+#include <cstddef>      // size_t, std::ptrdiff_t
+#include <iterator>     // std::iterator
+#include <memory>       // std::allocator, std::allocator_traits
+#include <type_traits>  // std::remove_cv
+#include <utility>      // std::forward, std::move, std::swap
+
+template <typename T, typename Allocator = std::allocator<T>>
+class RingQueue {
+    typedef std::allocator_traits<Allocator> AllocTraits;
+
+    T*        data = nullptr;
+    size_t    capacity_ = 0;    // 0 or a power of 2
+    size_t    head = 0;         // index of front element (always < capacity_)
+    size_t    length = 0;
+    Allocator alloc;
+
+    size_t mask () const { return capacity_ - 1; }
+    T& at (size_t i) const { return data[(head + i) & mask()]; }
+
+    // Moves all elements into a new buffer w/ capacity newCapacity (front at index 0). If value
+    // is non-null, it is also pushed (constructed before the old buffer is released, so value
+    // may refer to an element of this queue).
+    template <typename V>
+    void grow (size_t newCapacity, V* value) {
+        assert(newCapacity >= length + (value ? 1 : 0));
+        T* newData = AllocTraits::allocate(alloc, newCapacity);
+        if (value) {
+            AllocTraits::construct(alloc, &newData[length], std::forward<V>(*value));
+        }
+        for (size_t i = 0; i < length; ++i) {
+            AllocTraits::construct(alloc, &newData[i], std::move(at(i)));
+            AllocTraits::destroy(alloc, &at(i));
+        }
+        if (data) {
+            AllocTraits::deallocate(alloc, data, capacity_);
+        }
+        data = newData;
+        capacity_ = newCapacity;
+        head = 0;
+        if (value) {
+            ++length;
+        }
+    }
+    template <typename V>
+    void pushValue (V&& value) {
+        if (length == capacity_) {
+            grow(capacity_ ? capacity_ * 2 : 8, &value);
+        } else {
+            AllocTraits::construct(alloc, &at(length), std::forward<V>(value));
+            ++length;
+        }
+    }
+    static size_t nextPow2 (size_t n) {
+        size_t cap = 8;
+        while (cap < n) cap *= 2;
+        return cap;
+    }
+public:
+    RingQueue (const Allocator& alloc = Allocator()) : alloc(alloc) {}
+    RingQueue (const T& value, const Allocator& alloc = Allocator()) : alloc(alloc) { push(value); }
+    RingQueue (const RingQueue& other)
+        : alloc(AllocTraits::select_on_container_copy_construction(other.alloc)) { *this = other; }
+    RingQueue (RingQueue&& other) : alloc(other.alloc) { swap(other); }
+    ~RingQueue () {
+        clear();
+        if (data) {
+            AllocTraits::deallocate(alloc, data, capacity_);
+        }
+    }
+
+    RingQueue& operator= (const RingQueue& other) {
+        if (this != &other) {
+            clear();
+            reserve(other.length);
+            for (size_t i = 0; i < other.length; ++i) {
+                AllocTraits::construct(alloc, &data[i], other.at(i));
+                ++length;
+            }
+            assert(size() == other.size());
+        }
+        return *this;
+    }
+    RingQueue& operator= (RingQueue&& other) {
+        if (this != &other) {
+            clear();
+            swap(other);
+        }
+        return *this;
+    }
+    void swap (RingQueue& other) {
+        std::swap(data, other.data);
+        std::swap(capacity_, other.capacity_);
+        std::swap(head, other.head);
+        std::swap(length, other.length);
+        std::swap(alloc, other.alloc);
+    }
+
+    void push (T&& value)      { pushValue(std::move(value)); }
+    void push (const T& value) { pushValue(value); }
+
+    void pop () {
+        assert(!empty());
+        AllocTraits::destroy(alloc, &data[head]);
+        head = (head + 1) & mask();
+        --length;
+    }
+
+    T& front () { assert(!empty()); return at(0); }
+    T& back  () { assert(!empty()); return at(length - 1); }
+
+    const T& front () const { assert(!empty()); return at(0); }
+    const T& back  () const { assert(!empty()); return at(length - 1); }
+
+    bool empty () const { return length == 0; }
+    size_t size () const { return length; }
+    size_t capacity () const { return capacity_; }
+
+    // Grows the buffer to hold at least n elements w/out reallocating
+    void reserve (size_t n) {
+        if (n > capacity_) {
+            grow(nextPow2(n), static_cast<T*>(nullptr));
+        }
+    }
+    // Destroys all elements (keeps the buffer)
+    void clear () {
+        for (size_t i = 0; i < length; ++i) {
+            AllocTraits::destroy(alloc, &at(i));
+        }
+        head = 0;
+        length = 0;
+    }
+
+private:
+    template <typename V, typename UT = std::remove_cv<V>>
+    class Iterator : std::iterator<std::forward_iterator_tag, UT, std::ptrdiff_t, V*, V&> {
+        T*     data = nullptr;
+        size_t mask = 0;
+        size_t pos  = 0;        // unmasked physical index: head + i
+        Iterator (T* data, size_t mask, size_t pos) : data(data), mask(mask), pos(pos) {}
+        friend class RingQueue;
+        template <typename, typename> friend class Iterator;
+    public:
+        Iterator () {}
+        void swap (Iterator& other) noexcept {
+            std::swap(data, other.data);
+            std::swap(mask, other.mask);
+            std::swap(pos, other.pos);
+        }
+        Iterator& operator++ ()   { ++pos; return *this; }
+        Iterator operator++ (int) { Iterator copy(*this); ++pos; return copy; }
+        template <typename U> bool operator== (const Iterator<U>& other) const { return pos == other.pos; }
+        template <typename U> bool operator!= (const Iterator<U>& other) const { return pos != other.pos; }
+        V& operator* () const { return data[pos & mask]; }
+        V* operator-> () const { return &data[pos & mask]; }
+        operator Iterator<const V> () const { return Iterator<const V>(data, mask, pos); }
+    };
+public:
+    typedef Iterator<T>         iterator;
+    typedef Iterator<const T>   const_iterator;
+
+    iterator begin () { return iterator(data, mask(), head); }
+    iterator end   () { return iterator(data, mask(), head + length); }
+
+    const_iterator begin () const { return const_iterator(data, mask(), head); }
+    const_iterator end   () const { return const_iterator(data, mask(), head + length); }
+
+    const_iterator cbegin () const { return begin(); }
+    const_iterator cend   () const { return end(); }
+};
+
+#endif // RingQueue_h
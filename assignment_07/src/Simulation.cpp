@@ -3,7 +3,7 @@
 //
 // Simulation.cpp
 //
-// Implements a simpler server simulation using our Queue implementation.
+// Implements a simpler server simulation using our (ring buffer) Queue implementation.
 // Note: not a real server, not threadsafe, does not do anything or run in
 // real time, etc.
 //
@@ -18,7 +18,7 @@ using namespace std;
 
 #include <cstdlib>
 #include <cmath>
-#include "Queue.h"
+#include "RingQueue.h"
 #include "DynamicArray.h"
 
 struct ServerConfig {
@@ -182,7 +182,7 @@ template <typename T> T randRange (T min, T max) {
 class Simulation {
     ServerConfig          config;
     FixedArray<Server>    servers;
-    Queue<Customer>       waitQueue;
+    RingQueue<Customer>   waitQueue;
     size_t                currentTime = 0;
     bool                  isRunning = true;
 public:
@@ -192,6 +192,7 @@ public:
     {
         assert(servers.size() == config.serverCount);
         assert(servers.capacity() >= servers.size());
+        waitQueue.reserve(config.maxQueueLength);
     }
     int run () {
         std::cout << config << '\n';
@@ -0,0 +1,190 @@
+// Programmer: Seiji Emery
+// Programmer ID: M00202623
+//
+// TaskScheduler.bench.cpp
+//
+// Micro-benchmarks for the work-stealing scheduler (TaskScheduler.h):
+//
+//  – fib(n):     naive recursive fibonacci, spawn / sync at every level above a serial cutoff
+//                (measures raw spawn + steal overhead; reports ns / task)
+//  – nqueens(n): counts n-queens solutions, spawning one task per safe column in the top rows
+//                (irregular, unbalanced task tree)
+//  – parallel_for / parallel_reduce: sums an array, vs. a serial loop + one std::thread per
+//                chunk (the "ad-hoc threads" approach this replaces)
+//
+// Each is run w/ 1, 2 and 4 worker threads (+ the calling thread, which helps in sync()), and
+// checked against the serial result. Speedups depend on the # of hardware threads.
+//
+// Remote source:
+// https://github.com/SeijiEmery/comp220/tree/master/assignment_07/src/TaskScheduler.bench.cpp
+//
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <cstdlib>
+#include <cstdint>
+#include <algorithm>
+#include "TaskScheduler.h"
+
+typedef std::chrono::high_resolution_clock Clock;
+
+static std::atomic<size_t> g_tasksSpawned { 0 };
+
+long fibSerial (int n) {
+    return n < 2 ? n : fibSerial(n - 1) + fibSerial(n - 2);
+}
+long fibParallel (TaskScheduler& scheduler, int n, int cutoff) {
+    if (n < cutoff) return fibSerial(n);
+    long a, b;
+    TaskGroup group (scheduler);
+    group.spawn([&]() { a = fibParallel(scheduler, n - 1, cutoff); });
+    g_tasksSpawned.fetch_add(1, std::memory_order_relaxed);
+    b = fibParallel(scheduler, n - 2, cutoff);
+    group.sync();
+    return a + b;
+}
+
+// cols / diag1 / diag2: bitmasks of attacked columns + diagonals for the current row
+long queensSerial (int n, uint32_t cols, uint32_t diag1, uint32_t diag2) {
+    uint32_t all = (1u << n) - 1;
+    if (cols == all) return 1;
+    long count = 0;
+    for (uint32_t free = all & ~(cols | diag1 | diag2); free; free &= free - 1) {
+        uint32_t bit = free & -free;
+        count += queensSerial(n, cols | bit, (diag1 | bit) << 1 & all, (diag2 | bit) >> 1);
+    }
+    return count;
+}
+long queensParallel (TaskScheduler& scheduler, int n, int depth, uint32_t cols, uint32_t diag1, uint32_t diag2) {
+    if (depth == 0) return queensSerial(n, cols, diag1, diag2);
+    uint32_t all = (1u << n) - 1;
+    if (cols == all) return 1;
+    long counts[32] = { 0 };
+    TaskGroup group (scheduler);
+    int i = 0;
+    for (uint32_t free = all & ~(cols | diag1 | diag2); free; free &= free - 1, ++i) {
+        uint32_t bit = free & -free;
+        long* out = &counts[i];
+        group.spawn([=, &scheduler]() {
+            *out = queensParallel(scheduler, n, depth - 1, cols | bit, (diag1 | bit) << 1 & all, (diag2 | bit) >> 1);
+        });
+        g_tasksSpawned.fetch_add(1, std::memory_order_relaxed);
+    }
+    group.sync();
+    long count = 0;
+    for (int j = 0; j < i; ++j) count += counts[j];
+    return count;
+}
+
+template <typename F>
+double measureMs (const F& f) {
+    auto t0 = Clock::now();
+    f();
+    auto t1 = Clock::now();
+    return std::chrono::duration<double>(t1 - t0).count() * 1e3;
+}
+
+void check (const char* name, long got, long expected) {
+    if (got != expected) {
+        std::cerr << "FAILED: " << name << " returned " << got << " (expected " << expected << ")" << std::endl;
+        exit(-1);
+    }
+}
+
+void writeRow (const char* name, size_t threads, double ms, double serialMs, size_t tasks) {
+    std::cout << "  " << std::setw(28) << std::left << name << std::right;
+    if (threads) std::cout << std::setw(3) << threads << " workers";
+    else         std::cout << "     serial";
+    std::cout << std::setw(10) << std::fixed << std::setprecision(2) << ms << " ms"
+        << "  speedup " << std::setw(6) << serialMs / ms << "x";
+    if (tasks) {
+        // extra CPU time (across all cores that could be busy) vs. serial, per spawned task
+        size_t cores = std::min<size_t>(threads + 1, std::max(1u, std::thread::hardware_concurrency()));
+        std::cout << "  " << std::setw(9) << tasks << " tasks  "
+            << std::setw(8) << std::setprecision(1) << (ms * cores - serialMs) * 1e6 / tasks << " ns overhead / task";
+    }
+    std::cout << '\n';
+}
+
+int main () {
+    std::cout << "Programmer: Seiji Emery\n"
+              << "Programmer's id: M00202623\n"
+              << "File: " __FILE__ "\n\n";
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << "\n\n";
+
+    const size_t threadCounts[] = { 1, 2, 4 };
+
+    for (int cutoff : { 12, 20 }) {
+        const int n = 32;
+        long expected = 0;
+        double serialMs = measureMs([&]() { expected = fibSerial(n); });
+        std::cout << "fib(" << n << "), serial below n = " << cutoff << ":\n";
+        writeRow("fib", 0, serialMs, serialMs, 0);
+        for (size_t threads : threadCounts) {
+            TaskScheduler scheduler (threads);
+            long result = 0;
+            g_tasksSpawned = 0;
+            double ms = measureMs([&]() { result = fibParallel(scheduler, n, cutoff); });
+            check("fib", result, expected);
+            writeRow("fib", threads, ms, serialMs, g_tasksSpawned);
+        }
+    }
+    for (int n : { 10, 12 }) {
+        long expected = 0;
+        double serialMs = measureMs([&]() { expected = queensSerial(n, 0, 0, 0); });
+        std::cout << "\nnqueens(" << n << "), spawning in the top 3 rows:\n";
+        writeRow("nqueens", 0, serialMs, serialMs, 0);
+        for (size_t threads : threadCounts) {
+            TaskScheduler scheduler (threads);
+            long result = 0;
+            g_tasksSpawned = 0;
+            double ms = measureMs([&]() { result = queensParallel(scheduler, n, 3, 0, 0, 0); });
+            check("nqueens", result, expected);
+            writeRow("nqueens", threads, ms, serialMs, g_tasksSpawned);
+        }
+    }
+
+    const size_t count = 1 << 24;
+    std::vector<uint32_t> values (count);
+    for (size_t i = 0; i < count; ++i) values[i] = (uint32_t)(i * 2654435761u) >> 8;
+    auto sumRange = [&](size_t i0, size_t i1) {
+        uint64_t sum = 0;
+        for (size_t i = i0; i < i1; ++i) sum += values[i];
+        return sum;
+    };
+    uint64_t expected = 0;
+    double serialMs = measureMs([&]() { expected = sumRange(0, count); });
+    std::cout << "\nsum of " << count << " uint32s:\n";
+    writeRow("serial loop", 0, serialMs, serialMs, 0);
+    for (size_t threads : threadCounts) {
+        uint64_t result = 0;
+        double ms = measureMs([&]() {
+            std::vector<std::thread> pool;
+            std::vector<uint64_t> sums (threads + 1);
+            size_t chunk = count / (threads + 1);
+            for (size_t t = 0; t < threads; ++t) {
+                pool.emplace_back([&, t]() { sums[t] = sumRange(t * chunk, (t + 1) * chunk); });
+            }
+            sums[threads] = sumRange(threads * chunk, count);
+            for (auto& thread : pool) thread.join();
+            for (auto sum : sums) result += sum;
+        });
+        check("std::thread sum", (long)result, (long)expected);
+        writeRow("std::thread per chunk", threads, ms, serialMs, 0);
+    }
+    for (size_t threads : threadCounts) {
+        TaskScheduler scheduler (threads);
+        uint64_t result = 0;
+        double ms = measureMs([&]() {
+            result = parallel_reduce(0, count, 1 << 16, (uint64_t)0, sumRange,
+                [](uint64_t a, uint64_t b) { return a + b; }, scheduler);
+        });
+        check("parallel_reduce", (long)result, (long)expected);
+        writeRow("parallel_reduce (64k grain)", threads, ms, serialMs, 0);
+    }
+    return 0;
+}
@@ -0,0 +1,405 @@
+// Programmer: Seiji Emery
+// Programmer ID: M00202623
+//
+// TaskScheduler.h
+// Small work-stealing task runtime (fork-join), shared by anything in the tree that wants to
+// use more than one core:
+//
+//  – TaskScheduler: a fixed set of worker threads, each w/ its own Chase-Lev deque. Workers
+//    push + pop tasks at the bottom of their own deque, and steal from the top of other
+//    workers' deques when they run out. Tasks spawned from non-worker threads go to a shared
+//    injection queue. Idle workers go to sleep (condition variable) instead of spinning.
+//    TaskScheduler::global() is the default, process wide scheduler.
+//
+//  – TaskGroup: spawn(f) + sync(). sync() doesn't just block: the calling thread runs pending
+//    tasks (its own first, then stolen ones) until every task in the group has finished.
+//
+//  – parallel_for (begin, end, grain, f(i0, i1)): recursively splits [begin, end) into chunks
+//    of <= grain elements.
+//  – parallel_reduce (begin, end, grain, identity, map(i0, i1), reduce(a, b)): maps fixed
+//    chunks in parallel, then reduces the chunk results in order, so the result is
+//    deterministic (doesn't depend on the # of threads / scheduling) for any associative
+//    reduce.
+//
+// Tasks must not throw (an exception escaping a task calls std::terminate).
+//
+// Remote source:
+// https://github.com/SeijiEmery/comp220/tree/master/assignment_07/src/TaskScheduler.h
+//
+
+#ifndef TaskScheduler_h
+#define TaskScheduler_h
+#include <cassert>
+#include <cstddef>      // size_t
+#include <cstdint>      // int64_t
+#include <cstdlib>      // posix_memalign, free
+#include <new>          // placement new, std::bad_alloc
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <utility>      // std::move, std::forward
+#include <type_traits>  // std::decay
+#include "RingQueue.h"  // injection queue
+
+class TaskGroup;
+
+namespace tasks {
+
+struct Task {
+    TaskGroup* group = nullptr;
+    virtual ~Task () {}
+    virtual void run () = 0;
+};
+
+template <typename F>
+struct FunctionTask : Task {
+    F f;
+    FunctionTask (F&& f) : f(std::move(f)) {}
+    FunctionTask (const F& f) : f(f) {}
+    void run () override { f(); }
+};
+
+// Chase-Lev work-stealing deque (Lê, Pop, Cohen + Zappa Nardelli, "Correct and Efficient
+// Work-Stealing for Weak Memory Models", 2013). The owning thread push()es + pop()s at the
+// bottom; any thread may steal() from the top. Grows (never shrinks) when full; old arrays
+// are kept until the deque is destroyed, since thieves may still be reading them.
+class ChaseLevDeque {
+    struct Array {
+        int64_t                  capacity;
+        std::atomic<Task*>*      slots;
+        Array*                   prev;
+
+        Array (int64_t capacity, Array* prev)
+            : capacity(capacity), slots(new std::atomic<Task*>[capacity]), prev(prev) {}
+        ~Array () { delete[] slots; }
+
+        Task* get (int64_t i) const { return slots[i & (capacity - 1)].load(std::memory_order_acquire); }
+        void put (int64_t i, Task* task) { slots[i & (capacity - 1)].store(task, std::memory_order_release); }
+    };
+    alignas(64) std::atomic<int64_t> top    { 0 };
+    alignas(64) std::atomic<int64_t> bottom { 0 };
+    std::atomic<Array*>              array;
+
+    Array* grow (Array* a, int64_t b, int64_t t) {
+        Array* bigger = new Array(a->capacity * 2, a);
+        for (int64_t i = t; i < b; ++i) {
+            bigger->put(i, a->get(i));
+        }
+        array.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+public:
+    ChaseLevDeque (int64_t capacity = 256) : array(new Array(capacity, nullptr)) {}
+    ChaseLevDeque (const ChaseLevDeque&) = delete;
+    ChaseLevDeque& operator= (const ChaseLevDeque&) = delete;
+    ~ChaseLevDeque () {
+        for (Array* a = array.load(); a; ) {
+            Array* prev = a->prev;
+            delete a;
+            a = prev;
+        }
+    }
+
+    // Owner only
+    void push (Task* task) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        Array*  a = array.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1) {
+            a = grow(a, b, t);
+        }
+        a->put(b, task);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_release);
+    }
+    // Owner only
+    Task* pop () {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Array*  a = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+
+        Task* task = nullptr;
+        if (t <= b) {
+            task = a->get(b);
+            if (t == b) {
+                // last element: race w/ thieves for it
+                if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    task = nullptr;
+                }
+                bottom.store(b + 1, std::memory_order_relaxed);
+            }
+        } else {
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+    // Any thread
+    Task* steal () {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t < b) {
+            Task* task = array.load(std::memory_order_acquire)->get(t);
+            if (top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return task;
+            }
+        }
+        return nullptr;
+    }
+    bool empty () const {
+        return bottom.load(std::memory_order_acquire) <= top.load(std::memory_order_acquire);
+    }
+};
+
+} // namespace tasks
+
+class TaskScheduler {
+    struct Worker {
+        TaskScheduler*       scheduler;
+        size_t               index;
+        tasks::ChaseLevDeque deque;
+        std::thread          thread;
+        Worker (TaskScheduler* scheduler, size_t index) : scheduler(scheduler), index(index) {}
+
+        // deque's top / bottom are alignas(64), but (C++11) operator new only guarantees
+        // alignof(max_align_t), so workers are allocated w/ posix_memalign + placement new
+        static Worker* create (TaskScheduler* scheduler, size_t index) {
+            void* mem = nullptr;
+            if (posix_memalign(&mem, alignof(Worker), sizeof(Worker))) {
+                throw std::bad_alloc();
+            }
+            return new (mem) Worker(scheduler, index);
+        }
+        static void destroy (Worker* worker) {
+            worker->~Worker();
+            std::free(worker);
+        }
+    };
+    std::vector<Worker*>          workers;
+
+    // Tasks spawned from non-worker threads
+    std::mutex                    injectionMutex;
+    RingQueue<tasks::Task*>       injected;
+    std::atomic<size_t>           injectedCount { 0 };
+
+    // Sleeping (idle) workers
+    std::mutex                    sleepMutex;
+    std::condition_variable       wakeup;
+    std::atomic<size_t>           sleepers { 0 };
+    std::atomic<bool>             stopping { false };
+
+    static Worker*& currentWorker () {
+        static thread_local Worker* worker = nullptr;
+        return worker;
+    }
+    Worker* localWorker () const {
+        Worker* worker = currentWorker();
+        return worker && worker->scheduler == this ? worker : nullptr;
+    }
+
+    tasks::Task* popInjected () {
+        if (!injectedCount.load(std::memory_order_acquire)) return nullptr;
+        std::lock_guard<std::mutex> lock (injectionMutex);
+        if (injected.empty()) return nullptr;
+        tasks::Task* task = injected.front();
+        injected.pop();
+        --injectedCount;
+        return task;
+    }
+    tasks::Task* stealFrom (size_t start) {
+        for (size_t i = 0, n = workers.size(); i < n; ++i) {
+            if (tasks::Task* task = workers[(start + i) % n]->deque.steal()) {
+                return task;
+            }
+        }
+        return nullptr;
+    }
+    bool hasWork () const {
+        if (injectedCount.load(std::memory_order_acquire)) return true;
+        for (auto worker : workers) {
+            if (!worker->deque.empty()) return true;
+        }
+        return false;
+    }
+    void notify () {
+        if (sleepers.load(std::memory_order_seq_cst)) {
+            std::lock_guard<std::mutex> lock (sleepMutex);
+            wakeup.notify_one();
+        }
+    }
+    void workerLoop (Worker* self) {
+        currentWorker() = self;
+        size_t idleSpins = 0;
+        while (!stopping.load(std::memory_order_acquire)) {
+            if (tasks::Task* task = findTask(self)) {
+                execute(task);
+                idleSpins = 0;
+            } else if (++idleSpins < 64) {
+                std::this_thread::yield();
+            } else {
+                // Go to sleep. sleepers is incremented before re-checking for work, and
+                // notify() checks sleepers after publishing work, so one of us sees the other.
+                std::unique_lock<std::mutex> lock (sleepMutex);
+                sleepers.fetch_add(1, std::memory_order_seq_cst);
+                if (!hasWork() && !stopping.load(std::memory_order_acquire)) {
+                    wakeup.wait_for(lock, std::chrono::milliseconds(100));
+                }
+                sleepers.fetch_sub(1, std::memory_order_seq_cst);
+                idleSpins = 0;
+            }
+        }
+        currentWorker() = nullptr;
+    }
+    tasks::Task* findTask (Worker* self) {
+        if (self) {
+            if (tasks::Task* task = self->deque.pop()) return task;
+        }
+        if (tasks::Task* task = popInjected()) return task;
+        return stealFrom(self ? self->index + 1 : 0);
+    }
+    void execute (tasks::Task* task);
+    void submit (tasks::Task* task) {
+        if (Worker* worker = localWorker()) {
+            worker->deque.push(task);
+        } else {
+            std::lock_guard<std::mutex> lock (injectionMutex);
+            injected.push(task);
+            ++injectedCount;
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        notify();
+    }
+    friend class TaskGroup;
+
+public:
+    // threads: # of worker threads (0 => hardware_concurrency). Threads that call
+    // TaskGroup::sync() also run tasks while they wait, so w/ 1 worker thread, 2 cores are used.
+    TaskScheduler (size_t threads = 0) {
+        if (!threads) {
+            threads = std::thread::hardware_concurrency();
+            if (!threads) threads = 1;
+        }
+        for (size_t i = 0; i < threads; ++i) {
+            workers.push_back(Worker::create(this, i));
+        }
+        for (auto worker : workers) {
+            worker->thread = std::thread([this, worker]() { workerLoop(worker); });
+        }
+    }
+    TaskScheduler (const TaskScheduler&) = delete;
+    TaskScheduler& operator= (const TaskScheduler&) = delete;
+    ~TaskScheduler () {
+        stopping.store(true, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock (sleepMutex);
+            wakeup.notify_all();
+        }
+        for (auto worker : workers) {
+            worker->thread.join();
+            Worker::destroy(worker);
+        }
+    }
+
+    size_t threadCount () const { return workers.size(); }
+
+    // Process wide scheduler (created on first use, w/ hardware_concurrency() workers)
+    static TaskScheduler& global () {
+        static TaskScheduler scheduler;
+        return scheduler;
+    }
+};
+
+// Fork-join task group: spawn any number of tasks, then sync() to wait for all of them
+class TaskGroup {
+    TaskScheduler&      scheduler;
+    std::atomic<size_t> pending { 0 };
+    friend class TaskScheduler;
+public:
+    TaskGroup (TaskScheduler& scheduler = TaskScheduler::global()) : scheduler(scheduler) {}
+    TaskGroup (const TaskGroup&) = delete;
+    TaskGroup& operator= (const TaskGroup&) = delete;
+    ~TaskGroup () { sync(); }
+
+    template <typename F>
+    void spawn (F&& f) {
+        typedef tasks::FunctionTask<typename std::decay<F>::type> Task;
+        Task* task = new Task(std::forward<F>(f));
+        task->group = this;
+        pending.fetch_add(1, std::memory_order_relaxed);
+        scheduler.submit(task);
+    }
+    // Runs tasks until all tasks spawned in this group have finished
+    void sync () {
+        TaskScheduler::Worker* self = scheduler.localWorker();
+        while (pending.load(std::memory_order_acquire)) {
+            if (tasks::Task* task = scheduler.findTask(self)) {
+                scheduler.execute(task);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+};
+
+inline void TaskScheduler::execute (tasks::Task* task) {
+    TaskGroup* group = task->group;
+    task->run();
+    delete task;
+    group->pending.fetch_sub(1, std::memory_order_release);
+}
+
+namespace tasks {
+
+template <typename F>
+void splitFor (TaskGroup& group, size_t begin, size_t end, size_t grain, const F& f) {
+    while (end - begin > grain) {
+        size_t mid = begin + (end - begin) / 2;
+        group.spawn([&group, mid, end, grain, &f]() { splitFor(group, mid, end, grain, f); });
+        end = mid;
+    }
+    f(begin, end);
+}
+
+} // namespace tasks
+
+// Calls f(i0, i1) over disjoint subranges (of <= grain elements) that cover [begin, end)
+template <typename F>
+void parallel_for (size_t begin, size_t end, size_t grain, const F& f,
+                   TaskScheduler& scheduler = TaskScheduler::global())
+{
+    if (begin >= end) return;
+    if (!grain) grain = 1;
+    TaskGroup group (scheduler);
+    tasks::splitFor(group, begin, end, grain, f);
+    group.sync();
+}
+
+// Splits [begin, end) into chunks of grain elements, computes map(i0, i1) for each chunk in
+// parallel, and then folds the results in chunk order: reduce(...reduce(identity, r0), r1)...)
+template <typename T, typename Map, typename Reduce>
+T parallel_reduce (size_t begin, size_t end, size_t grain, T identity, const Map& map, const Reduce& reduce,
+                   TaskScheduler& scheduler = TaskScheduler::global())
+{
+    if (begin >= end) return identity;
+    if (!grain) grain = 1;
+    size_t chunks = (end - begin + grain - 1) / grain;
+    std::vector<T> results (chunks, identity);
+    parallel_for(0, chunks, 1, [&](size_t c0, size_t c1) {
+        for (size_t c = c0; c < c1; ++c) {
+            size_t i0 = begin + c * grain, i1 = i0 + grain < end ? i0 + grain : end;
+            results[c] = map(i0, i1);
+        }
+    }, scheduler);
+    T result = std::move(identity);
+    for (auto& value : results) {
+        result = reduce(std::move(result), std::move(value));
+    }
+    return result;
+}
+
+#endif // TaskScheduler_h
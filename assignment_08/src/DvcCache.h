@@ -0,0 +1,317 @@
+// Programmer: Seiji Emery
+// Programmer ID: M00202623
+//
+// DvcCache.h
+// Binary, columnar cache of the parsed DVC schedule, so tools don't have to re-parse the text file
+// on every start. One row per section, stored as separate columns (structure of arrays):
+//
+//  – date:          uint8   season:2 | (year - 2000):6   (same packing as dvc_parser.c's SectionId
+//                           and DvcScheduleCheck's Date)
+//  – section:       uint16  section #
+//  – subject:       uint16  interned subject id (index into the subject table)
+//  – course number: uint32  offset of the (interned) course # string in the string pool
+//  – flags:         uint8   ROW_STRICT: the row also passes dvc_check / dvc_search's stricter
+//                           parser (capitalized instructor name)
+//                           ROW_COURSE_NUMBER: the course # is non-empty + followed by a tab (as
+//                           DvcSchedule9's parser requires)
+//
+// + a subject table (uint32 pool offsets) and a string pool of '\0' terminated strings. The header
+// has a magic + format version, the size + mtime of the text file it was converted from, and a
+// checksum of the whole file (header included, w/ the checksum field zeroed); DvcCache (the
+// loader) mmaps the file and rejects it if any of those don't match, if any column / table runs
+// past the end of the file, or if any subject id / pool offset is out of range (checked once, at
+// load time, so the accessors don't have to), so callers can fall back to parsing the text file.
+//
+// convertDvcToCache() (dvc_convert) writes the cache; the default cache path for
+// dvc-schedule.txt is dvc-schedule.txt.cache.
+//
+// Remote source:
+// https://github.com/SeijiEmery/comp220/tree/master/assignment_08/src/DvcCache.h
+//
+
+#ifndef DvcCache_h
+#define DvcCache_h
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <fcntl.h>      // open
+#include <unistd.h>     // close
+#include <sys/mman.h>   // mmap
+#include <sys/stat.h>   // fstat, stat
+#include "StructuralIndex.h"
+
+enum { DVC_CACHE_VERSION = 3 };
+
+struct DvcCacheHeader {
+    enum { ROW_STRICT = 1, ROW_COURSE_NUMBER = 2 };
+    enum { MIN_YEAR = 2000, MAX_YEAR = MIN_YEAR + 63 };     // (date column: (year - 2000):6)
+
+    char     magic[4];          // "DVCC"
+    uint32_t version;           // DVC_CACHE_VERSION
+    uint64_t sourceSize;        // text file this was converted from
+    int64_t  sourceMtime;
+    uint32_t rowCount;
+    uint32_t subjectCount;
+    uint32_t poolSize;
+    uint32_t reserved;
+    uint64_t checksum;          // dvcCacheFileChecksum() (of the whole file, w/ this zeroed)
+    uint64_t fileSize;
+    // byte offsets (from the start of the file, 8 byte aligned) of each column / table
+    uint64_t dates, sections, subjects, courseNumbers, flags, subjectTable, pool;
+};
+
+// FNV-1a over 8 byte words (size must be a multiple of 8); pass the previous hash to continue it
+inline uint64_t dvcCacheChecksum (const char* data, size_t size, uint64_t hash = 14695981039346656037ull) {
+    for (size_t i = 0; i < size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * 1099511628211ull;
+    }
+    return hash;
+}
+static_assert(sizeof(DvcCacheHeader) % 8 == 0, "DvcCacheHeader must be a multiple of 8 bytes");
+
+// Checksum of a whole cache file (size >= sizeof(DvcCacheHeader)), w/ the header's checksum zeroed
+inline uint64_t dvcCacheFileChecksum (const char* data, size_t size) {
+    DvcCacheHeader header;
+    memcpy(&header, data, sizeof(header));
+    header.checksum = 0;
+    uint64_t hash = dvcCacheChecksum(reinterpret_cast<const char*>(&header), sizeof(header));
+    return dvcCacheChecksum(data + sizeof(header), size - sizeof(header), hash);
+}
+
+inline std::string dvcCachePath (const char* textPath) {
+    return std::string(textPath) + ".cache";
+}
+
+// Read-only, mmapped cache file. Check valid() (+ error() for why not) before using it.
+class DvcCache {
+    const char*           data  = nullptr;
+    size_t                size  = 0;
+    const DvcCacheHeader* header = nullptr;
+    const char*           error_ = nullptr;
+    bool                  found_ = false;
+
+    template <typename T> const T* column (uint64_t offset) const {
+        return reinterpret_cast<const T*>(data + offset);
+    }
+    // column / table of count T's at offset is aligned + inside the file
+    template <typename T> bool inBounds (uint64_t offset, uint64_t count) const {
+        return offset % alignof(T) == 0 && offset >= sizeof(DvcCacheHeader) && offset <= size &&
+               count <= (size - offset) / sizeof(T);
+    }
+    bool inBounds (const DvcCacheHeader* h) const {
+        return inBounds<uint8_t>(h->dates, h->rowCount) && inBounds<uint16_t>(h->sections, h->rowCount) &&
+               inBounds<uint16_t>(h->subjects, h->rowCount) && inBounds<uint32_t>(h->courseNumbers, h->rowCount) &&
+               inBounds<uint8_t>(h->flags, h->rowCount) && inBounds<uint32_t>(h->subjectTable, h->subjectCount) &&
+               inBounds<char>(h->pool, h->poolSize);
+    }
+    // every subject id indexes the subject table, and every pool offset points at a '\0'
+    // terminated string inside the pool
+    bool validIds (const DvcCacheHeader* h) const {
+        if (h->poolSize == 0 || data[h->pool + h->poolSize - 1] != '\0') {
+            return h->rowCount == 0 && h->subjectCount == 0;
+        }
+        const uint16_t* subjects      = column<uint16_t>(h->subjects);
+        const uint32_t* courseNumbers = column<uint32_t>(h->courseNumbers);
+        const uint32_t* subjectTable  = column<uint32_t>(h->subjectTable);
+        for (size_t row = 0; row < h->rowCount; ++row) {
+            if (subjects[row] >= h->subjectCount || courseNumbers[row] >= h->poolSize) return false;
+        }
+        for (size_t id = 0; id < h->subjectCount; ++id) {
+            if (subjectTable[id] >= h->poolSize) return false;
+        }
+        return true;
+    }
+public:
+    // sourcePath: if given (and it exists), the cache must have been converted from a file w/ the
+    // same size + mtime
+    DvcCache (const char* cachePath, const char* sourcePath = nullptr) {
+        int fd = open(cachePath, O_RDONLY);
+        struct stat info;
+        if (fd < 0 || fstat(fd, &info) != 0) { error_ = "no cache file"; if (fd >= 0) close(fd); return; }
+        size = (size_t)info.st_size;
+        if (size >= sizeof(DvcCacheHeader)) {
+            void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) data = static_cast<const char*>(mapping);
+        }
+        close(fd);
+        found_ = true;
+        if (!data) { error_ = "could not map cache file"; return; }
+
+        const DvcCacheHeader* h = reinterpret_cast<const DvcCacheHeader*>(data);
+        struct stat source;
+        if (memcmp(h->magic, "DVCC", 4) != 0) {
+            error_ = "not a DVC cache file";
+        } else if (h->version != DVC_CACHE_VERSION) {
+            error_ = "cache file has a different format version";
+        } else if (h->fileSize != size || size % 8 != 0 || !inBounds(h)) {
+            error_ = "cache file is truncated";
+        } else if (sourcePath && stat(sourcePath, &source) == 0 &&
+                   ((uint64_t)source.st_size != h->sourceSize || (int64_t)source.st_mtime != h->sourceMtime)) {
+            error_ = "cache file is out of date";
+        } else if (dvcCacheFileChecksum(data, size) != h->checksum) {
+            error_ = "cache file checksum mismatch";
+        } else if (!validIds(h)) {
+            error_ = "cache file has an out of range subject id / string offset";
+        } else {
+            header = h;
+        }
+    }
+    DvcCache (const DvcCache&) = delete;
+    DvcCache& operator= (const DvcCache&) = delete;
+    ~DvcCache () {
+        if (data) munmap(const_cast<char*>(data), size);
+    }
+
+    bool        found () const { return found_; }           // (the cache file exists, valid or not)
+    bool        valid () const { return header != nullptr; }
+    const char* error () const { return error_; }
+
+    size_t      rows         () const { return header->rowCount; }
+    size_t      subjectCount () const { return header->subjectCount; }
+
+    // Columns (arrays of rows() elements)
+    const uint8_t*  dates         () const { return column<uint8_t>(header->dates); }
+    const uint16_t* sections      () const { return column<uint16_t>(header->sections); }
+    const uint16_t* subjects      () const { return column<uint16_t>(header->subjects); }
+    const uint32_t* courseNumbers () const { return column<uint32_t>(header->courseNumbers); }
+    const uint8_t*  flags         () const { return column<uint8_t>(header->flags); }
+
+    // (offsets / ids read from the columns were range checked when the cache was loaded)
+    const char* string (uint32_t offset) const {
+        assert(offset < header->poolSize);
+        return data + header->pool + offset;
+    }
+    const char* subjectName (size_t id) const {
+        assert(id < header->subjectCount);
+        return string(column<uint32_t>(header->subjectTable)[id]);
+    }
+};
+
+// Parses the text file (w/ StructuralIndexer) into columns, and writes them to cachePath. Lines
+// that don't start w/ a valid term (year in [MIN_YEAR, MAX_YEAR]), section and "SUBJECT-number"
+// course are skipped (eg. the header line); rows that only some of the text parsers accept are
+// flagged (ROW_STRICT / ROW_COURSE_NUMBER). Returns false (+ sets error) on failure.
+inline bool convertDvcToCache (const char* textPath, const char* cachePath, std::string& error) {
+    FILE* file = fopen(textPath, "rb");
+    struct stat info;
+    if (!file || fstat(fileno(file), &info) != 0) {
+        error = std::string("could not open '") + textPath + "'";
+        if (file) fclose(file);
+        return false;
+    }
+    std::string text ((size_t)info.st_size + 64, '\0');  // (zero padded, for StructuralIndexer)
+    size_t size = fread(&text[0], 1, (size_t)info.st_size, file);
+    fclose(file);
+
+    std::vector<uint8_t>  dates, flags;
+    std::vector<uint16_t> sections, subjects;
+    std::vector<uint32_t> courseNumbers, subjectTable;
+    std::string pool;
+    std::unordered_map<std::string, uint32_t> interned;       // string -> pool offset
+    std::unordered_map<std::string, uint16_t> subjectIds;
+    auto intern = [&](const std::string& str) {
+        auto it = interned.find(str);
+        if (it != interned.end()) return it->second;
+        uint32_t offset = (uint32_t)pool.size();
+        pool.append(str.c_str(), str.size() + 1);
+        return interned[str] = offset;
+    };
+    auto digits = [](const char* str, size_t count) {
+        for (size_t i = 0; i < count; ++i) if (str[i] < '0' || str[i] > '9') return false;
+        return true;
+    };
+
+    StructuralIndexer indexer (&text[0], &text[size]);
+    LineFields fields;
+    while (indexer.next(fields)) {
+        const char* line = fields.begin;
+        static const char* seasons[4] = { "Spring ", "Summer ", "Fall ", "Winter " };
+        int season = 0;
+        while (season < 4 && strncmp(line, seasons[season], strlen(seasons[season])) != 0) ++season;
+        if (season == 4) continue;
+        const char* year = line + strlen(seasons[season]);
+        const char* section = fields.tabs[0] + 1;
+        const char* course  = fields.tabs[1] + 1;
+        if (fields.tabs[0] != year + 4 || !digits(year, 4) ||
+            fields.tabs[1] != section + 4 || !digits(section, 4) ||
+            fields.dash <= course || fields.dash >= fields.tabs[2] || !isupper(course[0]))
+        {
+            continue;
+        }
+        int yearOffset = atoi(std::string(year, 4).c_str()) - DvcCacheHeader::MIN_YEAR;
+        if (yearOffset < 0 || yearOffset > DvcCacheHeader::MAX_YEAR - DvcCacheHeader::MIN_YEAR) continue;
+
+        std::string subject (course, fields.dash);
+        auto id = subjectIds.find(subject);
+        if (id == subjectIds.end()) {
+            id = subjectIds.insert({ subject, (uint16_t)subjectTable.size() }).first;
+            subjectTable.push_back(intern(subject));
+        }
+        const char* instructor = fields.tabs[2] + 1;
+        dates.push_back((uint8_t)(season | yearOffset << 2));
+        sections.push_back((uint16_t)atoi(std::string(section, 4).c_str()));
+        subjects.push_back(id->second);
+        courseNumbers.push_back(intern(std::string(fields.dash + 1, fields.tabs[2])));
+        bool courseNumber = fields.dash + 1 < fields.tabs[2] && fields.tabs[2] < fields.end;
+        // (dvc_check / dvc_search's parser checks the course #'s 2nd char for a digit)
+        bool strict = courseNumber && isdigit(fields.dash[2]) && isupper(instructor[0]) && fields.tabs[3] < fields.end;
+        flags.push_back((courseNumber ? DvcCacheHeader::ROW_COURSE_NUMBER : 0) |
+                        (strict       ? DvcCacheHeader::ROW_STRICT        : 0));
+    }
+    if (subjectTable.size() > 0xFFFF) {
+        error = "too many subjects";
+        return false;
+    }
+
+    // Layout: header, then each column / table (8 byte aligned)
+    DvcCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "DVCC", 4);
+    header.version      = DVC_CACHE_VERSION;
+    header.sourceSize   = (uint64_t)info.st_size;
+    header.sourceMtime  = (int64_t)info.st_mtime;
+    header.rowCount     = (uint32_t)dates.size();
+    header.subjectCount = (uint32_t)subjectTable.size();
+    header.poolSize     = (uint32_t)pool.size();
+
+    std::string out (sizeof(header), '\0');
+    auto append = [&](const void* data, size_t bytes) {
+        uint64_t offset = out.size();
+        out.append(static_cast<const char*>(data), bytes);
+        out.resize((out.size() + 7) & ~(size_t)7, '\0');
+        return offset;
+    };
+    header.dates         = append(dates.data(),         dates.size());
+    header.sections      = append(sections.data(),      sections.size() * sizeof(uint16_t));
+    header.subjects      = append(subjects.data(),      subjects.size() * sizeof(uint16_t));
+    header.courseNumbers = append(courseNumbers.data(), courseNumbers.size() * sizeof(uint32_t));
+    header.flags         = append(flags.data(),         flags.size());
+    header.subjectTable  = append(subjectTable.data(),  subjectTable.size() * sizeof(uint32_t));
+    header.pool          = append(pool.data(),          pool.size());
+    header.fileSize      = out.size();
+    memcpy(&out[0], &header, sizeof(header));
+    header.checksum      = dvcCacheFileChecksum(out.data(), out.size());
+    memcpy(&out[0], &header, sizeof(header));
+
+    // (write to a temp file + rename, so readers never see a partial cache)
+    std::string tempPath = std::string(cachePath) + ".tmp";
+    FILE* cache = fopen(tempPath.c_str(), "wb");
+    bool ok = cache && fwrite(out.data(), 1, out.size(), cache) == out.size();
+    if (cache) ok = fclose(cache) == 0 && ok;
+    if (!ok || rename(tempPath.c_str(), cachePath) != 0) {
+        remove(tempPath.c_str());
+        error = std::string("could not write '") + cachePath + "'";
+        return false;
+    }
+    return true;
+}
+
+#endif // DvcCache_h
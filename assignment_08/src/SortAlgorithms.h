@@ -0,0 +1,41 @@
+// Programmer: Seiji Emery
+// Programmer ID: M00202623
+//
+// SortAlgorithms.h
+//
+// Simple O(n^2) sorts shared by dvc_version_3.cpp (BubbleSort actor) and sort_test.cpp (benchmarks).
+//
+// remote source: https://github.com/SeijiEmery/comp220/blob/master/assignment_08/src/SortAlgorithms.h
+//
+
+#ifndef SortAlgorithms_h
+#define SortAlgorithms_h
+
+#include <utility>  // std::swap
+
+// Simple bubblesort (technically an exchange sort: compares every element against all later elements).
+template <typename Iterator>
+void bubbleSort (Iterator begin, Iterator end) {
+    for (; begin != end; ++begin) {
+        for (auto other = begin; ++other != end; ) {
+            if (*begin > *other) {
+                std::swap(*begin, *other);
+            }
+        }
+    }
+}
+
+// Same algorithm, w/ a custom comparison + swap counter; used to implement the BubbleSort actor.
+template <typename Iterator, typename Greater>
+void exchangeSort (Iterator front, Iterator back, const Greater& greater, size_t& swapCount) {
+    for (; front != back; ++front) {
+        for (auto second = front; second != back; ++second) {
+            if (greater(*front, *second)) {
+                std::swap(*front, *second);
+                ++swapCount;
+            }
+        }
+    }
+}
+
+#endif // SortAlgorithms_h
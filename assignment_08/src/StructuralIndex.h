@@ -0,0 +1,173 @@
+// Programmer: Seiji Emery
+// Programmer ID: M00202623
+//
+// StructuralIndex.h
+// Finds the structural characters of the DVC schedule format ('\n', '\t' and '-') 64 bytes at a
+// time w/ AVX2 / SSE2 compares (scalar fallback elsewhere), producing one bitmask per character
+// (bit i = byte i of the block; same idea as simdjson's stage 1). The kernel is selected at runtime
+// via cpuid (like SortingNetwork.h), so this header does NOT need to be compiled w/ -mavx2 /
+// -march=native.
+//
+// StructuralIndexer walks a buffer block by block and splits it into lines, recording each line's
+// first few tabs + first '-' from the same masks, so readers + parsers don't have to rescan each
+// line w/ strchr / memchr. Buffers must stay readable for 64 bytes past their end (eg. zero
+// padding or a guard page); bits past the end are masked off.
+//
+// Remote source:
+// https://github.com/SeijiEmery/comp220/tree/master/assignment_08/src/StructuralIndex.h
+//
+
+#ifndef StructuralIndex_h
+#define StructuralIndex_h
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define STRUCTURAL_INDEX_X86
+    #include <immintrin.h>
+    #define SI_TARGET(arch) __attribute__((target(arch), always_inline))
+#endif
+
+struct StructuralMasks {
+    uint64_t newlines, tabs, dashes;
+};
+
+enum class StructuralSimdLevel { SCALAR = 0, SSE2 = 1, AVX2 = 2 };
+
+inline StructuralSimdLevel detectStructuralSimdLevel () {
+    #ifdef STRUCTURAL_INDEX_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return StructuralSimdLevel::AVX2;
+        if (__builtin_cpu_supports("sse2")) return StructuralSimdLevel::SSE2;
+    #endif
+    return StructuralSimdLevel::SCALAR;
+}
+
+// Cached simd level; can be overridden (eg. by tests) to force a specific kernel.
+inline StructuralSimdLevel& structuralSimdLevel () {
+    static StructuralSimdLevel level = detectStructuralSimdLevel();
+    return level;
+}
+
+inline uint64_t matchScalar64 (const char* block, char c) {
+    uint64_t mask = 0;
+    for (int i = 0; i < 64; ++i) {
+        mask |= (uint64_t)(block[i] == c) << i;
+    }
+    return mask;
+}
+
+#ifdef STRUCTURAL_INDEX_X86
+SI_TARGET("avx2") inline uint64_t matchAvx2 (__m256i lo, __m256i hi, char c) {
+    __m256i k = _mm256_set1_epi8(c);
+    return (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, k)) |
+           (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, k)) << 32;
+}
+__attribute__((target("avx2"))) inline StructuralMasks scanStructural64Avx2 (const char* block) {
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+    return { matchAvx2(lo, hi, '\n'), matchAvx2(lo, hi, '\t'), matchAvx2(lo, hi, '-') };
+}
+
+SI_TARGET("sse2") inline uint64_t matchSse2 (const __m128i* v, char c) {
+    __m128i k = _mm_set1_epi8(c);
+    uint64_t mask = 0;
+    for (int i = 0; i < 4; ++i) {
+        mask |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v[i], k)) << (16 * i);
+    }
+    return mask;
+}
+__attribute__((target("sse2"))) inline StructuralMasks scanStructural64Sse2 (const char* block) {
+    __m128i v[4];
+    for (int i = 0; i < 4; ++i) {
+        v[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i));
+    }
+    return { matchSse2(v, '\n'), matchSse2(v, '\t'), matchSse2(v, '-') };
+}
+#endif // STRUCTURAL_INDEX_X86
+
+inline StructuralMasks scanStructural64 (const char* block) {
+    #ifdef STRUCTURAL_INDEX_X86
+        switch (structuralSimdLevel()) {
+            case StructuralSimdLevel::AVX2: return scanStructural64Avx2(block);
+            case StructuralSimdLevel::SSE2: return scanStructural64Sse2(block);
+            default: break;
+        }
+    #endif
+    return { matchScalar64(block, '\n'), matchScalar64(block, '\t'), matchScalar64(block, '-') };
+}
+
+// Structural positions of one line (pointers into the buffer)
+struct LineFields {
+    enum { MAX_TABS = 4 };
+    const char* begin;
+    const char* end;                // the line's '\n' (or the end of the buffer)
+    const char* tabs[MAX_TABS];     // first MAX_TABS tabs (== end if the line has fewer)
+    const char* dash;               // first '-' (== end if none)
+};
+
+class StructuralIndexer {
+    const char*     block = nullptr;    // current 64 byte block
+    const char*     end   = nullptr;
+    const char*     nextLine = nullptr;
+    StructuralMasks masks { 0, 0, 0 };  // current block, w/ the bits of already returned lines cleared
+
+    void load (const char* ptr) {
+        block = ptr;
+        masks = scanStructural64(ptr);
+        if (end - ptr < 64) {
+            uint64_t valid = (1ull << (end - ptr)) - 1;
+            masks.newlines &= valid; masks.tabs &= valid; masks.dashes &= valid;
+        }
+    }
+public:
+    StructuralIndexer () {}
+    StructuralIndexer (const char* begin, const char* end) { reset(begin, end); }
+
+    void reset (const char* begin, const char* end) {
+        this->end = end;
+        nextLine  = begin;
+        masks     = { 0, 0, 0 };
+        if (begin < end) load(begin);
+    }
+
+    // Finds the next line's structural characters; returns false at the end of the buffer.
+    bool next (LineFields& fields) {
+        if (nextLine >= end) return false;
+        fields.begin = nextLine;
+        fields.dash  = nullptr;
+        size_t tabCount = 0;
+        while (true) {
+            uint64_t newline = masks.newlines & (0 - masks.newlines);  // lowest '\n' bit (0 if none)
+            uint64_t inLine  = newline ? newline - 1 : ~0ull;
+            for (uint64_t tabs = masks.tabs & inLine; tabs && tabCount < LineFields::MAX_TABS; tabs &= tabs - 1) {
+                fields.tabs[tabCount++] = block + __builtin_ctzll(tabs);
+            }
+            if (!fields.dash && (masks.dashes & inLine)) {
+                fields.dash = block + __builtin_ctzll(masks.dashes & inLine);
+            }
+            if (newline) {
+                fields.end = block + __builtin_ctzll(newline);
+                uint64_t remaining = ~(newline | inLine);
+                masks.newlines &= remaining; masks.tabs &= remaining; masks.dashes &= remaining;
+                nextLine = fields.end + 1;
+                break;
+            }
+            if (block + 64 >= end) {
+                fields.end = nextLine = end;
+                masks = { 0, 0, 0 };
+                break;
+            }
+            load(block + 64);
+        }
+        while (tabCount < LineFields::MAX_TABS) fields.tabs[tabCount++] = fields.end;
+        if (!fields.dash) fields.dash = fields.end;
+        return true;
+    }
+};
+
+#ifdef STRUCTURAL_INDEX_X86
+    #undef SI_TARGET
+#endif
+
+#endif // StructuralIndex_h
@@ -0,0 +1,60 @@
+// Programmer: Seiji Emery
+// Programmer ID: M00202623
+//
+// dvc_convert.cpp
+//
+// One-time converter: parses dvc-schedule.txt and writes the binary columnar cache (DvcCache.h)
+// that dvc_test, dvc_check and dvc_search load instead of re-parsing the text file. Re-run it
+// when the text file changes (the tools ignore a stale cache, and fall back to the text file).
+//
+// usage: dvc_convert [path-to-dvc-schedule.txt [path-to-cache]]
+//   (default cache path: <path-to-dvc-schedule.txt>.cache)
+//
+// remote source: https://github.com/SeijiEmery/comp220/blob/master/assignment_08/src/dvc_convert.cpp
+//
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include "DvcCache.h"
+
+int main (int argc, const char** argv) {
+    std::cout << "Programmer: Seiji Emery\n"
+              << "Programmer's id: M00202623\n"
+              << "File: " __FILE__ "\n\n";
+
+    const char* path = "dvc-schedule.txt";
+    std::string cachePath;
+    switch (argc) {
+        case 1: break;
+        case 2: path = argv[1]; break;
+        case 3: path = argv[1]; cachePath = argv[2]; break;
+        default: {
+            std::cerr << "usage: " << argv[0] << " [path-to-dvc-schedule.txt [path-to-cache]]" << std::endl;
+            exit(-1);
+        }
+    }
+    if (cachePath.empty()) cachePath = dvcCachePath(path);
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    std::string error;
+    if (!convertDvcToCache(path, cachePath.c_str(), error)) {
+        std::cerr << "FAILED: " << error << std::endl;
+        exit(-1);
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+
+    DvcCache cache (cachePath.c_str(), path);
+    if (!cache.valid()) {
+        std::cerr << "FAILED: wrote '" << cachePath << "', but it doesn't load: " << cache.error() << std::endl;
+        exit(-1);
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    std::cout << "Wrote '" << cachePath << "' (format version " << DVC_CACHE_VERSION << "): "
+        << cache.rows() << " sections, " << cache.subjectCount() << " subjects\n"
+        << "converted in " << std::chrono::duration<double>(t1 - t0).count() * 1e3 << " ms, "
+        << "loaded + verified in " << std::chrono::duration<double>(t2 - t1).count() * 1e3 << " ms\n";
+    return 0;
+}
@@ -14,8 +14,25 @@
 #include <string>
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
+#include <cctype>
 #include <type_traits>
-#include <ctime>
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <fcntl.h>      // open
+#include <unistd.h>     // close, sysconf, read, pipe
+#include <sys/mman.h>   // mmap, madvise
+#include <sys/stat.h>   // fstat
+#ifdef DVC_HAVE_ZLIB
+#include <zlib.h>       // inflate (InflateReader)
+#endif
 
 
 //
@@ -23,23 +40,51 @@
 //
 
 #include <DynamicArray.h>
+#include <SmallDynamicArray.h>
+#include <Allocators.h>
+#include <StringInterner.h>
+#include <Benchmark.h>
+#include "SortAlgorithms.h"
+#include "StructuralIndex.h"
+#include "DvcCache.h"
+#include <TaskScheduler.h>
 
 // Bitset data structure, used to implement a simple hashset for duplicate element removal
 // (can use perfect hashing for this data set due to its unique properties).
-class Bitset {
-    DynamicArray<size_t> array;
+template <typename Allocator = std::allocator<size_t>>
+class BasicBitset {
+    DynamicArray<size_t, Allocator> array;
     enum { BITS = 4 * sizeof(size_t) };
 public:
-    Bitset (size_t count) : array(count / BITS + 1) {}
+    BasicBitset (size_t count) : array(count / BITS + 1) {}
     void set   (size_t i) { array[i / BITS] |=  (1 << (i % BITS)); }
     void clear (size_t i) { array[i / BITS] &= ~(1 << (i % BITS)); }
     bool get   (size_t i) { return array[i / BITS] & (1 << (i % BITS)); }
+
+    // Sets every bit that is set in other. The bits that were set in both are set in common
+    // (which is cleared first); returns how many there were.
+    size_t merge (BasicBitset& other, BasicBitset& common) {
+        size_t n = other.array.size(), count = 0;
+        if (n > array.size()) array[n - 1];     // (grows the array)
+        for (auto& word : common.array) word = 0;
+        for (size_t i = 0; i < n; ++i) {
+            size_t both = array.data()[i] & other.array.data()[i];
+            array.data()[i] |= other.array.data()[i];
+            if (both) {
+                common.array[i] = both;
+                for (size_t bit = 0; bit < BITS; ++bit) count += (both & (1 << bit)) != 0;
+            }
+        }
+        return count;
+    }
     static void unittest ();
 };
+typedef BasicBitset<> Bitset;
 
 // Simple unittests for bitset (assumes that our already tested DynamicArray works properly...)
-void Bitset::unittest () {
-    Bitset bitset (10);
+template <typename Allocator>
+void BasicBitset<Allocator>::unittest () {
+    BasicBitset bitset (10);
     bitset.set(7);
     for (auto i = 0; i < 16; ++i) {
         assert(bitset.get(i) == (i == 7));
@@ -62,6 +107,12 @@ void Bitset::unittest () {
     for (auto i = (2417491 / 8) * 8; i < (2417491 / 8 + 1) * 8; ++i) {
         assert(bitset.get(i) == (i == 2417491));
     }
+
+    BasicBitset other (0), common (0);
+    other.set(31);
+    other.set(100);
+    assert(bitset.merge(other, common) == 1);
+    assert(bitset.get(100) && bitset.get(31) && common.get(31) && !common.get(100));
 }
 
 typedef size_t hash_t;
@@ -220,6 +271,52 @@ struct TracingAllocator : public IAllocator {
     }
 };
 
+// Monotonic (bump pointer) allocator: every allocation is carved out of a LinearArena, and
+// deallocate() is a no-op. Memory is released all at once when the allocator goes out of scope,
+// which suits parseLines: everything it allocates is dead by the time it returns.
+struct MonotonicAllocator : public IAllocator {
+    LinearArena arena;
+    size_t numAllocations = 0;
+
+    friend std::ostream& operator<< (std::ostream& os, const MonotonicAllocator& allocator) {
+        return os << "Allocator (monotonic):\n\t"
+            << ((double)allocator.arena.bytesAllocated() * 1e-6) << " MB allocated in " << allocator.numAllocations << " allocations, "
+            << allocator.arena.chunkCount() << " chunks\n";
+    }
+
+    void* allocate (size_t size) override {
+        ++numAllocations;
+        return arena.allocate(size);
+    }
+    void deallocate (void*) override {}
+
+    // Releases everything allocated so far (keeps the largest chunk for reuse)
+    void reset () { numAllocations = 0; arena.reset(); }
+};
+
+// Monotonic allocator over one shared arena that is reset (not freed) when the allocator goes out
+// of scope, so repeated runs (ie. benchmark iterations) reuse the same chunk instead of calling malloc.
+struct RecyclingMonotonicAllocator : public IAllocator {
+    static LinearArena& arena () {
+        static LinearArena sharedArena;
+        return sharedArena;
+    }
+    bool ownsReset = true;      // (moved-from instances must not reset the arena)
+
+    RecyclingMonotonicAllocator () = default;
+    RecyclingMonotonicAllocator (RecyclingMonotonicAllocator&& other)
+        : IAllocator(std::move(other)) { std::swap(ownsReset, other.ownsReset); other.ownsReset = false; }
+    ~RecyclingMonotonicAllocator () { if (ownsReset) arena().reset(); }
+
+    friend std::ostream& operator<< (std::ostream& os, const RecyclingMonotonicAllocator&) {
+        return os << "Allocator (recycled monotonic):\n\t"
+            << ((double)arena().bytesAllocated() * 1e-6) << " MB allocated, " << arena().chunkCount() << " chunks\n";
+    }
+
+    void* allocate (size_t size) override { return arena().allocate(size); }
+    void deallocate (void*) override {}
+};
+
 
 template <typename BaseAllocator>
 struct DefaultAllocator {
@@ -272,6 +369,12 @@ struct DefaultAllocator {
     }
 };
 
+// IAllocator::current is shared by every thread, so a pipeline that allocates (or frees) through the
+// global operator new / delete from more than one thread (parseLinesParallel's workers, the
+// InflateReader's inflate thread) can only use allocators that are safe to share between threads.
+template <typename Allocator> struct IsThreadSafeAllocator : public std::false_type {};
+template <> struct IsThreadSafeAllocator<DefaultAllocator<Mallocator>> : public std::true_type {};
+
 //
 // SUBJECT MODEL (POD)
 //
@@ -290,12 +393,15 @@ struct Subject {
     }
 };
 
-struct SubjectModel : public AIS<kSubjectModel, SubjectModel> {
+// (Allocator: which std-compatible allocator the subjects array uses)
+template <typename Allocator = std::allocator<Subject>>
+struct BasicSubjectModel : public AIS<kSubjectModel, BasicSubjectModel<Allocator>> {
     struct Instance {
-        DynamicArray<Subject> subjects;
+        DynamicArray<Subject, Allocator> subjects;
         size_t subjectCount = 0;
     };
 };
+typedef BasicSubjectModel<> SubjectModel;
 
 
 
@@ -366,6 +472,462 @@ struct CFilePreBufferedReader : public AIS<kReader, CFilePreBufferedReader> {
     };
 };
 
+// Read-only mapping of a whole file. The file is mapped over a reserved (zeroed) region one page
+// larger than the file, so that the parsers' unaligned 4 / 8 byte reads, strchr() on the last
+// line, and 64 byte SIMD scans (StructuralIndex.h) never run off the end.
+class MappedFile {
+    char*  data_ = nullptr;
+    size_t size_ = 0;
+    size_t mappedSize = 0;
+public:
+    MappedFile () {}
+    MappedFile (const char* path) {
+        int fd = open(path, O_RDONLY);
+        struct stat info;
+        if (fd >= 0 && fstat(fd, &info) == 0 && info.st_size > 0) {
+            size_t size = (size_t)info.st_size;
+            mappedSize = size + (size_t)sysconf(_SC_PAGESIZE);
+            void* region = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (region != MAP_FAILED &&
+                mmap(region, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) != MAP_FAILED)
+            {
+                madvise(region, size, MADV_SEQUENTIAL);
+                data_ = static_cast<char*>(region);
+                size_ = size;
+            } else if (region != MAP_FAILED) {
+                munmap(region, mappedSize);
+            }
+        }
+        if (fd >= 0) close(fd);     // (the mapping keeps the file open)
+    }
+    MappedFile (const MappedFile&) = delete;
+    MappedFile& operator= (const MappedFile&) = delete;
+    MappedFile (MappedFile&& other) : data_(other.data_), size_(other.size_), mappedSize(other.mappedSize) {
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+    ~MappedFile () {
+        if (data_) munmap(data_, mappedSize);
+    }
+    const char* begin () const { return data_; }
+    const char* end   () const { return data_ + size_; }
+};
+
+// Zero-copy reader: returns pointers straight into the mapped file. Lines are terminated by '\n'
+// (not '\0'; the mapping is read-only), which the parsers are fine with.
+struct MmapReader : public AIS<kReader, MmapReader> {
+    struct Instance {
+        MappedFile  file;
+        const char* begin;
+        const char* end;
+        const char* nextLine;
+    public:
+        Instance (const char* path) : file(path), begin(file.begin()), end(file.end()) { reset(); }
+        // Reads the lines in [begin, end) of a buffer that outlives the reader (eg. one chunk of a
+        // MappedFile; see parseLinesParallel)
+        Instance (const char* begin, const char* end) : begin(begin), end(end) { reset(); }
+        void reset () { nextLine = begin; }
+        operator bool () const { return nextLine < end; }
+        const char* line () {
+            const char* line = nextLine;
+            const char* eol  = static_cast<const char*>(memchr(line, '\n', end - line));
+            nextLine = eol ? eol + 1 : end;
+            return line;
+        }
+    };
+};
+
+// Same as MmapReader, but splits lines w/ StructuralIndexer: one SIMD pass over the file finds
+// the newlines + each line's tabs / first '-', which parsers w/ a parse(line, fields, result)
+// overload use instead of strchr(). (On dvc-schedule.txt this is slower than MmapReader's memchr,
+// whose lines are short enough that the extra masks cost more than the rescans save, so the
+// pipelines below default to MmapReader; this one is kept to compare against.)
+struct IndexedMmapReader : public AIS<kReader, IndexedMmapReader> {
+    struct Instance {
+        MappedFile        file;
+        const char*       begin;
+        const char*       end;
+        StructuralIndexer indexer;
+        LineFields        fields_;
+    public:
+        Instance (const char* path) : file(path), begin(file.begin()), end(file.end()) { reset(); }
+        Instance (const char* begin, const char* end) : begin(begin), end(end) { reset(); }
+        void reset () { indexer.reset(begin, end); }
+        operator bool () { return indexer.next(fields_); }
+        const char* line () const { return fields_.begin; }
+        const LineFields& fields () const { return fields_; }
+    };
+};
+
+// Streaming reader for pipes / stdin (path "-"), or any file read front to back w/ read(): uses
+// two fixed BUFFER_SIZE buffers, so memory stays constant regardless of the input size. Lines are
+// split out of the current buffer w/ memchr; a partial line at the end of the buffer is copied to
+// the start of the other buffer, and the rest of the buffer is refilled after it. The line returned
+// last stays valid across a refill (it lives in the other buffer).
+//
+// Lines are terminated by '\n' (like MmapReader), and each buffer's data is followed by 64 zero
+// bytes for the parsers' unaligned reads. Lines longer than BUFFER_SIZE are split into
+// BUFFER_SIZE pieces. reset() rewinds regular files; pipes can only be read once.
+template <size_t BUFFER_SIZE = 64 * 1024>
+struct BasicStreamReader : public AIS<kReader, BasicStreamReader<BUFFER_SIZE>> {
+    struct Instance {
+        enum { PADDING = 64 };
+        int         fd;
+        bool        ownsFd;
+        char*       buffers;        // 2 * (BUFFER_SIZE + PADDING)
+        char*       buffer;         // current buffer
+        const char* nextLine;
+        const char* end;            // end of the data in the current buffer
+        const char* line_ = nullptr;
+    public:
+        Instance (const char* path) :
+            fd(strcmp(path, "-") == 0 ? STDIN_FILENO : open(path, O_RDONLY)),
+            ownsFd(fd != STDIN_FILENO)
+        { init(); }
+        // Reads from an already open file descriptor (eg. one end of a pipe); doesn't close it
+        Instance (int fd) : fd(fd), ownsFd(false) { init(); }
+        Instance (const Instance&) = delete;
+        Instance& operator= (const Instance&) = delete;
+        Instance (Instance&& other) :
+            fd(other.fd), ownsFd(other.ownsFd), buffers(other.buffers), buffer(other.buffer),
+            nextLine(other.nextLine), end(other.end), line_(other.line_)
+        {
+            other.ownsFd  = false;
+            other.buffers = nullptr;
+        }
+        ~Instance () {
+            if (ownsFd && fd >= 0) close(fd);
+            delete[] buffers;
+        }
+        void reset () {
+            if (fd >= 0 && lseek(fd, 0, SEEK_SET) == 0) {
+                nextLine = end = buffer;
+            }
+        }
+        operator bool () {
+            while (true) {
+                if (const char* eol = static_cast<const char*>(memchr(nextLine, '\n', end - nextLine))) {
+                    line_    = nextLine;
+                    nextLine = eol + 1;
+                    return true;
+                }
+                if ((size_t)(end - nextLine) >= BUFFER_SIZE || !refill()) {
+                    // (line longer than a buffer, or the last line w/out a trailing '\n')
+                    if (nextLine == end) return false;
+                    line_    = nextLine;
+                    nextLine = end;
+                    return true;
+                }
+            }
+        }
+        const char* line () const { return line_; }
+    private:
+        void init () {
+            buffers = new char[2 * (BUFFER_SIZE + PADDING)];
+            buffer  = buffers;
+            nextLine = end = buffer;
+        }
+        // Moves the current partial line to the front of the other buffer, and reads more data
+        // after it. Returns false at the end of the input (or on a read error).
+        bool refill () {
+            char*  other = buffer == buffers ? buffers + BUFFER_SIZE + PADDING : buffers;
+            size_t tail  = (size_t)(end - nextLine);
+            ssize_t count;
+            do {
+                count = fd >= 0 ? read(fd, other + tail, BUFFER_SIZE - tail) : 0;
+            } while (count < 0 && errno == EINTR);
+            if (count <= 0) return false;
+
+            memcpy(other, nextLine, tail);
+            memset(other + tail + count, 0, PADDING);
+            buffer   = other;
+            nextLine = other;
+            end      = other + tail + count;
+            return true;
+        }
+    };
+};
+typedef BasicStreamReader<> StreamReader;
+
+#ifdef DVC_HAVE_ZLIB
+// Reads a deflate compressed file (.zip: the archive's first entry; or .gz) w/out unpacking it:
+// a second thread inflates the file into a bounded queue of BLOCK_COUNT fixed size blocks, while
+// the reader splits lines out of the blocks it has been handed (so decompression overlaps w/
+// parsing, and memory stays constant). A line straddling two blocks is copied into the CARRY
+// bytes reserved in front of the next block's data; the block holding the line returned last is
+// kept until the next block is taken. Lines are terminated by '\n', w/ 64 zero bytes after each
+// block's data (like StreamReader); lines longer than CARRY bytes are split.
+//
+// The inflate thread's buffers come from zlib (malloc), but its std::thread state is freed on that
+// thread through the global operator delete, ie. through IAllocator::current, so parseLines only
+// accepts this reader w/ a thread safe allocator + an actor that doesn't swap allocators (see
+// ReaderSpawnsThreads).
+struct InflateReader : public AIS<kReader, InflateReader> {
+    struct Instance {
+        enum { BLOCK_SIZE = 64 * 1024, BLOCK_COUNT = 4, CARRY = 4 * 1024, PADDING = 64,
+               BLOCK_STRIDE = CARRY + BLOCK_SIZE + PADDING };
+
+        // Shared w/ the inflate thread (heap allocated, so Instance stays movable)
+        struct Queue {
+            std::string             path;
+            char*                   blocks;             // BLOCK_COUNT * BLOCK_STRIDE
+            size_t                  filled[BLOCK_COUNT];
+            std::mutex              mutex;
+            std::condition_variable changed;
+            size_t                  produced = 0;       // # of blocks inflated
+            size_t                  released = 0;       // blocks [0, released) may be overwritten
+            bool                    done = false, cancelled = false, failed = false;
+            size_t                  compressedBytes = 0, uncompressedBytes = 0;
+
+            Queue (const char* path) : path(path), blocks(new char[BLOCK_COUNT * BLOCK_STRIDE]) {}
+            ~Queue () { delete[] blocks; }
+            char* data (size_t block) { return blocks + (block % BLOCK_COUNT) * BLOCK_STRIDE + CARRY; }
+        };
+        std::unique_ptr<Queue> queue;
+        std::thread            thread;
+        size_t                 consumed = 0;            // # of blocks taken by the reader
+        const char*            nextLine = nullptr;
+        const char*            end      = nullptr;
+        const char*            line_    = nullptr;
+    public:
+        Instance (const char* path) : queue(new Queue(path)) { start(); }
+        Instance (Instance&&) = default;
+        ~Instance () { stop(); }
+        void reset () { stop(); start(); }
+        operator bool () {
+            while (true) {
+                const char* eol = nextLine != end ?
+                    static_cast<const char*>(memchr(nextLine, '\n', end - nextLine)) : nullptr;
+                if (eol) {
+                    line_    = nextLine;
+                    nextLine = eol + 1;
+                    return true;
+                }
+                if ((size_t)(end - nextLine) > CARRY || !nextBlock()) {
+                    // (line longer than CARRY, or the last line w/out a trailing '\n')
+                    if (nextLine == end) return false;
+                    line_    = nextLine;
+                    nextLine = end;
+                    return true;
+                }
+            }
+        }
+        const char* line () const { return line_; }
+
+        // Stats (complete once the reader has returned false)
+        bool   failed            () const { return queue->failed; }
+        size_t compressedBytes   () const { return queue->compressedBytes; }
+        size_t uncompressedBytes () const { return queue->uncompressedBytes; }
+    private:
+        void start () {
+            Queue& q = *queue;
+            q.produced = q.released = consumed = 0;
+            q.done = q.cancelled = q.failed = false;
+            nextLine = end = line_ = nullptr;
+            thread = std::thread(&Instance::inflateAll, queue.get());
+        }
+        void stop () {
+            if (!queue) return;
+            {
+                std::lock_guard<std::mutex> lock (queue->mutex);
+                queue->cancelled = true;
+            }
+            queue->changed.notify_all();
+            if (thread.joinable()) thread.join();
+        }
+        // Takes the next inflated block, moving the current partial line in front of it.
+        // Returns false at the end of the file.
+        bool nextBlock () {
+            Queue& q = *queue;
+            {
+                std::unique_lock<std::mutex> lock (q.mutex);
+                q.changed.wait(lock, [&]() { return consumed < q.produced || q.done; });
+                if (consumed == q.produced) return false;
+                q.released = consumed ? consumed - 1 : 0;   // (keep the previous block: it has line_)
+            }
+            q.changed.notify_all();
+
+            size_t tail = (size_t)(end - nextLine);
+            char*  data = q.data(consumed);
+            if (tail) memcpy(data - tail, nextLine, tail);
+            nextLine = data - tail;
+            end      = data + q.filled[consumed % BLOCK_COUNT];
+            ++consumed;
+            return true;
+        }
+
+        // Inflate thread: parses the zip / gzip header, then inflates the file block by block
+        static void inflateAll (Queue* queue) {
+            Queue& q = *queue;
+            FILE* file = fopen(q.path.c_str(), "rb");
+            unsigned char header[30];
+            int windowBits = 0;
+            if (file && fread(header, 1, 30, file) == 30) {
+                auto u16 = [&](size_t i) { return (size_t)header[i] | (size_t)header[i + 1] << 8; };
+                if (header[0] == 'P' && header[1] == 'K' && header[2] == 3 && header[3] == 4 && u16(8) == 8) {
+                    // zip local file header: raw deflate data after the file name + extra field
+                    fseek(file, 30 + (long)u16(26) + (long)u16(28), SEEK_SET);
+                    windowBits = -MAX_WBITS;
+                } else if (header[0] == 0x1f && header[1] == 0x8b) {
+                    rewind(file);
+                    windowBits = MAX_WBITS + 16;    // (zlib parses the gzip header)
+                }
+            }
+            z_stream stream;
+            memset(&stream, 0, sizeof(stream));
+            bool ok = windowBits != 0 && inflateInit2(&stream, windowBits) == Z_OK;
+            bool streamEnd = !ok;
+            unsigned char input[64 * 1024];
+
+            for (size_t block = 0; !streamEnd; ++block) {
+                {
+                    std::unique_lock<std::mutex> lock (q.mutex);
+                    q.changed.wait(lock, [&]() { return block < q.released + BLOCK_COUNT || q.cancelled; });
+                    if (q.cancelled) break;
+                }
+                char* data = q.data(block);
+                stream.next_out  = reinterpret_cast<Bytef*>(data);
+                stream.avail_out = BLOCK_SIZE;
+                while (stream.avail_out && !streamEnd) {
+                    if (!stream.avail_in) {
+                        stream.next_in  = input;
+                        stream.avail_in = (uInt)fread(input, 1, sizeof(input), file);
+                        if (!stream.avail_in) { ok = false; streamEnd = true; break; }  // (truncated)
+                    }
+                    int status = inflate(&stream, Z_NO_FLUSH);
+                    if (status == Z_STREAM_END) streamEnd = true;
+                    else if (status != Z_OK) { ok = false; streamEnd = true; }
+                }
+                size_t size = BLOCK_SIZE - stream.avail_out;
+                memset(data + size, 0, PADDING);
+                {
+                    std::lock_guard<std::mutex> lock (q.mutex);
+                    q.filled[block % BLOCK_COUNT] = size;
+                    ++q.produced;
+                }
+                q.changed.notify_all();
+            }
+            {
+                std::lock_guard<std::mutex> lock (q.mutex);
+                q.compressedBytes   = stream.total_in;
+                q.uncompressedBytes = stream.total_out;
+                q.failed = !ok;
+                q.done   = true;
+            }
+            q.changed.notify_all();
+            if (windowBits) inflateEnd(&stream);
+            if (file) fclose(file);
+        }
+    };
+};
+#endif // DVC_HAVE_ZLIB
+
+// Checks StructuralIndexer against a naive scan, on random buffers of 0 - 300 bytes (lines
+// straddling 64 byte blocks, newlines on block boundaries, missing final newline, etc), w/ every
+// kernel this cpu supports
+void unittest_structuralIndexer () {
+    const char chars[] = "ab\t-\n";
+    char buffer[300 + 64];
+    StructuralSimdLevel best = structuralSimdLevel();
+    for (int level = 0; level <= static_cast<int>(best); ++level) {
+        structuralSimdLevel() = static_cast<StructuralSimdLevel>(level);
+        srand(220);
+        for (size_t size = 0; size <= 300; ++size) {
+            for (size_t i = 0; i < sizeof(buffer); ++i) {
+                buffer[i] = i < size ? chars[rand() % 5] : '\0';
+            }
+            StructuralIndexer indexer (&buffer[0], &buffer[size]);
+            LineFields fields;
+            for (const char* line = &buffer[0]; line < &buffer[size]; ) {
+                const char* end = line;
+                while (end < &buffer[size] && *end != '\n') ++end;
+                assert(indexer.next(fields));
+                assert(fields.begin == line && fields.end == end);
+                const char* tab = line;
+                for (size_t i = 0; i < LineFields::MAX_TABS; ++i) {
+                    while (tab < end && *tab != '\t') ++tab;
+                    assert(fields.tabs[i] == tab);
+                    if (tab < end) ++tab;
+                }
+                const char* dash = line;
+                while (dash < end && *dash != '-') ++dash;
+                assert(fields.dash == dash);
+                line = end + 1;
+            }
+            assert(!indexer.next(fields));
+        }
+    }
+    structuralSimdLevel() = best;
+}
+
+// Checks StringInterner: dense, first-seen ids; repeats (from other buffers) get the same id; find()
+// doesn't add; str() / length() round trip (incl. embedded prefixes + the empty string); and ids
+// survive the table growing well past its initial size
+void unittest_stringInterner () {
+    StringInterner interner (4);
+    assert(interner.intern("MATH") == 0);
+    assert(interner.intern("COMSC") == 1);
+    assert(interner.intern(std::string("MATH")) == 0);
+    assert(interner.intern("MATHEMATICS", 4) == 0);
+    assert(interner.intern("MATHEMATICS", 3) == 2);
+    assert(interner.intern("", 0) == 3);
+    assert(interner.find("COMSC", 5) == 1);
+    assert(interner.find("ENGL", 4) == StringInterner::NOT_FOUND);
+    assert(interner.size() == 4);
+    assert(strcmp(interner.str(2), "MAT") == 0 && interner.length(2) == 3);
+    assert(interner.str(3)[0] == '\0' && interner.length(3) == 0);
+
+    for (size_t i = 0; i < 1000; ++i) {
+        assert(interner.intern(std::to_string(i)) == i + 4);
+    }
+    for (size_t i = 0; i < 1000; ++i) {
+        std::string str = std::to_string(i);
+        assert(interner.find(str.c_str(), str.size()) == i + 4);
+        assert(str == interner.str((StringInterner::Id)(i + 4)));
+    }
+    assert(interner.intern("MATH") == 0 && interner.size() == 1004);
+    interner.clear();
+    assert(interner.size() == 0 && interner.find("MATH", 4) == StringInterner::NOT_FOUND);
+    assert(interner.intern("ENGL") == 0);
+}
+
+// Checks BasicStreamReader (w/ 16 byte buffers, so most lines straddle a refill) against the
+// lines written into a pipe: random lines of 0 - 15 chars, w/ and w/out a final newline
+void unittest_streamReader () {
+    srand(220);
+    for (size_t lineCount = 0; lineCount <= 40; ++lineCount) {
+        std::vector<std::string> lines;
+        std::string input;
+        for (size_t i = 0; i < lineCount; ++i) {
+            lines.push_back(std::string(rand() % 16, 'a' + rand() % 26));
+            input += lines.back() + '\n';
+        }
+        if (lineCount % 2 && !lines.back().empty()) input.pop_back();
+
+        // (calls w/ side effects stay outside assert(), so this still runs w/ NDEBUG)
+        int fds[2];
+        int piped = pipe(fds);
+        assert(piped == 0);
+        if (piped != 0) return;
+        ssize_t written = write(fds[1], input.data(), input.size());
+        assert(written == (ssize_t)input.size()); (void)written;
+        close(fds[1]);
+        {
+            BasicStreamReader<16>::Instance reader (fds[0]);
+            for (const auto& expected : lines) {
+                bool more = reader;
+                assert(more); (void)more;
+                const char* line = reader.line();
+                assert(strncmp(line, expected.c_str(), expected.size()) == 0);
+                assert(line[expected.size()] == '\n' || line[expected.size()] == '\0'); (void)line;
+            }
+            bool more = reader;
+            assert(!more); (void)more;
+        }
+        close(fds[0]);
+    }
+}
+
 // Mock version, that:
 // - does no I/O
 // - generates fixed # of lines
@@ -431,6 +993,15 @@ struct FakeRandomReader : public AIS<kReader, FakeRandomReader> {
 
 //#define parent (static_cast<typename Reader::Instance*>(this))
 
+struct ParseResult;     // (forwarded by Take / Skip / Repeat for pre-parsed readers, see CacheReader)
+
+// Moves reader past its current line: skip() for readers that have one (pre-parsed readers, whose
+// line() doesn't advance), else line()
+template <typename Reader>
+auto skipLine (Reader& reader, int) -> decltype(reader.skip()) { return reader.skip(); }
+template <typename Reader>
+void skipLine (Reader& reader, long) { reader.line(); }
+
 template <size_t COUNT, typename Reader>
 struct Take : public AIS<kReader, Take<COUNT, Reader>> {
     struct Instance /*: public Reader::Instance*/ {
@@ -441,6 +1012,12 @@ struct Take : public AIS<kReader, Take<COUNT, Reader>> {
         void reset () { count = (int)COUNT; next.reset(); }
         operator bool () { return bool(next) && count --> 0; }
         const char* line () { return next.line(); }
+        template <typename R = typename Reader::Instance>
+        auto fields () -> decltype(std::declval<R&>().fields()) { return next.fields(); }
+        template <typename R = typename Reader::Instance>
+        auto parse (ParseResult& result) -> decltype(std::declval<R&>().parse(result)) { return next.parse(result); }
+        template <typename R = typename Reader::Instance>
+        auto skip () -> decltype(std::declval<R&>().skip()) { return next.skip(); }
 
         //Instance (const char* path) : Reader::Instance(path) {}
         //void reset () { count = (int)COUNT; parent->reset(); }
@@ -458,11 +1035,17 @@ struct Skip : public AIS<kReader, Skip<COUNT, Reader>> {
         void reset () { next.reset(); skipN(); }
         operator bool () { return bool(next); }
         const char* line () { return next.line(); }
+        template <typename R = typename Reader::Instance>
+        auto fields () -> decltype(std::declval<R&>().fields()) { return next.fields(); }
+        template <typename R = typename Reader::Instance>
+        auto parse (ParseResult& result) -> decltype(std::declval<R&>().parse(result)) { return next.parse(result); }
+        template <typename R = typename Reader::Instance>
+        auto skip () -> decltype(std::declval<R&>().skip()) { return next.skip(); }
         //Instance (const char* path) : Reader::Instance(path) { skipN(); }
         //void reset () { parent->reset(); skipN(); }
     private:
         void skipN () {
-            for (auto i = COUNT; i --> 0 && bool(*this); ) { this->line(); }
+            for (auto i = COUNT; i --> 0 && bool(*this); ) { skipLine(next, 0); }
         }
     };
 };
@@ -479,6 +1062,12 @@ struct Repeat : public AIS<kReader, Repeat<Reader>> {
             return true;
         }
         const char* line () { return next.line(); }
+        template <typename R = typename Reader::Instance>
+        auto fields () -> decltype(std::declval<R&>().fields()) { return next.fields(); }
+        template <typename R = typename Reader::Instance>
+        auto parse (ParseResult& result) -> decltype(std::declval<R&>().parse(result)) { return next.parse(result); }
+        template <typename R = typename Reader::Instance>
+        auto skip () -> decltype(std::declval<R&>().skip()) { return next.skip(); }
 
         //Instance (const char* path) : Reader::Instance(path) {}
         //operator bool () {
@@ -492,6 +1081,25 @@ struct Repeat : public AIS<kReader, Repeat<Reader>> {
 
 #undef parent
 
+// Readers whose lines stay valid after the next line() call (until the reader is destroyed), so a
+// batch of them can be parsed at once (parseLinesBatched)
+template <typename Reader> struct HasStableLines : public std::false_type {};
+template <> struct HasStableLines<MmapReader>             : public std::true_type {};
+template <> struct HasStableLines<IndexedMmapReader>      : public std::true_type {};
+template <> struct HasStableLines<CFilePreBufferedReader> : public std::true_type {};
+template <> struct HasStableLines<FakeReader>             : public std::true_type {};
+template <size_t COUNT, typename Reader> struct HasStableLines<Take<COUNT, Reader>> : public HasStableLines<Reader> {};
+template <size_t COUNT, typename Reader> struct HasStableLines<Skip<COUNT, Reader>> : public HasStableLines<Reader> {};
+
+// Readers that run a thread of their own, which frees memory through the global operator delete
+// while the pipeline runs (see IsThreadSafeAllocator)
+template <typename Reader> struct ReaderSpawnsThreads : public std::false_type {};
+#ifdef DVC_HAVE_ZLIB
+template <> struct ReaderSpawnsThreads<InflateReader> : public std::true_type {};
+#endif
+template <size_t COUNT, typename Reader> struct ReaderSpawnsThreads<Take<COUNT, Reader>> : public ReaderSpawnsThreads<Reader> {};
+template <size_t COUNT, typename Reader> struct ReaderSpawnsThreads<Skip<COUNT, Reader>> : public ReaderSpawnsThreads<Reader> {};
+
 
 
 
@@ -510,6 +1118,34 @@ struct ParseResult {
     }
 };
 
+// Structure of arrays batch of up to SIZE lines, for parseLinesBatched: the reader fills in line[]
+// (+ subjectEnd[], if it indexes its lines), the parser turns those into hash[], subjectPtr[] +
+// subjectLength[], and the filterer drops the entries it rejects. Stages keep their surviving
+// entries at the front, in order, and update count.
+struct ParseBatch {
+    enum { SIZE = 1024 };
+    size_t      count = 0;
+    const char* line          [SIZE];
+    const char* subjectEnd    [SIZE];   // (where the line's subject ends, or nullptr)
+    hash_t      hash          [SIZE];
+    const char* subjectPtr    [SIZE];
+    size_t      subjectLength [SIZE];
+
+    void set (size_t i, const ParseResult& result) {
+        line[i]          = result.line;
+        hash[i]          = result.courseHash;
+        subjectPtr[i]    = result.subjectStr.start();
+        subjectLength[i] = result.subjectStr.size();
+    }
+    ParseResult get (size_t i) const {
+        ParseResult result;
+        result.line       = line[i];
+        result.courseHash = hash[i];
+        result.subjectStr = { subjectPtr[i], subjectLength[i] };
+        return result;
+    }
+};
+
 // Utility macro: assembles a 32-bit integer out of 4 characters / bytes.
 // Assumes little endian, won't work on PPC / ARM (would just need to swap order).
 // This is useful b/c we can replace strcmp() for very small, fixed strings
@@ -523,7 +1159,14 @@ struct ParseResult {
 // will run much faster but behavior is... somewhat undefined.
 struct FastParser : public AIS<kParser, FastParser> {
     struct Instance {
-        bool parse (const char* line, ParseResult& result) {
+        bool parse (const char* line, ParseResult& result) { return parse(line, nullptr, result); }
+
+        // w/ a structural index (IndexedMmapReader): the subject ends at the line's first '-'
+        bool parse (const char* line, const LineFields& fields, ParseResult& result) {
+            return parse(line, fields.dash, result);
+        }
+
+        bool parse (const char* line, const char* subjectEnd, ParseResult& result) {
             result.line = line;
             size_t semester = 0;
             switch (((uint32_t*)line)[0]) {
@@ -533,17 +1176,17 @@ struct FastParser : public AIS<kParser, FastParser> {
                 case PACK_STR_4('W','i','n','t'): assert((((uint32_t*)line)[1] & 0x00FFFFFF) == PACK_STR_4('e','r',' ','\0')); line += 7; semester = 3; break;
                 default: return false;
             }
-            assert(isnumber(line[0]) && line[4] == '\t');
+            assert(isdigit(line[0]) && line[4] == '\t');
             result.courseHash = semester | (((atoi(line) - 2000) & 31) << 2);
             line += 5;
 
-            assert(isnumber(line[0]) && line[4] == '\t');
+            assert(isdigit(line[0]) && line[4] == '\t');
             size_t code = atoi(line);
             result.courseHash |= (code << 8);
             line += 5;
 
             assert(isupper(line[0]));
-            const char* end = strchr(line, '-');
+            const char* end = subjectEnd ? subjectEnd : strchr(line, '-');
             assert(end != nullptr && end != line);
             result.subjectStr = { line, (size_t)(end - line) };
             return true;
@@ -580,7 +1223,14 @@ void unittest_4atoi () {
 // we need to - without I/O, this can parse 100k lines of text in ~5ms)
 struct EvenFasterParser : public AIS<kParser, EvenFasterParser> {
     struct Instance {
-        bool parse (const char* line, ParseResult& result) {
+        bool parse (const char* line, ParseResult& result) { return parse(line, nullptr, result); }
+
+        // w/ a structural index (IndexedMmapReader): the subject ends at the line's first '-'
+        bool parse (const char* line, const LineFields& fields, ParseResult& result) {
+            return parse(line, fields.dash, result);
+        }
+
+        bool parse (const char* line, const char* subjectEnd, ParseResult& result) {
             result.line = line;
             size_t semester = 0;
             switch (((uint32_t*)line)[0]) {
@@ -590,21 +1240,34 @@ struct EvenFasterParser : public AIS<kParser, EvenFasterParser> {
                 case PACK_STR_4('W','i','n','t'): assert((((uint32_t*)line)[1] & 0x00FFFFFF) == PACK_STR_4('e','r',' ','\0')); line += 7; semester = 3; break;
                 default: return false;
             }
-            assert(isnumber(line[0]) && line[4] == '\t');
+            assert(isdigit(line[0]) && line[4] == '\t');
             result.courseHash = semester | (((_4atoi(line) - 2000) & 31) << 2);
             line += 5;
 
-            assert(isnumber(line[0]) && line[4] == '\t');
+            assert(isdigit(line[0]) && line[4] == '\t');
             size_t code = _4atoi(line);
             result.courseHash |= (code << 8);
             line += 5;
 
             assert(isupper(line[0]));
-            const char* end = strchr(line, '-');
+            const char* end = subjectEnd ? subjectEnd : strchr(line, '-');
             assert(end != nullptr && end != line);
             result.subjectStr = { line, (size_t)(end - line) };
             return true;
         }
+
+        // Parses every line in batch (w/ its subjectEnd, if the reader set it), dropping the ones
+        // that aren't sections
+        void parseBatch (ParseBatch& batch) {
+            ParseResult result;
+            size_t count = 0;
+            for (size_t i = 0; i < batch.count; ++i) {
+                if (parse(batch.line[i], batch.subjectEnd[i], result)) {
+                    batch.set(count++, result);
+                }
+            }
+            batch.count = count;
+        }
     };
 };
 
@@ -617,18 +1280,88 @@ struct NoParser : public AIS<kParser, NoParser> {
 
 #undef PACK_STR_4
 
+// Reads pre-parsed rows from the binary columnar cache of the file (DvcCache.h; <path>.cache,
+// written by dvc_convert) instead of its text: parse() fills in each ParseResult straight from
+// the columns, so the pipeline's Parser is never called (see parseNextLine). Reads no rows if the
+// cache is missing / stale / corrupt (check cacheError() or DvcCache::valid() first).
+// The cache doesn't keep the text lines, so line() (+ result.line, LinearFilter's key) is the row's
+// text line up to + including its course ("Fall 2016\t1234\tCOMSC-165"), rebuilt from the columns;
+// the rest of the line (instructor, times + room) isn't cached. line() doesn't advance (use skip()).
+// LINE_KEYS = false skips rebuilding result.line in parse() (it's left null), which is most of the
+// cost of a cached row: only use that w/ filterers that key on courseHash (not LinearFilter).
+template <bool LINE_KEYS = true>
+struct BasicCacheReader : public AIS<kReader, BasicCacheReader<LINE_KEYS>> {
+    struct Instance {
+        std::unique_ptr<DvcCache>       cache;
+        std::vector<Slice<const char*>> subjectNames;   // (by subject id)
+        size_t row = 0, rows = 0;
+        std::string key;                                // (line())
+    public:
+        Instance (const char* path) : cache(new DvcCache(dvcCachePath(path).c_str(), path)) {
+            if (!cache->valid()) return;
+            rows = cache->rows();
+            for (size_t id = 0; id < cache->subjectCount(); ++id) {
+                const char* name = cache->subjectName(id);
+                subjectNames.push_back({ name, strlen(name) });
+            }
+        }
+        const char* cacheError () const { return cache->error(); }
+        void reset () { row = 0; }
+        operator bool () const { return row < rows; }
+        void skip () { ++row; }
+        const char* line () {
+            static const Slice<const char*> seasons[4] = { { "Spring ", 7 }, { "Summer ", 7 }, { "Fall ", 5 }, { "Winter ", 7 } };
+            uint8_t date = cache->dates()[row];
+            const Slice<const char*>& season  = seasons[date & 0x3];
+            const Slice<const char*>& subject = subjectNames[cache->subjects()[row]];
+            const char* number = cache->string(cache->courseNumbers()[row]);
+            size_t numberLength = strlen(number);
+
+            // (sized once + written in place: this runs for every row)
+            key.resize(season.size() + 10 + subject.size() + 1 + numberLength);
+            char* out = &key[0];
+            auto write4 = [&](unsigned n) {     // (4 digits, zero padded)
+                out[0] = char('0' + n / 1000 % 10); out[1] = char('0' + n / 100 % 10);
+                out[2] = char('0' + n / 10 % 10);   out[3] = char('0' + n % 10);
+                out += 4;
+            };
+            memcpy(out, season.start(), season.size()); out += season.size();
+            write4(2000 + (date >> 2));
+            *out++ = '\t';
+            write4(cache->sections()[row]);
+            *out++ = '\t';
+            memcpy(out, subject.start(), subject.size()); out += subject.size();
+            *out++ = '-';
+            memcpy(out, number, numberLength);
+            return key.c_str();
+        }
+        bool parse (ParseResult& result) {
+            // (same hash as the text parsers: season | year:5 << 2 | section << 8)
+            result.courseHash = (cache->dates()[row] & 0x7F) | (hash_t)cache->sections()[row] << 8;
+            result.subjectStr = subjectNames[cache->subjects()[row]];
+            result.line       = LINE_KEYS ? line() : nullptr;
+            skip();
+            return true;
+        }
+    };
+};
+typedef BasicCacheReader<> CacheReader;
+
 
 //
 // FILTERING ALGORITHMS
 //
 
-struct HashedCourseFilterer : public AIS<kFilterer, HashedCourseFilterer> {
+// (Allocator: which std-compatible allocator the hashset uses)
+template <typename Allocator = std::allocator<size_t>>
+struct BasicHashedCourseFilterer : public AIS<kFilterer, BasicHashedCourseFilterer<Allocator>> {
     struct Instance {
-        Bitset hashset;
+        BasicBitset<Allocator> hashset;
+        BasicBitset<Allocator> mergeDuplicates;
         size_t dupCount    = 0;
         size_t uniqueCount = 0;
     public:
-        Instance () : hashset(0) {}
+        Instance () : hashset(0), mergeDuplicates(0) {}
         template <typename SubjectModel>
         bool filter (const ParseResult& result, SubjectModel& model) {
             if (hashset.get(result.courseHash)) {
@@ -640,24 +1373,56 @@ struct HashedCourseFilterer : public AIS<kFilterer, HashedCourseFilterer> {
                 return true;
             }
         }
+        template <typename SubjectModel>
+        void filterBatch (ParseBatch& batch, SubjectModel&) {
+            size_t count = 0;
+            for (size_t i = 0; i < batch.count; ++i) {
+                hash_t hash = batch.hash[i];
+                if (!hashset.get(hash)) {
+                    hashset.set(hash);
+                    batch.line[count]          = batch.line[i];
+                    batch.hash[count]          = hash;
+                    batch.subjectPtr[count]    = batch.subjectPtr[i];
+                    batch.subjectLength[count] = batch.subjectLength[i];
+                    ++count;
+                }
+            }
+            dupCount    += batch.count - count;
+            uniqueCount += count;
+            batch.count  = count;
+        }
+
+        // Parallel merge (parseLinesParallel): adds the courses other (run over a later chunk) has
+        // seen. Returns the # of courses both had seen, ie. lines other accepted that are duplicates
+        // of earlier chunks' lines; isMergeDuplicate() identifies those lines (until the next merge).
+        size_t merge (Instance& other) {
+            size_t duplicates = hashset.merge(other.hashset, mergeDuplicates);
+            dupCount    += other.dupCount + duplicates;
+            uniqueCount += other.uniqueCount - duplicates;
+            return duplicates;
+        }
+        bool isMergeDuplicate (const ParseResult& result) { return mergeDuplicates.get(result.courseHash); }
     };
 };
+typedef BasicHashedCourseFilterer<> HashedCourseFilterer;
 
 // Purely for awfulness sake...
 struct LinearFilter : public AIS<kFilterer, LinearFilter> {
     struct Instance {
-        DynamicArray<std::string> keys;
+        SmallDynamicArray<std::string, 16> keys;
         size_t back = 0;
     public:
-        Instance () : keys(0) {}
+        Instance () {}
         template <typename SubjectModel>
         bool filter (const ParseResult& result, SubjectModel& model) {
+            // compare up to the end of line (readers may or may not '\0'-terminate lines)
+            size_t length = strcspn(result.line, "\n");
             for (auto i = back; i --> 0; ) {
-                if (keys[i] == result.line) {
+                if (keys[i].compare(0, std::string::npos, result.line, length) == 0) {
                     return false;
                 }
             }
-            keys[back++] = result.line;
+            keys[back++].assign(result.line, length);
             return true;
         }
     };
@@ -668,6 +1433,9 @@ struct NoCourseFilter : public AIS<kFilterer, NoCourseFilter> {
         template <typename SubjectModel> bool filter (const ParseResult& result, SubjectModel& model) {
             return true;
         }
+        template <typename SubjectModel> void filterBatch (ParseBatch&, SubjectModel&) {}
+        size_t merge (Instance&) { return 0; }
+        bool isMergeDuplicate (const ParseResult&) { return false; }
     };
 };
 
@@ -690,31 +1458,103 @@ template <size_t HASHTABLE_SIZE = 1024, typename Hash = DefaultHash>
 struct HashedSubjectCounter : public AIS<kCounter, HashedSubjectCounter<HASHTABLE_SIZE, Hash>> {
     struct Instance {
     private:
-        bool emptyHash (DynamicArray<Subject>& subjects, size_t hash) const { 
+        // (for merge(): index of the insert that created each slot)
+        size_t insertCount = 0;
+        size_t firstInsert[HASHTABLE_SIZE] = {};
+
+        template <typename Subjects>
+        bool emptyHash (Subjects& subjects, size_t hash) const { 
             return subjects[hash].count == 0; 
         }
-        bool hashEq    (DynamicArray<Subject>& subjects, size_t hash, const Slice<const char*>& key) const {
+        template <typename Subjects>
+        bool hashEq    (Subjects& subjects, size_t hash, const Slice<const char*>& key) const {
             return strncmp(subjects[hash].name.c_str(), key.start(), key.size()) == 0;
         }
-    public:
+        // Adds count to subject's entry (creating it if needed); returns its slot
         template <typename SubjectModel>
-        void insert (SubjectModel& model, const ParseResult& result) {
-            const auto& subject = result.subjectStr;
+        size_t add (SubjectModel& model, const Slice<const char*>& subject, size_t count) {
             size_t subjectHash = Hash::hashString((const uint8_t*)(subject.start()), subject.size());
             subjectHash %= HASHTABLE_SIZE;
             if (emptyHash(model.subjects, subjectHash)) {
-                model.subjects[subjectHash] = { subject.str(), 1, subjectHash };
+                model.subjects[subjectHash] = { subject.str(), count, subjectHash };
             } else {
                 while (!hashEq(model.subjects, subjectHash, subject)) {
                     subjectHash = (subjectHash + 1) % HASHTABLE_SIZE;
                     if (emptyHash(model.subjects, subjectHash)) {
-                        model.subjects[subjectHash] = { subject.str(), 1, subjectHash };
-                        return;
+                        model.subjects[subjectHash] = { subject.str(), count, subjectHash };
+                        return subjectHash;
                     }
                 }
-                ++model.subjects[subjectHash].count;
+                model.subjects[subjectHash].count += count;
+            }
+            return subjectHash;
+        }
+        // Slot of an existing subject (probes by name, so it works for counts that were reduced to 0)
+        template <typename SubjectModel>
+        size_t find (SubjectModel& model, const Slice<const char*>& subject) const {
+            size_t subjectHash = Hash::hashString((const uint8_t*)(subject.start()), subject.size());
+            subjectHash %= HASHTABLE_SIZE;
+            while (!hashEq(model.subjects, subjectHash, subject)) {
+                assert(!model.subjects[subjectHash].name.empty());
+                subjectHash = (subjectHash + 1) % HASHTABLE_SIZE;
+            }
+            return subjectHash;
+        }
+        template <typename SubjectModel>
+        void insert (SubjectModel& model, const Slice<const char*>& subject) {
+            size_t slot = add(model, subject, 1);
+            if (model.subjects[slot].count == 1) {
+                firstInsert[slot] = insertCount;
+            }
+            ++insertCount;
+        }
+    public:
+        template <typename SubjectModel>
+        void insert (SubjectModel& model, const ParseResult& result) {
+            insert(model, result.subjectStr);
+        }
+        template <typename SubjectModel>
+        void insertBatch (SubjectModel& model, const ParseBatch& batch) {
+            for (size_t i = 0; i < batch.count; ++i) {
+                insert(model, { batch.subjectPtr[i], batch.subjectLength[i] });
+            }
+        }
+
+        // Parallel merge (parseLinesParallel): adds what other counted (into from, over a later chunk
+        // of the file) to model. rejected: the indices (ascending) of other's inserts that turned out
+        // to be duplicates of earlier chunks; inserted[k]: the result of other's k-th insert (only
+        // used if rejected isn't empty). Subjects are added in the order of their first surviving
+        // insert, so model's table ends up exactly as if one instance had counted everything.
+        template <typename SubjectModel, typename OtherModel, typename Inserted>
+        void merge (SubjectModel& model, OtherModel& from, const Instance& other,
+                    const std::vector<size_t>& rejected, Inserted& inserted)
+        {
+            size_t counts[HASHTABLE_SIZE], firsts[HASHTABLE_SIZE], order[HASHTABLE_SIZE], n = 0;
+            for (size_t i = 0; i < HASHTABLE_SIZE; ++i) {
+                counts[i] = emptyHash(from.subjects, i) ? 0 : from.subjects[i].count;
+                firsts[i] = other.firstInsert[i];
+            }
+            auto isRejected = [&](size_t k) { return std::binary_search(rejected.begin(), rejected.end(), k); };
+            for (size_t k : rejected) {
+                --counts[other.find(from, inserted[k].subjectStr)];
+            }
+            for (size_t k : rejected) {
+                size_t slot = other.find(from, inserted[k].subjectStr);
+                if (counts[slot] && firsts[slot] == k) {    // first insert was a duplicate: use the next surviving one
+                    do { ++firsts[slot]; } while (isRejected(firsts[slot]) ||
+                        other.find(from, inserted[firsts[slot]].subjectStr) != slot);
+                }
+            }
+            for (size_t i = 0; i < HASHTABLE_SIZE; ++i) {
+                if (counts[i]) order[n++] = i;
+            }
+            std::sort(&order[0], &order[n], [&](size_t a, size_t b) { return firsts[a] < firsts[b]; });
+            for (size_t i = 0; i < n; ++i) {
+                const Subject& subject = from.subjects[order[i]];
+                add(model, { subject.name.c_str(), subject.name.size() }, counts[order[i]]);
             }
         }
+
         template <typename SubjectModel>
         void finalize (SubjectModel& model) {
             model.subjectCount = 0;
@@ -731,10 +1571,50 @@ struct HashedSubjectCounter : public AIS<kCounter, HashedSubjectCounter<HASHTABL
     };
 };
 
+// Counts subjects by interned id (StringInterner.h): each insert is one interner lookup + an array
+// increment, and a subject's name is only copied (once, into the interner's arena) the first time
+// it's seen; the subject model is built from the counts in finalize(). Subjects end up in
+// first-seen order, w/ hashid = their id. (serial only: no merge() for parseLinesParallel)
+struct InternedSubjectCounter : public AIS<kCounter, InternedSubjectCounter> {
+    struct Instance {
+        StringInterner      subjects;
+        std::vector<size_t> counts;     // by id
+
+        template <typename SubjectModel>
+        void insert (SubjectModel&, const ParseResult& result) {
+            StringInterner::Id id = subjects.intern(result.subjectStr.start(), result.subjectStr.size());
+            if (id == counts.size()) counts.push_back(0);
+            ++counts[id];
+        }
+        template <typename SubjectModel>
+        void insertBatch (SubjectModel&, const ParseBatch& batch) {
+            for (size_t i = 0; i < batch.count; ++i) {
+                StringInterner::Id id = subjects.intern(batch.subjectPtr[i], batch.subjectLength[i]);
+                if (id == counts.size()) counts.push_back(0);
+                ++counts[id];
+            }
+        }
+
+        template <typename SubjectModel>
+        void finalize (SubjectModel& model) {
+            model.subjectCount = subjects.size();
+            for (StringInterner::Id id = 0; id < subjects.size(); ++id) {
+                model.subjects[id] = { std::string(subjects.str(id), subjects.length(id)), counts[id], id };
+            }
+        }
+        size_t memoryUsed () const { return subjects.memoryUsed() + counts.capacity() * sizeof(size_t); }
+    };
+};
+
 struct NoSubjectCounter : public AIS<kCounter, NoSubjectCounter> {
     struct Instance {
         template <typename SubjectModel>
         void insert (SubjectModel& model, const ParseResult& result) {}
+        template <typename SubjectModel>
+        void insertBatch (SubjectModel&, const ParseBatch&) {}
+
+        template <typename SubjectModel, typename OtherModel, typename Inserted>
+        void merge (SubjectModel&, OtherModel&, const Instance&, const std::vector<size_t>&, Inserted&) {}
 
         template <typename SubjectModel>
         void finalize (SubjectModel& model) {}
@@ -755,14 +1635,9 @@ struct BubbleSort : public AIS<kSorter, BubbleSort> {
             sort(&model.subjects[0], &model.subjects[model.subjectCount]);
         }
         void sort (Subject* front, Subject* back) {
-            for (; front != back; ++front) {
-                for (auto second = front; second != back; ++second) {
-                    if (front->name > second->name) {
-                        std::swap(*front, *second);
-                        ++swapCount;
-                    }
-                }
-            }
+            exchangeSort(front, back, [](const Subject& a, const Subject& b) {
+                return a.name > b.name;
+            }, swapCount);
         }
     };
 };
@@ -782,8 +1657,26 @@ struct NoSort : public AIS<kSorter, NoSort> {
 struct Actor {
     template <typename Instance> void enter (const Instance& instance) {}
     template <typename Instance> void exit  (const Instance& instance) {}
+
+    // Bracket each call parseLines makes into a pipeline stage (tag: kReader, kParser, kFilterer,
+    // kCounter, kSorter); see actorStage(). No-ops here, so they inline away for every actor that
+    // doesn't override them (NoDisplay, DisplayToCout, ...)
+    template <int tag> void enterStage () {}
+    template <int tag> void exitStage  () {}
 };
 
+// Runs fcn() as part of stage tag (w/ actor.enterStage<tag>() / exitStage<tag>() around it), and
+// returns its result
+template <int tag, typename Actor, typename F>
+auto actorStage (Actor& actor, F fcn) -> decltype(fcn()) {
+    struct Scope {
+        Actor& actor;
+        Scope (Actor& actor) : actor(actor) { actor.template enterStage<tag>(); }
+        ~Scope () { actor.template exitStage<tag>(); }
+    } scope (actor);
+    return fcn();
+}
+
 #define ACT(tag, action) \
     template <template<int, typename...> class Instance, typename... Args> \
     struct s_##action<Instance<tag, Args...>> { static void exec (const Instance<tag, Args...>& instance)
@@ -828,6 +1721,155 @@ struct NoDisplay : public Actor {
     }};
 };
 
+// Records the final subject model (as text), so that runs w/ different algorithms can be checked
+// against each other
+struct CaptureSubjects : public Actor {
+    static std::string& output () {
+        static std::string text;
+        return text;
+    }
+    IMPLEMENT_ACTOR_EVENT(exit)
+    ACT(kSubjectModel, exit) {
+        std::string& text = output();
+        text.clear();
+        for (size_t i = 0, n = instance.subjectCount; i < n; ++i) {
+            const Subject& subject = instance.subjects[i];
+            text += subject.name + ' ' + std::to_string(subject.count) + ' ' + std::to_string(subject.hashid) + '\n';
+        }
+    }};
+};
+
+// Per-stage profile of parseLines: times every call into each stage (actorStage: reading a line,
+// parsing it, filtering it, counting it, finalizing + sorting; opening the file counts as reading)
+// w/ the high resolution clock, and counts what each stage allocates through operator new. Each
+// run's numbers are added to totals() when the actor is destroyed, so a profile can be averaged
+// over benchmark() iterations; report() prints it as a table. (readers that only read a line once
+// it's asked for, in line(), like IfstreamReader, show up as parsing time)
+//
+// Timing a call costs ~1 clock read that lands inside the measured interval; report() subtracts
+// that (calibrated) bias, but a profiled run is still slower overall than one w/ NoDisplay.
+struct ProfilingActor : public Actor {
+    enum { STAGE_COUNT = kSorter + 1 };
+    typedef std::chrono::high_resolution_clock Clock;
+
+    struct Stage {
+        double ms = 0;
+        size_t calls = 0, allocations = 0, bytes = 0;
+    };
+    struct Profile {
+        Stage  stages[STAGE_COUNT];
+        size_t runs = 0;
+    };
+    static Profile& totals () {
+        static Profile profile;
+        return profile;
+    }
+    static void reset () { totals() = Profile(); }
+
+private:
+    // Counts allocations + forwards them to the allocator that was current when the stage began.
+    // Only installed (as IAllocator::current) while a stage runs.
+    struct CountingAllocator : public IAllocator {
+        IAllocator* target = nullptr;
+        size_t allocations = 0, bytes = 0;
+
+        CountingAllocator () { current = prev; }
+        void* allocate (size_t size) override {
+            ++allocations;
+            bytes += size;
+            return target->allocate(size);
+        }
+        void deallocate (void* ptr) override { target->deallocate(ptr); }
+    };
+    CountingAllocator counting;
+    Stage             stages[STAGE_COUNT];
+    Clock::time_point start;
+
+    // Average ms between 2 consecutive clock reads (ie. what timing an empty stage measures)
+    static double clockBias () {
+        static double bias = -1;
+        if (bias < 0) {
+            enum { SAMPLES = 100000 };
+            double total = 0;
+            for (size_t i = 0; i < SAMPLES; ++i) {
+                auto t0 = Clock::now();
+                auto t1 = Clock::now();
+                total += std::chrono::duration<double, std::milli>(t1 - t0).count();
+            }
+            bias = total / SAMPLES;
+        }
+        return bias;
+    }
+public:
+    // (stages don't nest)
+    template <int tag> void enterStage () {
+        counting.target = IAllocator::current;
+        IAllocator::current = &counting;
+        start = Clock::now();
+    }
+    template <int tag> void exitStage () {
+        auto end = Clock::now();
+        IAllocator::current = counting.target;
+        Stage& stage = stages[tag];
+        stage.ms += std::chrono::duration<double, std::milli>(end - start).count();
+        ++stage.calls;
+        stage.allocations += counting.allocations;
+        stage.bytes       += counting.bytes;
+        counting.allocations = counting.bytes = 0;
+    }
+    ~ProfilingActor () {
+        Profile& profile = totals();
+        for (size_t i = 0; i < STAGE_COUNT; ++i) {
+            profile.stages[i].ms          += stages[i].ms;
+            profile.stages[i].calls       += stages[i].calls;
+            profile.stages[i].allocations += stages[i].allocations;
+            profile.stages[i].bytes       += stages[i].bytes;
+        }
+        ++profile.runs;
+    }
+
+    // Per run averages of totals(), by stage (in pipeline order)
+    static void report (std::ostream& os) {
+        static const struct { int tag; const char* name; } order[] = {
+            { kReader, "reader" }, { kParser, "parser" }, { kFilterer, "filterer" },
+            { kCounter, "counter" }, { kSorter, "sorter" }
+        };
+        const Profile& profile = totals();
+        size_t runs = std::max(profile.runs, (size_t)1);
+        double ms[STAGE_COUNT], total = 0;
+        for (const auto& stage : order) {
+            const Stage& s = profile.stages[stage.tag];
+            ms[stage.tag] = std::max(s.ms - s.calls * clockBias(), 0.0) / runs;
+            total += ms[stage.tag];
+        }
+        std::ios::fmtflags flags = os.flags();
+        std::streamsize precision = os.precision();
+        os << std::fixed
+           << "  stage      ms / run  % time  calls / run  ns / call  allocations / run  bytes / run\n";
+        for (const auto& stage : order) {
+            const Stage& s = profile.stages[stage.tag];
+            double calls = (double)s.calls / runs;
+            os << "  " << std::left << std::setw(9) << stage.name << std::right
+               << std::setprecision(3) << std::setw(9) << ms[stage.tag]
+               << std::setprecision(1) << std::setw(8) << (total > 0 ? ms[stage.tag] / total * 100 : 0)
+               << std::setprecision(0) << std::setw(13) << calls
+               << std::setprecision(1) << std::setw(11) << (calls > 0 ? ms[stage.tag] / calls * 1e6 : 0)
+               << std::setprecision(0) << std::setw(19) << (double)s.allocations / runs
+               << std::setw(13) << (double)s.bytes / runs << '\n';
+        }
+        os << "  " << std::left << std::setw(9) << "total" << std::right << std::setprecision(3) << std::setw(9) << total
+           << "  (over " << profile.runs << " runs; " << std::setprecision(1) << clockBias() * 1e6
+           << " ns / call clock bias subtracted)\n";
+        os.flags(flags);
+        os.precision(precision);
+    }
+};
+
+// Actors that swap IAllocator::current while a stage runs (ProfilingActor's CountingAllocator), so
+// memory freed from another thread meanwhile would go through the wrong allocator
+template <typename Actor> struct SwapsAllocator : public std::false_type {};
+template <> struct SwapsAllocator<ProfilingActor> : public std::true_type {};
+
 #undef ACT
 #undef ACT_all
 #undef IMPLEMENT_ACTOR_EVENT
@@ -838,6 +1880,101 @@ struct NoDisplay : public Actor {
 // FULL PROGRAM IMPLEMENTATION
 //
 
+// Parses the reader's next line. Readers that index lines as they split them (IndexedMmapReader)
+// hand their LineFields to parsers that accept them; everything else uses parse(line, result).
+template <typename Parser, typename Reader>
+auto parseNextLine (Parser& parser, Reader& reader, ParseResult& result, int)
+    -> decltype(parser.parse(reader.line(), reader.fields(), result))
+{
+    const char* line = reader.line();
+    return parser.parse(line, reader.fields(), result);
+}
+// Readers of pre-parsed rows (CacheReader) fill in the result themselves.
+template <typename Parser, typename Reader>
+auto parseNextLine (Parser&, Reader& reader, ParseResult& result, int)
+    -> decltype(reader.parse(result))
+{
+    return reader.parse(result);
+}
+template <typename Parser, typename Reader>
+bool parseNextLine (Parser& parser, Reader& reader, ParseResult& result, long) {
+    return parser.parse(reader.line(), result);
+}
+
+// Batch versions of each stage (parseLinesBatched). Stages w/ a parseBatch / filterBatch /
+// insertBatch method run that (one tight loop over the batch); the rest fall back to their
+// per-line method, called for each entry.
+//
+// Reads up to ParseBatch::SIZE lines (+ where their subjects end, for readers that index lines);
+// returns the # of lines read
+template <typename Reader>
+auto readBatch (Reader& reader, ParseBatch& batch, int) -> decltype(reader.fields(), size_t()) {
+    size_t count = 0;
+    while (count < ParseBatch::SIZE && reader) {
+        batch.line[count]       = reader.line();
+        batch.subjectEnd[count] = reader.fields().dash;
+        ++count;
+    }
+    return batch.count = count;
+}
+template <typename Reader>
+size_t readBatch (Reader& reader, ParseBatch& batch, long) {
+    size_t count = 0;
+    while (count < ParseBatch::SIZE && reader) {
+        batch.line[count]       = reader.line();
+        batch.subjectEnd[count] = nullptr;
+        ++count;
+    }
+    return batch.count = count;
+}
+
+template <typename Parser>
+auto parseBatch (Parser& parser, ParseBatch& batch, int) -> decltype(parser.parseBatch(batch)) {
+    return parser.parseBatch(batch);
+}
+template <typename Parser>
+void parseBatch (Parser& parser, ParseBatch& batch, long) {
+    ParseResult result;
+    size_t count = 0;
+    for (size_t i = 0; i < batch.count; ++i) {
+        if (parser.parse(batch.line[i], result)) {
+            batch.set(count++, result);
+        }
+    }
+    batch.count = count;
+}
+
+template <typename Filterer, typename SubjectModel>
+auto filterBatch (Filterer& filterer, ParseBatch& batch, SubjectModel& model, int)
+    -> decltype(filterer.filterBatch(batch, model))
+{
+    return filterer.filterBatch(batch, model);
+}
+template <typename Filterer, typename SubjectModel>
+void filterBatch (Filterer& filterer, ParseBatch& batch, SubjectModel& model, long) {
+    size_t count = 0;
+    for (size_t i = 0; i < batch.count; ++i) {
+        ParseResult result = batch.get(i);
+        if (filterer.filter(result, model)) {
+            batch.set(count++, result);
+        }
+    }
+    batch.count = count;
+}
+
+template <typename Counter, typename SubjectModel>
+auto insertBatch (Counter& counter, SubjectModel& model, const ParseBatch& batch, int)
+    -> decltype(counter.insertBatch(model, batch))
+{
+    return counter.insertBatch(model, batch);
+}
+template <typename Counter, typename SubjectModel>
+void insertBatch (Counter& counter, SubjectModel& model, const ParseBatch& batch, long) {
+    for (size_t i = 0; i < batch.count; ++i) {
+        counter.insert(model, batch.get(i));
+    }
+}
+
 // Main dvc parsing algorithm, heavily parameterized to use any:
 // – Actor (ie. what actions are taken when certain events happen)
 // – Allocator (could use custom allocator to improve performance; will be used (in theory) for everything in here)
@@ -857,7 +1994,8 @@ struct NoDisplay : public Actor {
 // OR:
 //  - benchmark all read + parsing + filtering operations when those enter / exit scope
 //  - benchmark all sorting operations when that enters / exits scope
-// etc.
+// etc. (ProfilingActor times each stage per call, w/ the enterStage / exitStage events that
+// actorStage() fires around every call below)
 //
 // As you can see (hopefully) this is extremely powerful, and the reason why the above code is so complicated:
 // I needed to implement both
@@ -879,27 +2017,189 @@ struct NoDisplay : public Actor {
 // - since it turned out that I could abstract out all of this boilerplate with inheritance (and a little bit of CRTP),
 //   the resulting implementation ended up being quite clean, albeit... quite complicated.
 //
-template <typename Actor, typename Allocator, typename Reader, typename Parser, typename Filterer, typename Counter, typename Sorter>
+template <typename Actor, typename Allocator, typename Reader, typename Parser, typename Filterer, typename Counter, typename Sorter,
+          typename Model = SubjectModel>
 void parseLines (const char* filePath) {
+    static_assert(!ReaderSpawnsThreads<Reader>::value || IsThreadSafeAllocator<Allocator>::value,
+        "parseLines: a reader that spawns a thread (see ReaderSpawnsThreads) needs a thread safe Allocator");
+    static_assert(!ReaderSpawnsThreads<Reader>::value || !SwapsAllocator<Actor>::value,
+        "parseLines: a reader that spawns a thread (see ReaderSpawnsThreads) can't be profiled (see SwapsAllocator)");
     Actor actor;
     {
         auto allocator = Allocator::create(actor);
         {
-            auto subjects = SubjectModel::create(actor, allocator);
+            auto subjects = Model::create(actor, allocator);
             {
                 auto counter = Counter::create(actor, allocator);
                 {
                     auto parser = Parser::create(actor, allocator);
                     auto filterer = Filterer::create(actor, allocator);
                     {
-                        auto reader = Reader::create(actor, allocator, filePath);
+                        auto reader = actorStage<kReader>(actor, [&]() { return Reader::create(actor, allocator, filePath); });
                         ParseResult result;
-                        while (reader) {
+                        while (actorStage<kReader>(actor, [&]() { return bool(reader); })) {
                             //std::cout << reader.line() << '\n';
-                            if (parser.parse(reader.line(), result) && filterer.filter(result, subjects)) {
-                                counter.insert(subjects, result);
+                            if (actorStage<kParser>(actor, [&]() { return parseNextLine(parser, reader, result, 0); }) &&
+                                actorStage<kFilterer>(actor, [&]() { return filterer.filter(result, subjects); }))
+                            {
+                                actorStage<kCounter>(actor, [&]() { counter.insert(subjects, result); });
+                            }
+                        }
+                    }
+                }
+                actorStage<kCounter>(actor, [&]() { counter.finalize(subjects); });
+            }
+            {
+                auto sorter = Sorter::create(actor, allocator);
+                actorStage<kSorter>(actor, [&]() { sorter.sort(subjects); });
+            }
+        }
+    }
+}
+
+// Same pipeline + results as parseLines, but each stage runs over a batch of up to
+// ParseBatch::SIZE lines at a time (read a batch, parse it, filter it, count it), instead of
+// taking every line through all the stages in turn. The batch points into the reader's lines, so
+// those must stay valid (HasStableLines: the mmap / pre-buffered / fake readers).
+template <typename Actor, typename Allocator, typename Reader, typename Parser, typename Filterer, typename Counter, typename Sorter,
+          typename Model = SubjectModel>
+void parseLinesBatched (const char* filePath) {
+    static_assert(HasStableLines<Reader>::value, "parseLinesBatched needs a reader w/ stable lines (see HasStableLines)");
+    Actor actor;
+    {
+        auto allocator = Allocator::create(actor);
+        {
+            auto subjects = Model::create(actor, allocator);
+            {
+                auto counter = Counter::create(actor, allocator);
+                {
+                    auto parser = Parser::create(actor, allocator);
+                    auto filterer = Filterer::create(actor, allocator);
+                    {
+                        auto reader = actorStage<kReader>(actor, [&]() { return Reader::create(actor, allocator, filePath); });
+                        ParseBatch batch;
+                        while (actorStage<kReader>(actor, [&]() { return readBatch(reader, batch, 0); }) != 0) {
+                            actorStage<kParser>  (actor, [&]() { parseBatch(parser, batch, 0); });
+                            actorStage<kFilterer>(actor, [&]() { filterBatch(filterer, batch, subjects, 0); });
+                            actorStage<kCounter> (actor, [&]() { insertBatch(counter, subjects, batch, 0); });
+                        }
+                    }
+                }
+                actorStage<kCounter>(actor, [&]() { counter.finalize(subjects); });
+            }
+            {
+                auto sorter = Sorter::create(actor, allocator);
+                actorStage<kSorter>(actor, [&]() { sorter.sort(subjects); });
+            }
+        }
+    }
+}
+
+//
+// PARALLEL PARSING
+//
+
+// Splits [begin, end) into count chunks at line boundaries: chunk i is [bounds[i], bounds[i + 1])
+// (chunks can be empty if there are fewer lines than chunks)
+void splitLines (const char* begin, const char* end, size_t count, const char** bounds) {
+    bounds[0] = begin;
+    for (size_t i = 1; i < count; ++i) {
+        const char* split = std::max(bounds[i - 1], begin + (end - begin) * i / count);
+        if (split > begin && split < end && split[-1] != '\n') {
+            const char* eol = static_cast<const char*>(memchr(split, '\n', end - split));
+            split = eol ? eol + 1 : end;
+        }
+        bounds[i] = split;
+    }
+    bounds[count] = end;
+}
+
+// Per chunk state: each worker runs its own parser, filterer + counter over its chunk
+template <typename Parser, typename Filterer, typename Counter, typename Model>
+struct ParseChunk {
+    typename Parser::Instance   parser;
+    typename Filterer::Instance filterer;
+    typename Counter::Instance  counter;
+    typename Model::Instance    subjects;
+};
+
+// Re-runs a chunk's parser + filterer (lazily, only as far as needed) to recover the results its
+// counter was given: replay[k] is the k-th result passed to counter.insert()
+template <typename Reader, typename Parser, typename Filterer, typename Model>
+class ChunkReplay {
+    typename Reader::Instance   reader;
+    typename Parser::Instance   parser;
+    typename Filterer::Instance filterer;
+    Model&                      subjects;
+    std::vector<ParseResult>    results;
+public:
+    ChunkReplay (const char* begin, const char* end, Model& subjects) : reader(begin, end), subjects(subjects) {}
+    const ParseResult& operator[] (size_t k) {
+        ParseResult result;
+        while (results.size() <= k && reader) {
+            if (parseNextLine(parser, reader, result, 0) && filterer.filter(result, subjects)) {
+                results.push_back(result);
+            }
+        }
+        assert(k < results.size());
+        return results[k];
+    }
+};
+
+// Same as parseLines, but splits the (mapped) file into chunks at line boundaries, and runs the
+// parser, filterer + counter over each chunk on the scheduler's workers. The chunks are then
+// merged in file order on the calling thread:
+//  – filterer.merge() adds each chunk's filterer state (ie. dedupe bitset) to the main filterer,
+//    and finds the lines that duplicate lines in earlier chunks. Those are courses that straddle a
+//    chunk boundary, so finding their positions (ChunkReplay) only re-parses a few lines.
+//  – counter.merge() adds each chunk's counts (minus those duplicates) to the main subject model,
+//    in the same order the serial run would have inserted them
+// so the output is identical to parseLines, for any # of chunks / threads.
+//
+// Reader must be able to read a range of a buffer (MmapReader / IndexedMmapReader).
+template <typename Actor, typename Allocator, typename Reader, typename Parser, typename Filterer, typename Counter, typename Sorter,
+          typename Model = SubjectModel>
+void parseLinesParallel (const char* filePath, TaskScheduler& scheduler, size_t chunkCount) {
+    static_assert(IsThreadSafeAllocator<Allocator>::value, "parseLinesParallel: Allocator must be thread safe");
+    typedef ParseChunk<Parser, Filterer, Counter, Model> Chunk;
+    Actor actor;
+    {
+        auto allocator = Allocator::create(actor);
+        {
+            auto subjects = Model::create(actor, allocator);
+            {
+                auto counter = Counter::create(actor, allocator);
+                {
+                    auto parser = Parser::create(actor, allocator);
+                    auto filterer = Filterer::create(actor, allocator);
+                    MappedFile file (filePath);
+                    std::vector<const char*> bounds (chunkCount + 1);
+                    splitLines(file.begin(), file.end(), chunkCount, &bounds[0]);
+
+                    std::vector<Chunk> chunks (chunkCount);
+                    parallel_for(0, chunkCount, 1, [&](size_t c0, size_t c1) {
+                        for (size_t c = c0; c < c1; ++c) {
+                            Chunk& chunk = chunks[c];
+                            typename Reader::Instance reader (bounds[c], bounds[c + 1]);
+                            ParseResult result;
+                            while (reader) {
+                                if (parseNextLine(chunk.parser, reader, result, 0) && chunk.filterer.filter(result, chunk.subjects)) {
+                                    chunk.counter.insert(chunk.subjects, result);
+                                }
                             }
                         }
+                    }, scheduler);
+
+                    std::vector<size_t> rejected;
+                    for (size_t c = 0; c < chunkCount; ++c) {
+                        Chunk& chunk = chunks[c];
+                        ChunkReplay<Reader, Parser, Filterer, typename Model::Instance> replay (bounds[c], bounds[c + 1], chunk.subjects);
+                        rejected.clear();
+                        size_t duplicates = filterer.merge(chunk.filterer);
+                        for (size_t k = 0; rejected.size() < duplicates; ++k) {
+                            if (filterer.isMergeDuplicate(replay[k])) rejected.push_back(k);
+                        }
+                        counter.merge(subjects, chunk.subjects, chunk.counter, rejected, replay);
                     }
                 }
                 counter.finalize(subjects);
@@ -928,21 +2228,24 @@ void writeToFile (const char* readPath, const char* writePath) {
 }
 
 
+// Mean ms / run of a fixed # of runs, on the monotonic (wall time) clock. For a quick number; the
+// parser scaling benchmarks use bench::run() (Benchmark.h: warm-up, calibrated samples, median / p90)
 template <typename F, typename... Args>
 double benchmark (size_t iterations, F fcn, Args... args) {
-    clock_t startTime = clock();
+    auto startTime = bench::Clock::now();
     for (size_t i = iterations; i --> 0; ) {
         fcn(args...);
     }
-    clock_t endTime = clock();
-    return static_cast<double>(endTime - startTime) / CLOCKS_PER_SEC * 1e3 / iterations;
+    auto endTime = bench::Clock::now();
+    return bench::elapsedMs(startTime, endTime) / iterations;
 }
 
-template <typename Reader, typename Parser, typename Filterer, typename Counter, typename Sorter, size_t lines>
+template <typename Reader, typename Parser, typename Filterer, typename Counter, typename Sorter, size_t lines,
+          typename Allocator = DefaultAllocator<Mallocator>>
 void runHeadlessParser (const char* filePath) {
     parseLines<
-        NoDisplay,                          // action
-        DefaultAllocator<Mallocator>,       // allocator
+        NoDisplay,                  // action
+        Allocator,                  // allocator
         Take<lines, Reader>,        // file loader + file actions
         Parser,                     // parsing algorithm
         Filterer,                   // filtering algorithm
@@ -950,81 +2253,680 @@ void runHeadlessParser (const char* filePath) {
         Sorter                      // sorting algorithm
     >(filePath);
 }
-template <typename Reader, typename Parser, typename Filterer, typename Counter, typename Sorter, size_t lines, size_t limit>
-void benchParserLinear (const char* filePath, size_t iterations, double expected = 0) {
-    auto runtime = benchmark(iterations, &runHeadlessParser<Reader, Parser, Filterer, Counter, Sorter, lines>, filePath);
-    std::cout << "parsed lines: " << std::setw(6) << lines << " time: "
-        << std::setw(8) << runtime << " ms / run";
-    if (expected == 0) std::cout << "  expected O(n)\n";
+// Runtime of the pipeline on the first `lines` lines, doubling lines up to limit; each run's median
+// (+ p90 / stddev) is recorded in bench::Report::global() as "<name> / <lines>"
+template <typename Reader, typename Parser, typename Filterer, typename Counter, typename Sorter, size_t lines>
+bench::Stats benchParserLines (const std::string& name, const char* filePath, const bench::Options& options, const char* complexity, double expected) {
+    auto stats = bench::run(options, [&]() {
+        runHeadlessParser<Reader, Parser, Filterer, Counter, Sorter, lines>(filePath);
+    });
+    bench::Report::global().add(name, lines, stats);
+    std::cout << "parsed lines: " << std::setw(6) << lines << " time: " << stats;
+    if (expected == 0) std::cout << "  expected " << complexity << '\n';
     else               std::cout << "  expected " << expected << '\n';
+    return stats;
+}
+template <typename Reader, typename Parser, typename Filterer, typename Counter, typename Sorter, size_t lines, size_t limit>
+void benchParserLinear (const std::string& name, const char* filePath, const bench::Options& options, double expected = 0) {
+    auto stats = benchParserLines<Reader, Parser, Filterer, Counter, Sorter, lines>(name, filePath, options, "O(n)", expected);
     if (lines * 2 <= limit) {
-        benchParserLinear<Reader, Parser, Filterer, Counter, Sorter, lines * 2, limit>(filePath, iterations, runtime * 2);
+        benchParserLinear<Reader, Parser, Filterer, Counter, Sorter, lines * 2, limit>(name, filePath, options, stats.median * 2);
     }
 }
 
 template <typename Reader, typename Parser, typename Filterer, typename Counter, typename Sorter, size_t lines, size_t limit>
-void benchParserQuadratic (const char* filePath, size_t iterations, double expected = 0) {
-    auto runtime = benchmark(iterations, &runHeadlessParser<Reader, Parser, Filterer, Counter, Sorter, lines>, filePath);
-    std::cout << "parsed lines: " << std::setw(6) << lines << " time: "
-        << std::setw(8) << runtime << " ms / run";
-    if (expected == 0) std::cout << "  expected O(n^2)\n";
-    else               std::cout << "  expected " << expected << '\n';
+void benchParserQuadratic (const std::string& name, const char* filePath, const bench::Options& options, double expected = 0) {
+    auto stats = benchParserLines<Reader, Parser, Filterer, Counter, Sorter, lines>(name, filePath, options, "O(n^2)", expected);
     if (lines * 2 <= limit) {
-        benchParserQuadratic<Reader, Parser, Filterer, Counter, Sorter, lines * 2, limit>(
-            filePath, iterations, runtime * 2
-        );
+        benchParserQuadratic<Reader, Parser, Filterer, Counter, Sorter, lines * 2, limit>(name, filePath, options, stats.median * 4);
     }
 }
 
 
 template <typename Reader, typename Filterer, typename Counter, typename Sorter>
-void runParserBenchSuite (const char* filePath, size_t iterations) {
-    std::cout << "running benchmarks with " << iterations << " iterations\n";
+void runParserBenchSuite (const std::string& suite, const char* filePath, size_t samples) {
+    bench::Options options (samples);
+    std::cout << "running benchmarks with " << samples << " samples / size\n";
 
     std::cout << "\nNoParser:\n";
-    benchParserLinear<Reader, NoParser, Filterer, Counter, Sorter, 8000,64000>(filePath, iterations);
+    benchParserLinear<Reader, NoParser, Filterer, Counter, Sorter, 8000,64000>(suite + ", NoParser", filePath, options);
 
     std::cout << "\nFastParser:\n";
-    benchParserLinear<Reader, FastParser, Filterer, Counter, Sorter, 8000,64000>(filePath, iterations);
+    benchParserLinear<Reader, FastParser, Filterer, Counter, Sorter, 8000,64000>(suite + ", FastParser", filePath, options);
 
     std::cout << "\nEvenFasterParser:\n";
-    benchParserLinear<Reader, EvenFasterParser, Filterer, Counter, Sorter, 8000,64000>(filePath, iterations);
+    benchParserLinear<Reader, EvenFasterParser, Filterer, Counter, Sorter, 8000,64000>(suite + ", EvenFasterParser", filePath, options);
 
     std::cout << "\nWith quadratic filtering:\n";
-    benchParserQuadratic<Reader, FastParser, LinearFilter, Counter, Sorter, 200, 3200>(filePath, (iterations + 1) / 4);
+    benchParserQuadratic<Reader, FastParser, LinearFilter, Counter, Sorter, 200, 3200>(suite + ", FastParser + LinearFilter", filePath,
+        bench::Options((samples + 1) / 2));
+}
+
+// Compares the file readers on the same pipeline (lines read + parsed / ms, at 8k - 64k lines)
+template <typename Parser, typename Filterer, typename Counter, typename Sorter>
+void runReaderBenchSuite (const std::string& suite, const char* filePath, size_t samples) {
+    bench::Options options (samples);
+    std::cout << "\nIfstreamReader:\n";
+    benchParserLinear<IfstreamReader, Parser, Filterer, Counter, Sorter, 8000,64000>(suite + ", IfstreamReader", filePath, options);
+
+    std::cout << "\nCFileReader:\n";
+    benchParserLinear<CFileReader, Parser, Filterer, Counter, Sorter, 8000,64000>(suite + ", CFileReader", filePath, options);
+
+    std::cout << "\nCFilePreBufferedReader:\n";
+    benchParserLinear<CFilePreBufferedReader, Parser, Filterer, Counter, Sorter, 8000,64000>(suite + ", CFilePreBufferedReader", filePath, options);
+
+    std::cout << "\nMmapReader:\n";
+    benchParserLinear<MmapReader, Parser, Filterer, Counter, Sorter, 8000,64000>(suite + ", MmapReader", filePath, options);
+
+    std::cout << "\nIndexedMmapReader:\n";
+    benchParserLinear<IndexedMmapReader, Parser, Filterer, Counter, Sorter, 8000,64000>(suite + ", IndexedMmapReader", filePath, options);
+
+    std::cout << "\nStreamReader:\n";
+    benchParserLinear<StreamReader, Parser, Filterer, Counter, Sorter, 8000,64000>(suite + ", StreamReader", filePath, options);
+}
+
+// Checks a full file run's parse checksum against the first one (shared by every reader / parser
+// combination, incl. compressed input)
+void checkFullFileChecksum (const char* name, size_t checksum) {
+    static size_t expectedChecksum = 0;
+    if (!expectedChecksum) expectedChecksum = checksum;
+    if (checksum != expectedChecksum) {
+        std::cerr << "FAILED: " << name << " parse results differ (checksum " << checksum
+            << ", expected " << expectedChecksum << ")" << std::endl;
+        exit(-1);
+    }
+}
+
+// Reads + parses the whole file (no filtering etc), and reports lines / sec. Checks that every
+// reader / parser combination sees the same lines + parse results (checksum).
+template <typename Reader, typename Parser>
+void benchFullFileThroughput (const char* name, const char* filePath, size_t iterations) {
+    size_t lines = 0, checksum = 0;
+    auto runtime = benchmark(iterations, [&]() {
+        typename Reader::Instance reader (filePath);
+        typename Parser::Instance parser;
+        ParseResult result;
+        lines = checksum = 0;
+        while (reader) {
+            ++lines;
+            if (parseNextLine(parser, reader, result, 0)) {
+                checksum += result.courseHash + result.subjectStr.size() * lines;
+            }
+        }
+    });
+    std::cout << name << ": " << std::setw(6) << lines << " lines " << std::setw(8) << runtime << " ms / run "
+        << std::setw(8) << lines / runtime * 1e-3 << " M lines / s\n";
+    if (!std::is_same<Parser, NoParser>::value) {
+        checkFullFileChecksum(name, checksum);
+    }
+}
+
+#ifdef DVC_HAVE_ZLIB
+// Same as benchFullFileThroughput, for a compressed file read w/ InflateReader (wall time: the
+// inflate thread runs alongside the parser). Reports compressed + uncompressed MB / s.
+template <typename Parser>
+void benchCompressedThroughput (const char* name, const char* compressedPath, size_t iterations) {
+    size_t lines = 0, checksum = 0, compressedBytes = 0, uncompressedBytes = 0;
+    bool   failed = false;
+    auto runtime = benchmark(iterations, [&]() {
+        InflateReader::Instance reader (compressedPath);
+        typename Parser::Instance parser;
+        ParseResult result;
+        lines = checksum = 0;
+        while (reader) {
+            ++lines;
+            if (parser.parse(reader.line(), result)) {
+                checksum += result.courseHash + result.subjectStr.size() * lines;
+            }
+        }
+        compressedBytes   = reader.compressedBytes();
+        uncompressedBytes = reader.uncompressedBytes();
+        failed            = reader.failed();
+    });
+    if (failed) {
+        std::cerr << "FAILED: could not inflate '" << compressedPath << "'" << std::endl;
+        exit(-1);
+    }
+    std::cout << name << ": " << std::setw(6) << lines << " lines " << std::setw(8) << runtime << " ms / run "
+        << std::setw(8) << lines / runtime * 1e-3 << " M lines / s "
+        << std::setw(7) << compressedBytes / runtime * 1e-3 << " MB / s compressed "
+        << std::setw(7) << uncompressedBytes / runtime * 1e-3 << " MB / s uncompressed\n";
+    if (!std::is_same<Parser, NoParser>::value) {
+        checkFullFileChecksum(name, checksum);
+    }
+}
+#endif // DVC_HAVE_ZLIB
+
+// Resident set size (bytes) of this process, from /proc/self/statm (0 if unavailable)
+size_t residentBytes () {
+    size_t pages = 0, resident = 0;
+    if (FILE* file = fopen("/proc/self/statm", "r")) {
+        if (fscanf(file, "%zu %zu", &pages, &resident) != 2) resident = 0;
+        fclose(file);
+    }
+    return resident * (size_t)sysconf(_SC_PAGESIZE);
+}
+
+// Pipes copies of the file (written by a second thread, through a fixed 64k buffer) into
+// StreamReader + EvenFasterParser, and reports MB / s + lines / s, and how much the resident set
+// grew while reading (sampled every 64k lines; should stay flat as the input grows).
+void benchStreamThroughput (const char* filePath, size_t copies) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        std::cerr << "FAILED: pipe()" << std::endl;
+        exit(-1);
+    }
+    std::thread writer ([=]() {
+        char buffer[64 * 1024];
+        for (size_t i = 0; i < copies; ++i) {
+            int fd = open(filePath, O_RDONLY);
+            for (ssize_t count; fd >= 0 && (count = read(fd, buffer, sizeof(buffer))) > 0; ) {
+                for (ssize_t written = 0, n; written < count; written += n) {
+                    if ((n = write(fds[1], buffer + written, count - written)) < 0) break;
+                }
+            }
+            if (fd >= 0) close(fd);
+        }
+        close(fds[1]);
+    });
+    size_t lines = 0, bytes = 0, checksum = 0;
+    size_t startRss = residentBytes(), maxRss = startRss;
+    auto runtime = benchmark(1, [&]() {
+        StreamReader::Instance reader (fds[0]);
+        EvenFasterParser::Instance parser;
+        ParseResult result;
+        while (reader) {
+            const char* line = reader.line();
+            const char* eol  = strchr(line, '\n');
+            bytes += (eol ? eol - line : strlen(line)) + 1;
+            if (parser.parse(line, result)) {
+                checksum += result.courseHash;
+            }
+            if (++lines % (64 * 1024) == 0) {
+                maxRss = std::max(maxRss, residentBytes());
+            }
+        }
+    });
+    writer.join();
+    close(fds[0]);
+    std::cout << std::setw(3) << copies << " copies: " << std::setw(8) << lines << " lines "
+        << std::setw(9) << runtime << " ms " << std::setw(8) << bytes / runtime * 1e-3 << " MB / s "
+        << std::setw(6) << lines / runtime * 1e-3 << " M lines / s  resident set +"
+        << (maxRss - std::min(maxRss, startRss)) / 1024 << " KB\n";
+    static size_t linesPerCopy = 0, checksumPerCopy = 0;
+    if (copies == 1) { linesPerCopy = lines; checksumPerCopy = checksum; }   // (run w/ 1 copy first)
+    if (lines != linesPerCopy * copies || checksum != checksumPerCopy * copies) {
+        std::cerr << "FAILED: streamed " << lines << " lines (checksum " << checksum << "), expected "
+            << linesPerCopy * copies << " (" << checksumPerCopy * copies << ")" << std::endl;
+        exit(-1);
+    }
+}
+
+// Counts every result w/ a fresh Counter + SubjectModel; returns the subjects' "name count" lines,
+// sorted by name (if list), and the heap memory (operator new) + arena bytes used by the counter
+template <typename Counter>
+void countSubjects (const std::vector<ParseResult>& results, std::string* list = nullptr,
+                    size_t* heapBytes = nullptr, size_t* heapAllocations = nullptr)
+{
+    std::vector<std::string> names;
+    {
+        TracingAllocator tracing;
+        {
+            SubjectModel::Instance model;
+            typename Counter::Instance counter;
+            for (const auto& result : results) {
+                counter.insert(model, result);
+            }
+            counter.finalize(model);
+            if (heapBytes) *heapBytes = tracing.bytesAllocated;
+            if (heapAllocations) *heapAllocations = tracing.numAllocations;
+            if (list) {
+                IAllocator* tracer = IAllocator::current;
+                IAllocator::current = &mallocator;  // (names outlive tracing)
+                for (size_t i = 0; i < model.subjectCount; ++i) {
+                    names.push_back(model.subjects[i].name + ' ' + std::to_string(model.subjects[i].count));
+                }
+                IAllocator::current = tracer;
+            }
+        }
+    }
+    if (list) {
+        std::sort(names.begin(), names.end());
+        list->clear();
+        for (const auto& name : names) *list += name + '\n';
+    }
+}
+template <typename Counter>
+void countSubjectsUntraced (const std::vector<ParseResult>& results) {
+    SubjectModel::Instance model;
+    typename Counter::Instance counter;
+    for (const auto& result : results) {
+        counter.insert(model, result);
+    }
+    counter.finalize(model);
+}
+
+// Subject counting: HashedSubjectCounter (std::string per subject, in a 1024 slot table of
+// Subjects) vs InternedSubjectCounter (StringInterner ids + an array of counts). Counting only, on
+// every parsed line of the file (parsed once, up front), then the full pipeline. Memory is what
+// one counting run allocates: heap (operator new, traced), + for the interner, its arena (which
+// mallocs directly, so isn't traced). Checks that both count the same subjects.
+void benchSubjectCounters (const char* filePath, size_t iterations) {
+    typedef HashedSubjectCounter<1024, DefaultHash> Hashed;
+    typedef DefaultAllocator<Mallocator>            Allocator;
+    MmapReader::Instance        reader (filePath);  // (keeps the lines results point into mapped)
+    EvenFasterParser::Instance  parser;
+    std::vector<ParseResult>    results;
+    ParseResult result;
+    while (reader) {
+        if (parseNextLine(parser, reader, result, 0)) results.push_back(result);
+    }
+
+    std::string hashedList, internedList;
+    size_t hashedBytes, hashedAllocations, internedBytes, internedAllocations;
+    countSubjects<Hashed>                (results, &hashedList,   &hashedBytes,   &hashedAllocations);
+    countSubjects<InternedSubjectCounter>(results, &internedList, &internedBytes, &internedAllocations);
+    size_t arenaBytes;
+    {
+        InternedSubjectCounter::Instance counter;
+        SubjectModel::Instance model;
+        for (const auto& result : results) counter.insert(model, result);
+        arenaBytes = counter.subjects.stringBytes();
+    }
+    double hashed   = benchmark(iterations, &countSubjectsUntraced<Hashed>,                 results);
+    double interned = benchmark(iterations, &countSubjectsUntraced<InternedSubjectCounter>, results);
+
+    std::cout << "counting only (" << results.size() << " lines):\n"
+        << "HashedSubjectCounter:   " << std::setw(8) << hashed << " ms / run  "
+            << std::setw(8) << hashedBytes << " bytes heap in " << hashedAllocations << " allocations\n"
+        << "InternedSubjectCounter: " << std::setw(8) << interned << " ms / run  "
+            << std::setw(8) << internedBytes << " bytes heap in " << internedAllocations << " allocations + "
+            << arenaBytes << " bytes arena  speedup " << hashed / interned << "x\n";
+    if (internedList != hashedList) {
+        std::cerr << "FAILED: InternedSubjectCounter's subjects differ from HashedSubjectCounter's:\n"
+            << internedList << "expected:\n" << hashedList << std::endl;
+        exit(-1);
+    }
+
+    auto fullHashed   = benchmark(iterations, &parseLines<NoDisplay, Allocator, MmapReader, EvenFasterParser,
+                                                          HashedCourseFilterer, Hashed, BubbleSort>, filePath);
+    auto fullInterned = benchmark(iterations, &parseLines<NoDisplay, Allocator, MmapReader, EvenFasterParser,
+                                                          HashedCourseFilterer, InternedSubjectCounter, BubbleSort>, filePath);
+    std::cout << "full pipeline (MmapReader, EvenFasterParser, HashedCourseFilterer, BubbleSort):\n"
+        << "HashedSubjectCounter:   " << std::setw(8) << fullHashed << " ms / run\n"
+        << "InternedSubjectCounter: " << std::setw(8) << fullInterned << " ms / run  speedup "
+            << fullHashed / fullInterned << "x\n";
+}
+
+template <typename Reader, typename Parser, typename Filterer, typename Counter, typename Sorter, size_t lines,
+          typename Allocator = DefaultAllocator<Mallocator>>
+void runHeadlessBatchParser (const char* filePath) {
+    parseLinesBatched<NoDisplay, Allocator, Take<lines, Reader>, Parser, Filterer, Counter, Sorter>(filePath);
+}
+// Same as benchParserLinear, w/ the per-line pipeline (parseLines) vs the batched one
+// (parseLinesBatched) on the same lines. Checks that both produce the same subjects.
+template <typename Reader, typename Parser, typename Filterer, typename Counter, typename Sorter, size_t lines, size_t limit>
+void benchBatchParserLinear (const char* filePath, size_t iterations) {
+    typedef DefaultAllocator<Mallocator> Allocator;
+    parseLines<CaptureSubjects, Allocator, Take<lines, Reader>, Parser, Filterer, Counter, Sorter>(filePath);
+    std::string expected = CaptureSubjects::output();
+    parseLinesBatched<CaptureSubjects, Allocator, Take<lines, Reader>, Parser, Filterer, Counter, Sorter>(filePath);
+    if (CaptureSubjects::output() != expected) {
+        std::cerr << "FAILED: batched subjects (" << lines << " lines) differ from per-line:\n"
+            << CaptureSubjects::output() << "expected:\n" << expected << std::endl;
+        exit(-1);
+    }
+    auto perLine = benchmark(iterations, &runHeadlessParser<Reader, Parser, Filterer, Counter, Sorter, lines>, filePath);
+    auto batched = benchmark(iterations, &runHeadlessBatchParser<Reader, Parser, Filterer, Counter, Sorter, lines>, filePath);
+    std::cout << "parsed lines: " << std::setw(6) << lines
+        << " per line: " << std::setw(8) << perLine << " ms / run"
+        << "  batched: " << std::setw(8) << batched << " ms / run  speedup " << perLine / batched << "x\n";
+    if (lines * 2 <= limit) {
+        benchBatchParserLinear<Reader, Parser, Filterer, Counter, Sorter, lines * 2, limit>(filePath, iterations);
+    }
+}
+
+// Full pipeline w/ NoDisplay vs ProfilingActor (wall time), then ProfilingActor's per-stage
+// breakdown, averaged over the profiled runs
+template <typename Reader, typename Parser, typename Filterer, typename Counter, typename Sorter>
+void benchPipelineProfile (const char* name, const char* filePath, size_t iterations) {
+    typedef DefaultAllocator<Mallocator> Allocator;
+    auto runtime  = benchmark(iterations, &parseLines<NoDisplay, Allocator, Reader, Parser, Filterer, Counter, Sorter>, filePath);
+    ProfilingActor::reset();
+    auto profiled = benchmark(iterations, &parseLines<ProfilingActor, Allocator, Reader, Parser, Filterer, Counter, Sorter>, filePath);
+    std::cout << name << ": " << std::setw(8) << runtime << " ms / run (NoDisplay)  "
+        << std::setw(8) << profiled << " ms / run (ProfilingActor)\n";
+    ProfilingActor::report(std::cout);
+}
+
+// Full pipeline on the whole file, from its text (MmapReader + EvenFasterParser) vs from its
+// binary cache (CacheReader, w/ + w/out line keys; includes mapping + verifying the cache on each
+// run). Checks that all of them produce the same subjects (also w/ LinearFilter, on the first 3200
+// rows), and that the cache's rows line up w/ the text file's lines.
+void benchCachedParser (const char* filePath, size_t iterations) {
+    typedef DefaultAllocator<Mallocator> Allocator;
+    typedef HashedSubjectCounter<1024, DefaultHash> Counter;
+    {
+        CacheReader::Instance reader (filePath);
+        if (reader.cacheError()) {
+            std::cout << "skipped (" << dvcCachePath(filePath) << ": " << reader.cacheError()
+                << "; run dvc_convert to write it)\n";
+            return;
+        }
+        // line() is each row's text line, up to + including its course, and doesn't advance
+        std::ifstream file (filePath);
+        std::string   text;
+        while (reader && getline(file, text)) {
+            std::string key = reader.line();
+            if (text.compare(0, key.size(), key) != 0 || text[key.size()] != '\t') continue;  // (not cached, eg. the header)
+            if (reader.line() != key) break;
+            reader.skip();
+        }
+        if (reader) {
+            std::cerr << "FAILED: cached row '" << reader.line() << "' doesn't match the text file's lines" << std::endl;
+            exit(-1);
+        }
+        // Skip<> moves past rows w/ skip()
+        Skip<2, CacheReader>::Instance skipped (filePath);
+        reader.reset(); reader.skip(); reader.skip();
+        if (reader && strcmp(skipped.line(), reader.line()) != 0) {
+            std::cerr << "FAILED: Skip<2, CacheReader> starts at '" << skipped.line() << "', not '" << reader.line() << "'" << std::endl;
+            exit(-1);
+        }
+    }
+    // (LinearFilter keys on result.line; the text file's first line is its header)
+    parseLines<CaptureSubjects, Allocator, Take<3201, MmapReader>, EvenFasterParser, LinearFilter, Counter, BubbleSort>(filePath);
+    std::string expectedLinear = CaptureSubjects::output();
+    parseLines<CaptureSubjects, Allocator, Take<3200, CacheReader>, EvenFasterParser, LinearFilter, Counter, BubbleSort>(filePath);
+    if (CaptureSubjects::output() != expectedLinear) {
+        std::cerr << "FAILED: cached subjects w/ LinearFilter differ from the text file's:\n" << CaptureSubjects::output()
+            << "expected:\n" << expectedLinear << std::endl;
+        exit(-1);
+    }
+    auto text = benchmark(iterations, &parseLines<CaptureSubjects, Allocator, MmapReader, EvenFasterParser,
+                                                  HashedCourseFilterer, Counter, BubbleSort>, filePath);
+    std::string expected = CaptureSubjects::output();
+    auto check = [&]() {
+        if (CaptureSubjects::output() != expected) {
+            std::cerr << "FAILED: cached subjects differ from the text file's:\n" << CaptureSubjects::output()
+                << "expected:\n" << expected << std::endl;
+            exit(-1);
+        }
+    };
+    auto keyed  = benchmark(iterations, &parseLines<CaptureSubjects, Allocator, CacheReader, EvenFasterParser,
+                                                    HashedCourseFilterer, Counter, BubbleSort>, filePath);
+    check();
+    auto cached = benchmark(iterations, &parseLines<CaptureSubjects, Allocator, BasicCacheReader<false>, EvenFasterParser,
+                                                    HashedCourseFilterer, Counter, BubbleSort>, filePath);
+    check();
+    std::cout << "text  (MmapReader):                 " << std::setw(8) << text << " ms / run\n"
+              << "cache (CacheReader, line keys):     " << std::setw(8) << keyed << " ms / run  speedup "
+              << text / keyed << "x\n"
+              << "cache (BasicCacheReader<false>):    " << std::setw(8) << cached << " ms / run  speedup "
+              << text / cached << "x\n";
+}
+
+// Whole file, serial (parseLines) vs parallel (parseLinesParallel) w/ 1 - 8 workers (+ the calling
+// thread, which helps run chunks), in wall time. Checks that the parallel output is identical to
+// the serial output, also for 1 - 16 chunks on one scheduler.
+template <typename Reader, typename Filterer, typename Counter, typename Sorter>
+void benchParallelParser (const char* filePath, size_t iterations) {
+    typedef DefaultAllocator<Mallocator> Allocator;
+    auto check = [](const std::string& expected, size_t workers, size_t chunks) {
+        if (CaptureSubjects::output() != expected) {
+            std::cerr << "FAILED: parallel output (" << workers << " workers, " << chunks
+                << " chunks) differs from the serial output" << std::endl;
+            exit(-1);
+        }
+    };
+    double serialMs = benchmark(iterations, [&]() {
+        parseLines<CaptureSubjects, Allocator, Reader, EvenFasterParser, Filterer, Counter, Sorter>(filePath);
+    });
+    std::string expected = CaptureSubjects::output();
+    std::cout << "serial:                " << std::setw(8) << serialMs << " ms / run\n";
+
+    for (size_t workers : { 1, 2, 4, 8 }) {
+        TaskScheduler scheduler (workers);
+        size_t chunks = workers + 1;
+        double ms = benchmark(iterations, [&]() {
+            parseLinesParallel<CaptureSubjects, Allocator, Reader, EvenFasterParser, Filterer, Counter, Sorter>(
+                filePath, scheduler, chunks);
+        });
+        check(expected, workers, chunks);
+        std::cout << std::setw(2) << workers << " workers, " << std::setw(2) << chunks << " chunks: "
+            << std::setw(8) << ms << " ms / run  speedup " << std::setw(6) << serialMs / ms << "x\n";
+        if (workers == 4) {
+            for (chunks = 1; chunks <= 16; ++chunks) {
+                parseLinesParallel<CaptureSubjects, Allocator, Reader, EvenFasterParser, Filterer, Counter, Sorter>(
+                    filePath, scheduler, chunks);
+                check(expected, workers, chunks);
+            }
+        }
+    }
+}
+
+// Container allocator configurations: which (std-compatible) allocator the pipeline's containers
+// (subject model + course hashset) use
+struct StdContainers {
+    template <typename T> using Alloc = std::allocator<T>;
+    static const char* name () { return "std::allocator  (global new)"; }
+};
+struct MallocContainers {
+    template <typename T> using Alloc = MallocAllocator<T>;
+    static const char* name () { return "MallocAllocator (malloc / free)"; }
+};
+struct ArenaContainers {
+    template <typename T> using Alloc = ArenaAllocator<T>;
+    static const char* name () { return "ArenaAllocator  (LinearArena)"; }
+};
+
+template <typename Containers, typename Reader, size_t lines>
+void runContainerAllocatorPipeline (const char* filePath) {
+    LinearArena arena;                      // (only used by ArenaContainers; freed after each run)
+    LinearArena::Scope arenaScope (arena);
+    parseLines<
+        NoDisplay,
+        DefaultAllocator<Mallocator>,
+        Take<lines, Reader>,
+        EvenFasterParser,
+        BasicHashedCourseFilterer<typename Containers::template Alloc<size_t>>,
+        HashedSubjectCounter<1024, DefaultHash>,
+        BubbleSort,
+        BasicSubjectModel<typename Containers::template Alloc<Subject>>
+    >(filePath);
+}
+
+template <typename Containers, typename Reader>
+void benchContainerAllocator (const char* filePath, size_t iterations) {
+    std::cout << Containers::name() << ":";
+    std::cout << "  8000 lines: " << std::setw(8) << benchmark(iterations, &runContainerAllocatorPipeline<Containers, Reader, 8000>, filePath) << " ms / run";
+    std::cout << "  64000 lines: " << std::setw(8) << benchmark(iterations, &runContainerAllocatorPipeline<Containers, Reader, 64000>, filePath) << " ms / run\n";
+}
+
+template <typename Reader>
+void runAllocatorBenchSuite (const char* filePath, size_t iterations) {
+    benchContainerAllocator<StdContainers,    Reader>(filePath, iterations);
+    benchContainerAllocator<MallocContainers, Reader>(filePath, iterations);
+    benchContainerAllocator<ArenaContainers,  Reader>(filePath, iterations);
+}
+
+template <typename BaseAllocator, typename Reader>
+void benchGlobalAllocator (const char* name, const char* filePath, size_t iterations) {
+    typedef DefaultAllocator<BaseAllocator> Allocator;
+    std::cout << name << ":";
+    std::cout << "  8000 lines: " << std::setw(8) << benchmark(iterations,
+        &runHeadlessParser<Reader, EvenFasterParser, HashedCourseFilterer, HashedSubjectCounter<1024, DefaultHash>, BubbleSort, 8000, Allocator>,
+        filePath) << " ms / run";
+    std::cout << "  64000 lines: " << std::setw(8) << benchmark(iterations,
+        &runHeadlessParser<Reader, EvenFasterParser, HashedCourseFilterer, HashedSubjectCounter<1024, DefaultHash>, BubbleSort, 64000, Allocator>,
+        filePath) << " ms / run\n";
+}
+
+template <typename Reader>
+void runGlobalAllocatorBenchSuite (const char* filePath, size_t iterations) {
+    benchGlobalAllocator<Mallocator,                  Reader>("Mallocator                 ", filePath, iterations);
+    benchGlobalAllocator<TracingAllocator,            Reader>("TracingAllocator           ", filePath, iterations);
+    benchGlobalAllocator<MonotonicAllocator,          Reader>("MonotonicAllocator         ", filePath, iterations);
+    benchGlobalAllocator<RecyclingMonotonicAllocator, Reader>("RecyclingMonotonicAllocator", filePath, iterations);
 }
 
 int main (int argc, const char** argv) {
     unittest_4atoi();
+    unittest_structuralIndexer();
+    unittest_streamReader();
+    unittest_stringInterner();
     Bitset::unittest();
     std::cout << "Programmer: Seiji Emery\n"
               << "Programmer's id: M00202623\n"
               << "File: " __FILE__ "\n\n";
 
-    // Get path from program arguments
-    const char* path = "dvc-schedule.txt";
-    switch (argc) {
-        case 1: break;
-        case 2: path = argv[0]; break;
-        default: {
-            std::cerr << "usage: " << argv[0] << " [path-to-dvc-schedule.txt]" << std::endl;
+    // Get path (+ optional benchmark result files) from program arguments
+    const char* path     = "dvc-schedule.txt";
+    const char* csvPath  = nullptr;
+    const char* jsonPath = nullptr;
+    for (int i = 1, positional = 0; i < argc; ++i) {
+        if      (strcmp(argv[i], "--csv")  == 0 && i + 1 < argc) csvPath  = argv[++i];
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) jsonPath = argv[++i];
+        else if (positional++ == 0 && (argv[i][0] != '-' || argv[i][1] == '\0')) path = argv[i];
+        else {
+            std::cerr << "usage: " << argv[0] << " [path-to-dvc-schedule.txt | -] [--csv results.csv] [--json results.json]" << std::endl;
             exit(-1);
         }
     }
 
-    size_t iterations = 10; // change this to increase benchmark precision (averages) at cost of runtime performance.
+    // Streaming mode ("-": read the schedule from stdin, eg. piped from another program): runs the
+    // full pipeline once + prints the subjects; the benchmarks below need a file they can reread.
+    if (strcmp(path, "-") == 0) {
+        parseLines<
+            DisplayToCout,
+            DefaultAllocator<Mallocator>,
+            StreamReader,
+            EvenFasterParser,
+            HashedCourseFilterer,
+            HashedSubjectCounter<1024, DefaultHash>,
+            BubbleSort
+        >(path);
+        return 0;
+    }
+#ifdef DVC_HAVE_ZLIB
+    // Compressed input (.zip / .gz, eg. data/dvc-schedule.txt.zip): same, inflating on a 2nd thread
+    size_t pathLength = strlen(path);
+    if ((pathLength > 4 && strcmp(path + pathLength - 4, ".zip") == 0) ||
+        (pathLength > 3 && strcmp(path + pathLength - 3, ".gz") == 0))
+    {
+        parseLines<
+            DisplayToCout,
+            DefaultAllocator<Mallocator>,
+            InflateReader,
+            EvenFasterParser,
+            HashedCourseFilterer,
+            HashedSubjectCounter<1024, DefaultHash>,
+            BubbleSort
+        >(path);
+        return 0;
+    }
+#endif
+
+    size_t iterations = 10; // change this to increase benchmark precision (averages / # of samples) at cost of runtime performance.
 
     std::cout << "\nPart 1: testing dvc parsing algorithms, parser + file I/O only\n";
-    runParserBenchSuite<IfstreamReader, NoCourseFilter, NoSubjectCounter, NoSort>(path, iterations);
+    runParserBenchSuite<IfstreamReader, NoCourseFilter, NoSubjectCounter, NoSort>("ifstream, parse only", path, iterations);
+
+    std::cout << "\nPart 1: testing dvc parsing algorithms, parser + mmap file I/O only\n";
+    runParserBenchSuite<MmapReader, NoCourseFilter, NoSubjectCounter, NoSort>("mmap, parse only", path, iterations);
 
     std::cout << "\nPart 1: testing dvc parsing algorithms, parser + fake file I/O only\n";
-    runParserBenchSuite<FakeReader, NoCourseFilter, HashedSubjectCounter<1024, DefaultHash>, NoSort>(path, iterations);
+    runParserBenchSuite<FakeReader, NoCourseFilter, HashedSubjectCounter<1024, DefaultHash>, NoSort>("fake I/O, parse + count", path, iterations);
 
     std::cout << "\nPart 2: testing dvc parsing + filtering algorithms, no counting / sorting\n";
-    runParserBenchSuite<IfstreamReader, HashedCourseFilterer, NoSubjectCounter, NoSort>(path, iterations);
+    runParserBenchSuite<IfstreamReader, HashedCourseFilterer, NoSubjectCounter, NoSort>("ifstream, parse + filter", path, iterations);
 
     std::cout << "\nPart 2: testing everything\n";
-    runParserBenchSuite<IfstreamReader, HashedCourseFilterer, HashedSubjectCounter<1024, DefaultHash>, BubbleSort>(path, iterations);    
+    runParserBenchSuite<IfstreamReader, HashedCourseFilterer, HashedSubjectCounter<1024, DefaultHash>, BubbleSort>("ifstream, full pipeline", path, iterations);
+
+    std::cout << "\nPart 2: file readers (EvenFasterParser, no filtering / counting / sorting)\n";
+    runReaderBenchSuite<EvenFasterParser, NoCourseFilter, NoSubjectCounter, NoSort>("EvenFasterParser, parse only", path, iterations);
+
+    std::cout << "\nPart 2: full file throughput (line splitting + parsing)\n";
+    benchFullFileThroughput<CFilePreBufferedReader, NoParser>        ("CFilePreBufferedReader, NoParser        ", path, iterations);
+    benchFullFileThroughput<MmapReader,             NoParser>        ("MmapReader,             NoParser        ", path, iterations);
+    benchFullFileThroughput<IndexedMmapReader,      NoParser>        ("IndexedMmapReader,      NoParser        ", path, iterations);
+    benchFullFileThroughput<StreamReader,           NoParser>        ("StreamReader,           NoParser        ", path, iterations);
+    benchFullFileThroughput<CFilePreBufferedReader, EvenFasterParser>("CFilePreBufferedReader, EvenFasterParser", path, iterations);
+    benchFullFileThroughput<MmapReader,             EvenFasterParser>("MmapReader,             EvenFasterParser", path, iterations);
+    benchFullFileThroughput<IndexedMmapReader,      EvenFasterParser>("IndexedMmapReader,      EvenFasterParser", path, iterations);
+    benchFullFileThroughput<StreamReader,           EvenFasterParser>("StreamReader,           EvenFasterParser", path, iterations);
+    benchFullFileThroughput<IndexedMmapReader,      FastParser>      ("IndexedMmapReader,      FastParser      ", path, iterations);
+
+    std::cout << "\nPart 2: streaming through a pipe (StreamReader, EvenFasterParser; constant memory)\n";
+    for (size_t copies : { 1, 4, 16 }) {
+        benchStreamThroughput(path, copies);
+    }
+
+#ifdef DVC_HAVE_ZLIB
+    std::string zipPath = std::string(path) + ".zip";
+    std::cout << "\nPart 2: compressed input (" << zipPath << ", InflateReader; wall time)\n";
+    if (access(zipPath.c_str(), R_OK) == 0) {
+        benchCompressedThroughput<NoParser>        ("InflateReader, NoParser        ", zipPath.c_str(), iterations);
+        benchCompressedThroughput<EvenFasterParser>("InflateReader, EvenFasterParser", zipPath.c_str(), iterations);
+    } else {
+        std::cout << "skipped (no " << zipPath << "; copy data/dvc-schedule.txt.zip next to the text file)\n";
+    }
+#endif
+
+    std::cout << "\nPart 2: binary columnar cache (full pipeline, text vs " << dvcCachePath(path) << ")\n";
+    benchCachedParser(path, iterations);
+
+    std::cout << "\nPart 2: subject counters (std::string keys vs interned ids)\n";
+    benchSubjectCounters(path, iterations);
+
+    std::cout << "\nPart 2: per-stage profile (full pipeline, ProfilingActor; wall time)\n";
+    benchPipelineProfile<IfstreamReader,    EvenFasterParser, HashedCourseFilterer, HashedSubjectCounter<1024, DefaultHash>, BubbleSort>(
+        "IfstreamReader,    EvenFasterParser, HashedSubjectCounter  ", path, iterations);
+    benchPipelineProfile<MmapReader,        EvenFasterParser, HashedCourseFilterer, HashedSubjectCounter<1024, DefaultHash>, BubbleSort>(
+        "MmapReader,        EvenFasterParser, HashedSubjectCounter  ", path, iterations);
+    benchPipelineProfile<MmapReader,        EvenFasterParser, HashedCourseFilterer, InternedSubjectCounter, BubbleSort>(
+        "MmapReader,        EvenFasterParser, InternedSubjectCounter", path, iterations);
+
+    std::cout << "\nPart 2: batched pipeline (ParseBatch, " << ParseBatch::SIZE << " lines / batch) vs per line\n";
+    std::cout << "MmapReader, EvenFasterParser, HashedCourseFilterer, HashedSubjectCounter:\n";
+    benchBatchParserLinear<MmapReader, EvenFasterParser, HashedCourseFilterer, HashedSubjectCounter<1024, DefaultHash>, BubbleSort, 1000, 64000>(path, iterations);
+    std::cout << "MmapReader, EvenFasterParser, HashedCourseFilterer, InternedSubjectCounter:\n";
+    benchBatchParserLinear<MmapReader, EvenFasterParser, HashedCourseFilterer, InternedSubjectCounter, BubbleSort, 1000, 64000>(path, iterations);
+    std::cout << "MmapReader, EvenFasterParser, no filtering / counting:\n";
+    benchBatchParserLinear<MmapReader, EvenFasterParser, NoCourseFilter, NoSubjectCounter, NoSort, 1000, 64000>(path, iterations);
+    std::cout << "CFilePreBufferedReader, FastParser (per-line fallbacks), HashedCourseFilterer, HashedSubjectCounter:\n";
+    benchBatchParserLinear<CFilePreBufferedReader, FastParser, HashedCourseFilterer, HashedSubjectCounter<1024, DefaultHash>, BubbleSort, 1000, 64000>(path, iterations);
+
+    std::cout << "\nPart 2: file readers (full pipeline, EvenFasterParser)\n";
+    runReaderBenchSuite<EvenFasterParser, HashedCourseFilterer, HashedSubjectCounter<1024, DefaultHash>, BubbleSort>("EvenFasterParser, full pipeline", path, iterations);
+
+    std::cout << "\nPart 3: container allocators (full pipeline, EvenFasterParser + pre-buffered file I/O)\n";
+    runAllocatorBenchSuite<CFilePreBufferedReader>(path, iterations);
+
+    std::cout << "\nPart 3: global (operator new) allocators (full pipeline, EvenFasterParser + ifstream I/O)\n";
+    runGlobalAllocatorBenchSuite<IfstreamReader>(path, iterations);
+
+    std::cout << "\nPart 4: parallel parsing (full file, EvenFasterParser, wall time; " 
+        << std::thread::hardware_concurrency() << " hardware threads)\n";
+    std::cout << "\nMmapReader, full pipeline:\n";
+    benchParallelParser<MmapReader, HashedCourseFilterer, HashedSubjectCounter<1024, DefaultHash>, BubbleSort>(path, iterations);
+    std::cout << "\nMmapReader, full pipeline, unsorted:\n";
+    benchParallelParser<MmapReader, HashedCourseFilterer, HashedSubjectCounter<1024, DefaultHash>, NoSort>(path, iterations);
+    std::cout << "\nMmapReader, no filtering:\n";
+    benchParallelParser<MmapReader, NoCourseFilter, HashedSubjectCounter<1024, DefaultHash>, NoSort>(path, iterations);
+
+    // Parser / reader scaling results (median, p90, stddev...), eg. to diff against a previous run
+    if (csvPath) {
+        std::ofstream file (csvPath);
+        bench::Report::global().writeCsv(file);
+        std::cout << "\nWrote " << bench::Report::global().size() << " results to " << csvPath << '\n';
+    }
+    if (jsonPath) {
+        std::ofstream file (jsonPath);
+        bench::Report::global().writeJson(file);
+        std::cout << "\nWrote " << bench::Report::global().size() << " results to " << jsonPath << '\n';
+    }
 
     std::cout << "\nWould you like to view sample run output y / n? ";
     std::string result; std::cin >> result;
@@ -1,30 +1,43 @@
 // Programmer: Seiji Emery
 // Programmer ID: M00202623
 //
-// Part3.cpp
+// sort_test.cpp
 //
-// Implements + runs a simple bubblesort to illustrate the performance of O(n^2) algorithms.
+// Sorting benchmark suite: runs every sort in the tree
+//  - bubbleSort (SortAlgorithms.h)
+//  - the BubbleSort actor from dvc_version_3.cpp (exchangeSort in SortAlgorithms.h)
+//  - SortableArray quicksort (assignment 12)
+//  - std::sort
+// across a range of sizes + input distributions (random, sorted, reverse, few-unique,
+// organ-pipe, nearly-sorted), and reports ns / element, comparisons, swaps and allocations.
 //
-// remote source: https://github.com/SeijiEmery/comp220/blob/master/assignment_08/src/Part3.cpp
+// Timing + allocations are measured on plain doubles; comparisons + swaps are counted in
+// a second (untimed) pass over an instrumented element type, so that the counters don't
+// distort the timings. For SortableArray the two passes take different paths: doubles finish
+// small partitions w/ the (branchless, SIMD) sorting networks, which have nothing to count, so
+// its counts (marked w/ '*') are for plain quicksort, without the network finisher.
+//
+// usage: sort_test [--csv <path>] [--max <n>]
+//   --csv: also writes all results to <path> as CSV (for regression tracking)
+//   --max: largest input size (sizes run from 1000 to max, in steps of 4x; default 1000000)
+//
+// remote source: https://github.com/SeijiEmery/comp220/blob/master/assignment_08/src/sort_test.cpp
 //
 
 #include <algorithm>
 #include <iostream>
 #include <iomanip>
-
-using namespace std;
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <cassert>
 
-template <typename Iterator>
-void bubbleSort (Iterator begin, Iterator end) {
-    for (; begin != end; ++begin) {
-        for (auto other = begin; ++other != end; ) {
-            if (*begin > *other) {
-                std::swap(*begin, *other);
-            }
-        }
-    }
-}
+#include <MemTracer.h>
+#include "SortAlgorithms.h"
+#include "SortableArray.h"
 
 template <typename Iterator>
 bool sorted (Iterator begin, Iterator end) {
@@ -36,7 +49,7 @@ bool sorted (Iterator begin, Iterator end) {
     return true;
 }
 static void unittest_sorted () {
-    { int s[] {};           assert(sorted(&s[0], &s[sizeof(s) / sizeof(*s)]) == true);  }
+    { int s[] { 1, 2 };     assert(sorted(&s[0], &s[0]) == true);  }     // (empty range)
     { int s[] { 1 };        assert(sorted(&s[0], &s[sizeof(s) / sizeof(*s)]) == true);  }
     { int s[] { 1, 2 };     assert(sorted(&s[0], &s[sizeof(s) / sizeof(*s)]) == true);  }
     { int s[] { 1, 1 };     assert(sorted(&s[0], &s[sizeof(s) / sizeof(*s)]) == true);  }
@@ -45,64 +58,268 @@ static void unittest_sorted () {
     { int s[] { 1, 2, 3 };  assert(sorted(&s[0], &s[sizeof(s) / sizeof(*s)]) == true);  }
 }
 
+//
+// Instrumented element type: counts comparisons + swaps.
+// A swap is counted for every temporary constructed from an element (std::swap constructs
+// exactly one; insertion / rotation based sorts construct one per element moved into place).
+//
 
-template <typename T> T randUniform () {
-    return static_cast<T>(rand()) / RAND_MAX;
-}
-template <typename T> T randRange (T min, T max) {
-    return randUniform<T>() * (max - min) + min;
-}
-template <typename T, typename Iterator>
-void randomize (Iterator begin, Iterator end, T min, T max) {
-    for (; begin != end; ++begin) {
-        *begin = randRange(min, max);
+struct SortCounters {
+    size_t comparisons = 0;
+    size_t swaps = 0;
+} g_sortCounters;
+
+struct Counted {
+    double value = 0;
+
+    Counted () {}
+    Counted (double value) : value(value) {}
+    Counted (const Counted& other) : value(other.value) { ++g_sortCounters.swaps; }
+    Counted& operator= (const Counted& other) = default;
+
+    friend bool operator<  (const Counted& a, const Counted& b) { ++g_sortCounters.comparisons; return a.value <  b.value; }
+    friend bool operator>  (const Counted& a, const Counted& b) { ++g_sortCounters.comparisons; return a.value >  b.value; }
+    friend bool operator<= (const Counted& a, const Counted& b) { ++g_sortCounters.comparisons; return a.value <= b.value; }
+    friend bool operator>= (const Counted& a, const Counted& b) { ++g_sortCounters.comparisons; return a.value >= b.value; }
+};
+
+//
+// Input distributions
+//
+
+enum class Input { RANDOM, SORTED, REVERSE, FEW_UNIQUE, ORGAN_PIPE, NEARLY_SORTED };
+const Input ALL_INPUTS[] = {
+    Input::RANDOM, Input::SORTED, Input::REVERSE, Input::FEW_UNIQUE, Input::ORGAN_PIPE, Input::NEARLY_SORTED
+};
+
+const char* inputName (Input input) {
+    switch (input) {
+        case Input::RANDOM:        return "random";
+        case Input::SORTED:        return "sorted";
+        case Input::REVERSE:       return "reverse";
+        case Input::FEW_UNIQUE:    return "few-unique";
+        case Input::ORGAN_PIPE:    return "organ-pipe";
+        case Input::NEARLY_SORTED: return "nearly-sorted";
+        default:                   return "unknown";
     }
 }
 
-template <typename Iterator>
-void show (Iterator begin, Iterator end) {
-    std::cout << "{  ";
-    for (; begin != end; ++begin) {
-        std::cout << *begin << ", ";
+// Generates n values w/ the given distribution. Uses a fixed seed, so runs are comparable.
+std::vector<double> generate (Input input, size_t n) {
+    std::vector<double> data (n);
+    srand(12345);
+    for (size_t i = 0; i < n; ++i) {
+        switch (input) {
+            case Input::RANDOM:        data[i] = static_cast<double>(rand()) / RAND_MAX; break;
+            case Input::SORTED:        data[i] = static_cast<double>(i); break;
+            case Input::REVERSE:       data[i] = static_cast<double>(n - i); break;
+            case Input::FEW_UNIQUE:    data[i] = static_cast<double>(rand() % 8); break;
+            case Input::ORGAN_PIPE:    data[i] = static_cast<double>(i < n / 2 ? i : n - i); break;
+            case Input::NEARLY_SORTED: data[i] = static_cast<double>(i); break;
+        }
     }
-    std::cout << "\b\b}\n";    
+    if (input == Input::NEARLY_SORTED) {
+        for (size_t k = n / 100 + 1; k --> 0; ) {
+            std::swap(data[rand() % n], data[rand() % n]);
+        }
+    }
+    return data;
 }
 
-template <typename F, typename... Args>
-double benchmark (size_t iterations, F fcn, Args... args) {
-    clock_t startTime = clock();
-    for (size_t i = iterations; i --> 0; ) {
-        fcn(args...);
+//
+// Sorts. Each sorts a std::vector<T> in place (copying into / out of other containers
+// outside of the timed region, where necessary).
+//
+
+struct BubbleSortAlgorithm {
+    static const char* name () { return "bubbleSort"; }
+    static bool countsMatchTiming () { return true; }
+    static bool quadratic () { return true; }
+    template <typename T> struct Run {
+        std::vector<T>& data;
+        Run (std::vector<T>& data) : data(data) {}
+        void sort () { bubbleSort(data.begin(), data.end()); }
+        void finish () {}
+    };
+};
+
+struct BubbleSortActorAlgorithm {
+    static const char* name () { return "BubbleSort actor"; }
+    static bool countsMatchTiming () { return true; }
+    static bool quadratic () { return true; }
+    template <typename T> struct Run {
+        std::vector<T>& data;
+        size_t swapCount = 0;
+        Run (std::vector<T>& data) : data(data) {}
+        void sort () {
+            exchangeSort(data.begin(), data.end(), [](const T& a, const T& b) { return a > b; }, swapCount);
+        }
+        void finish () {}
+    };
+};
+
+struct SortableArrayAlgorithm {
+    static const char* name () { return "SortableArray"; }
+    // (Counted has no sorting network, so the counting pass skips the network finisher)
+    static bool countsMatchTiming () { return sortingnetwork::has_network<Counted>::value == sortingnetwork::has_network<double>::value; }
+    static bool quadratic () { return false; }
+    template <typename T> struct Run {
+        std::vector<T>& data;
+        SortableArray<T> array;
+        Run (std::vector<T>& data) : data(data), array(data.size()) {
+            for (size_t i = 0; i < data.size(); ++i) { array[i] = data[i]; }
+        }
+        void sort () { array.sort(data.size()); }
+        void finish () {
+            for (size_t i = 0; i < data.size(); ++i) { data[i] = array[i]; }
+        }
+    };
+};
+
+struct StdSortAlgorithm {
+    static const char* name () { return "std::sort"; }
+    static bool countsMatchTiming () { return true; }
+    static bool quadratic () { return false; }
+    template <typename T> struct Run {
+        std::vector<T>& data;
+        Run (std::vector<T>& data) : data(data) {}
+        void sort () { std::sort(data.begin(), data.end()); }
+        void finish () {}
+    };
+};
+
+//
+// Benchmark runner
+//
+
+struct Result {
+    const char* algorithm;
+    Input       input;
+    size_t      n;
+    double      nsPerElement;
+    size_t      comparisons, swaps;
+    size_t      allocations, bytesAllocated;
+    bool        countsMatchTiming;      // counts were taken on the same code path as the timings
+};
+
+template <typename Algorithm>
+Result benchSort (Input input, size_t n) {
+    Result result { Algorithm::name(), input, n, 0, 0, 0, 0, 0, Algorithm::countsMatchTiming() };
+    auto data = generate(input, n);
+
+    // Timed pass (best of a few repetitions for small inputs)
+    size_t repetitions = n <= 10000 ? 5 : 1;
+    double best = 0;
+    for (size_t i = 0; i < repetitions; ++i) {
+        std::vector<double> copy = data;
+        typename Algorithm::template Run<double> run (copy);
+
+        LocalMemoryTracer memory;
+        memory.enter();
+        auto t0 = std::chrono::high_resolution_clock::now();
+        run.sort();
+        auto t1 = std::chrono::high_resolution_clock::now();
+        memory.exit();
+
+        run.finish();
+        if (!sorted(&copy[0], &copy[0] + n)) {
+            std::cerr << "FAILED: " << Algorithm::name() << " did not sort " << inputName(input) << " input (n = " << n << ")" << std::endl;
+            exit(-1);
+        }
+        double elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(t1 - t0).count();
+        if (i == 0 || elapsed < best) { best = elapsed; }
+        result.allocations    = memory.usedAllocs;
+        result.bytesAllocated = memory.usedMemory;
+    }
+    result.nsPerElement = best * 1e9 / n;
+
+    // Counting pass
+    {
+        std::vector<Counted> counted (data.begin(), data.end());
+        typename Algorithm::template Run<Counted> run (counted);
+        g_sortCounters = SortCounters();
+        run.sort();
+        result.comparisons = g_sortCounters.comparisons;
+        result.swaps       = g_sortCounters.swaps;
     }
-    clock_t endTime = clock();
-    return static_cast<double>(endTime - startTime) / CLOCKS_PER_SEC * 1e3 / iterations;
+    return result;
 }
 
+void writeResult (std::ostream& os, const Result& result) {
+    os << std::setw(17) << result.algorithm
+       << std::setw(15) << inputName(result.input)
+       << std::setw(9)  << result.n
+       << std::setw(12) << std::setprecision(4) << result.nsPerElement
+       << std::setw(14) << result.comparisons
+       << std::setw(14) << result.swaps
+       << (result.countsMatchTiming ? ' ' : '*')
+       << std::setw(7)  << result.allocations
+       << '\n';
+}
+void writeCsvResult (std::ostream& os, const Result& result) {
+    os << result.algorithm << ',' << inputName(result.input) << ',' << result.n << ','
+       << result.nsPerElement << ',' << result.comparisons << ',' << result.swaps << ','
+       << result.allocations << ',' << result.bytesAllocated << ',' << result.countsMatchTiming << '\n';
+}
+
+template <typename Algorithm>
+void benchAlgorithm (const std::vector<size_t>& sizes, std::ostream* csv) {
+    const size_t QUADRATIC_LIMIT = 8000;    // skip O(n^2) sorts above this size
+    for (auto input : ALL_INPUTS) {
+        for (auto n : sizes) {
+            if (Algorithm::quadratic() && n > QUADRATIC_LIMIT) {
+                continue;
+            }
+            Result result = benchSort<Algorithm>(input, n);
+            writeResult(std::cout, result);
+            if (csv) { writeCsvResult(*csv, result); }
+        }
+    }
+}
 
-int main () {
+int main (int argc, const char** argv) {
     std::cout << "Programmer: Seiji Emery\n"
               << "Programmer's id: M00202623\n"
               << "File: " __FILE__ "\n\n";
     unittest_sorted();
-    srand(time(nullptr));
 
-    std::cout << "Bubble sort runtimes (quadratic):\n";
-
-    double expected = 0.0;
-    for (auto n = 64, k = 10; k --> 0; n *= 2) {
-        double* array = new double[n];
-        randomize(&array[0], &array[n], 0.0, 1.0);
-        auto runtime = benchmark(1, [&](){ bubbleSort(&array[0], &array[n]); });
-        assert(sorted(&array[0], &array[n]));
-        //show(&array[0], &array[n]);
-        delete[] array;
-
-        std::cout << "sorted " << std::setw(6) << n << " items in "
-            << std::setw(8) << runtime << " ms / run  expected ";
-        if (expected == 0) std::cout << "O(n^2)\n";
-        else               std::cout << expected << '\n';
+    const char* csvPath = nullptr;
+    size_t maxSize = 1000000;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csvPath = argv[++i];
+        } else if (strcmp(argv[i], "--max") == 0 && i + 1 < argc) {
+            maxSize = (size_t)atol(argv[++i]);
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--csv <path>] [--max <n>]" << std::endl;
+            exit(-1);
+        }
+    }
+    std::vector<size_t> sizes;
+    for (size_t n = 1000; n <= maxSize; n *= 4) {
+        sizes.push_back(n);
+    }
 
-        expected = runtime * 2;
+    std::ofstream csvFile;
+    std::ostream* csv = nullptr;
+    if (csvPath) {
+        csvFile.open(csvPath);
+        if (!csvFile) {
+            std::cerr << "Could not open '" << csvPath << "' for writing" << std::endl;
+            exit(-1);
+        }
+        csvFile << "algorithm,input,n,ns_per_element,comparisons,swaps,allocations,bytes_allocated,counts_match_timing\n";
+        csv = &csvFile;
     }
+
+    std::cout << std::setw(17) << "algorithm" << std::setw(15) << "input" << std::setw(9) << "n"
+              << std::setw(12) << "ns/elem" << std::setw(14) << "comparisons" << std::setw(14) << "swaps"
+              << std::setw(8) << "allocs" << '\n';
+    benchAlgorithm<BubbleSortAlgorithm>(sizes, csv);
+    benchAlgorithm<BubbleSortActorAlgorithm>(sizes, csv);
+    benchAlgorithm<SortableArrayAlgorithm>(sizes, csv);
+    benchAlgorithm<StdSortAlgorithm>(sizes, csv);
+    std::cout << "\n* comparisons / swaps counted on a different path than the one timed (SortableArray:\n"
+              << "  plain quicksort; the timed doubles finish small partitions w/ sorting networks)\n";
     return 0;
 }
@@ -7,6 +7,7 @@
 #include <iostream>     // cerr, cout
 #include <string>       // string
 #include <cstring>
+#include <algorithm>    // std::is_sorted
 using namespace std;
 
 #include "AssociativeArray.h"
@@ -15,6 +16,8 @@ using namespace std;
 
 template <typename AA, typename Key, typename Value>
 void _testAAImpl (const char*, const Key[], const Value[]);
+void _testSortedAA ();
+template <typename Strategy> void _testFrozenAA (const char*);
 
 #define TEST_AA_IMPL(AA, S, K, V, keys, values) \
     _testAAImpl<AA<K,V,S>>(#AA "<" #K ", " #V ", " #S ">", keys, values)
@@ -53,6 +56,10 @@ int main () {
 
     TEST_WITH_STRATEGY(AssociativeArray, AADefaultStrategy)
     TEST_WITH_STRATEGY(AssociativeArray, AAFastBinaryStrategy)
+    TEST_WITH_STRATEGY(AssociativeArray, AASortedStrategy)
+    _testSortedAA();
+    _testFrozenAA<AADefaultStrategy>("AADefaultStrategy");
+    _testFrozenAA<AASortedStrategy>("AASortedStrategy");
     std::cout << "\033[32mAll tests passed\n\033[0m";
     return 0;
 }
@@ -268,3 +275,111 @@ void _testAAImpl (
         }
     }
 }
+
+template <typename AA>
+std::string _keysOf (const AA& dict) {
+    std::string keys;
+    for (const auto& kv : dict) {
+        keys += kv.first;
+    }
+    return keys;
+}
+
+void _testSortedAA () {
+    SECTION("Testing AssociativeArray<std::string, int, AASortedStrategy> ordering") {
+        AssociativeArray<std::string, int, AASortedStrategy> dict;
+        SECTION("Iteration is sorted by key") {
+            for (const char* key : { "d", "b", "e", "a", "c" }) {
+                dict[std::string(key)] = key[0] - 'a';
+            }
+            ASSERT_EQ(dict.size(), 5);
+            ASSERT_EQ(_keysOf(dict), "abcde");
+            ASSERT_EQ(dict[std::string("c")], 2);
+        }
+        SECTION("Removal keeps order") {
+            dict.deleteKey("b");
+            dict.deleteKey("e");
+            ASSERT_EQ(dict.size(), 3);
+            ASSERT_EQ(_keysOf(dict), "acd");
+        }
+        SECTION("Bulk insert merges, dedupes, and later values win") {
+            dict.insert({ { "f", 1 }, { "b", 2 }, { "a", 3 }, { "f", 4 }, { "b", 5 } });
+            ASSERT_EQ(dict.size(), 5);
+            ASSERT_EQ(_keysOf(dict), "abcdf");
+            ASSERT_EQ(dict[std::string("a")], 3);
+            ASSERT_EQ(dict[std::string("b")], 5);
+            ASSERT_EQ(dict[std::string("f")], 4);
+            ASSERT_EQ(dict[std::string("d")], 3);
+        }
+    }
+    SECTION("Testing AssociativeArray<int, int, AASortedStrategy> (memmove path)") {
+        AssociativeArray<int, int, AASortedStrategy> dict;
+        for (int i = 0; i < 1000; ++i) {
+            int key = (i * 7919) % 1000;
+            dict[key] = i;
+        }
+        ASSERT_EQ(dict.size(), 1000);
+        bool sorted = std::is_sorted(dict.begin(), dict.end(),
+            [](const std::pair<int, int>& a, const std::pair<int, int>& b) { return a.first < b.first; });
+        ASSERT_EQ(sorted, true);
+        for (int i = 0; i < 1000; i += 2) {
+            dict.deleteKey(i);
+        }
+        ASSERT_EQ(dict.size(), 500);
+        ASSERT_EQ(dict.begin()->first, 1);
+        ASSERT_EQ(dict.containsKey(998), false);
+        ASSERT_EQ(dict.containsKey(999), true);
+    }
+}
+
+template <typename Strategy>
+void _testFrozenAA (const char* strategyName) {
+    SECTION("Testing freeze() w/ " << strategyName) {
+        SECTION("Frozen lookups find every key (and no others) for sizes 0..100") {
+            size_t failures = 0;
+            for (int n = 0; n <= 100; ++n) {
+                AssociativeArray<int, int, Strategy> dict;
+                for (int i = 0; i < n; ++i) {
+                    int key = (i * 7919) % n;     // (7919 is prime, so this is a permutation)
+                    dict[2 * key] = key;
+                }
+                dict.freeze();
+                for (int key = -1; key <= 2 * n; ++key) {
+                    bool expected = key >= 0 && key % 2 == 0 && key < 2 * n;
+                    if (dict.containsKey(key) != expected) ++failures;
+                    if (expected && dict[key] != key / 2) ++failures;
+                }
+            }
+            ASSERT_EQ(failures, 0);
+        }
+        AssociativeArray<std::string, int, Strategy> dict;
+        for (const char* key : { "MATH-1", "ENGL-1A", "CHEM-120", "ART-3", "BIOL-110" }) {
+            dict[std::string(key)] = 1;
+        }
+        dict.freeze();
+        SECTION("Freezing sorts the elements") {
+            std::string keys;
+            for (const auto& kv : dict) keys += kv.first + " ";
+            ASSERT_EQ(keys, "ART-3 BIOL-110 CHEM-120 ENGL-1A MATH-1 ");
+            ASSERT_EQ(dict.isFrozen(), true);
+        }
+        SECTION("Assigning to existing keys keeps the index") {
+            dict[std::string("CHEM-120")] = 5;
+            ASSERT_EQ(dict.isFrozen(), true);
+            ASSERT_EQ(dict[std::string("CHEM-120")], 5);
+            bool found = dict.containsKey("PHYS-130");
+            ASSERT_EQ(found, false);
+        }
+        SECTION("Inserting / deleting keys drops the index") {
+            dict[std::string("PHYS-130")] = 2;
+            ASSERT_EQ(dict.isFrozen(), false);
+            ASSERT_EQ(dict[std::string("PHYS-130")], 2);
+            dict.freeze();
+            dict.deleteKey("ART-3");
+            ASSERT_EQ(dict.isFrozen(), false);
+            bool found = dict.containsKey("ART-3");
+            ASSERT_EQ(found, false);
+            ASSERT_EQ(dict.size(), 5);
+        }
+    }
+}
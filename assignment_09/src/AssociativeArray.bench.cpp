@@ -0,0 +1,252 @@
+// Programmer: Seiji Emery
+// Programmer ID: M00202623
+//
+// AssociativeArray.bench.cpp
+//
+// Compares the AssociativeArray insert strategies: AADefaultStrategy (unordered, linear search)
+// vs AASortedStrategy (sorted flat map, binary search), for 10 to 100k keys. Reports ns / op for:
+//
+//  – insert:      operator[] on n distinct keys, in random order
+//  – bulk insert: insert(begin, end) w/ the same n keys (append + sort + dedupe for sorted)
+//  – lookup hit:  containsKey() for keys that are present
+//  – lookup miss: containsKey() for keys that aren't
+//
+// w/ int keys and w/ short std::string keys (like the DVC subjects). Inserts into small maps are
+// repeated (into a cleared map, so its storage is reused); the # of lookups per size is scaled
+// down for large n so the linear strategy finishes in reasonable time.
+//
+// Part 2 compares read-only lookups (1k to 1M keys, bulk loaded) in a frozen AssociativeArray
+// (freeze(): branchless Eytzinger search w/ prefetching) vs. the sorted strategy's binary search
+// and std::map::find:
+//
+//  – throughput: independent lookups of random keys (the CPU can overlap several searches)
+//  – latency:    each lookup's key depends on the previous lookup's value (no overlap)
+//
+// Build (from the repo root):
+//   g++ -std=c++11 -O3 -DNDEBUG -Iassignment_09/src -Iassignment_03/src -Iassignment_07/src \
+//       assignment_09/src/AssociativeArray.bench.cpp -o aa_bench
+//
+// Remote source:
+// https://github.com/SeijiEmery/comp220/tree/master/assignment_09/src/AssociativeArray.bench.cpp
+//
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include "AssociativeArray.h"
+
+template <typename F>
+double measureNs (size_t ops, const F& f) {
+    using namespace std::chrono;
+    auto t0 = high_resolution_clock::now();
+    f();
+    auto t1 = high_resolution_clock::now();
+    return duration_cast<duration<double>>(t1 - t0).count() * 1e9 / ops;
+}
+
+void require (bool cond, const char* what) {
+    if (!cond) {
+        std::cerr << "FAILED: " << what << std::endl;
+        exit(-1);
+    }
+}
+
+// Key generation: n distinct present keys (shuffled) + n keys that are never inserted
+template <typename Key> Key makeKey (size_t i);
+template <> int makeKey<int> (size_t i) { return (int)(i * 2); }
+template <> std::string makeKey<std::string> (size_t i) {
+    // "AAAA-1" style subject / section keys, 4 - 8 chars
+    std::string key;
+    for (size_t j = i * 2; ; j /= 26) {
+        key += char('A' + j % 26);
+        if (j < 26) break;
+    }
+    return key + "-" + std::to_string(i % 10);
+}
+template <typename Key> Key makeMissingKey (size_t i) { return makeKey<Key>(i) + Key(1); }
+template <> std::string makeMissingKey<std::string> (size_t i) { return makeKey<std::string>(i) + "x"; }
+
+struct Row {
+    double insert, bulkInsert, lookupHit, lookupMiss;
+};
+
+template <typename Key, typename Strategy>
+Row benchStrategy (const std::vector<Key>& keys, const std::vector<Key>& missing, size_t lookups) {
+    typedef AssociativeArray<Key, int, Strategy> Dict;
+    typedef std::pair<Key, int> KV;
+    size_t n = keys.size();
+    size_t reps = std::max<size_t>(1, 10000 / n);   // (small n: repeat to get above timer resolution)
+    Row row;
+
+    Dict dict;
+    row.insert = measureNs(n * reps, [&]() {
+        for (size_t r = 0; r < reps; ++r) {
+            dict.clear();
+            for (size_t i = 0; i < n; ++i) {
+                dict[keys[i]] = (int)i;
+            }
+        }
+    });
+    require(dict.size() == n, "insert: wrong size");
+
+    std::vector<KV> pairs;
+    for (size_t i = 0; i < n; ++i) pairs.push_back({ keys[i], (int)i });
+    Dict bulk;
+    row.bulkInsert = measureNs(n * reps, [&]() {
+        for (size_t r = 0; r < reps; ++r) {
+            bulk.clear();
+            bulk.insert(pairs.begin(), pairs.end());
+        }
+    });
+    require(bulk.size() == n, "bulk insert: wrong size");
+
+    size_t found = 0;
+    row.lookupHit = measureNs(lookups, [&]() {
+        for (size_t i = 0; i < lookups; ++i) {
+            found += dict.containsKey(keys[(i * 7919) % n]);
+        }
+    });
+    require(found == lookups, "lookup: key not found");
+
+    found = 0;
+    row.lookupMiss = measureNs(lookups, [&]() {
+        for (size_t i = 0; i < lookups; ++i) {
+            found += dict.containsKey(missing[(i * 7919) % n]);
+        }
+    });
+    require(found == 0, "lookup: found missing key");
+    return row;
+}
+
+void writeRow (const char* name, size_t n, const Row& row) {
+    std::cout << "  " << std::setw(10) << std::left << name << std::right
+        << std::setw(8) << n
+        << std::fixed << std::setprecision(1)
+        << std::setw(12) << row.insert
+        << std::setw(12) << row.bulkInsert
+        << std::setw(12) << row.lookupHit
+        << std::setw(12) << row.lookupMiss << '\n';
+}
+
+template <typename Key>
+void benchKeys (const char* keyName) {
+    std::cout << "\nAssociativeArray<" << keyName << ", int> (ns / op):\n"
+        << "  " << std::setw(10) << std::left << "strategy" << std::right
+        << std::setw(8) << "keys" << std::setw(12) << "insert" << std::setw(12) << "bulk insert"
+        << std::setw(12) << "lookup hit" << std::setw(12) << "lookup miss" << '\n';
+
+    std::mt19937 rng (220);
+    for (size_t n : { 10, 100, 1000, 10000, 100000 }) {
+        std::vector<Key> keys, missing;
+        for (size_t i = 0; i < n; ++i) {
+            keys.push_back(makeKey<Key>(i));
+            missing.push_back(makeMissingKey<Key>(i));
+        }
+        std::shuffle(keys.begin(), keys.end(), rng);
+
+        size_t lookups = std::max<size_t>(1000, std::min<size_t>(1000000, 100000000 / n));
+        writeRow("linear", n, benchStrategy<Key, AADefaultStrategy>(keys, missing, lookups));
+        writeRow("sorted", n, benchStrategy<Key, AASortedStrategy>(keys, missing, lookups));
+    }
+}
+
+//
+// Part 2: frozen (read-only) lookups
+//
+
+struct LookupRow {
+    double throughput, latency;     // ns / lookup
+};
+
+// lookup(key) -> the value stored for key (its index in keys)
+template <typename Key, typename Lookup>
+LookupRow benchLookups (const std::vector<Key>& keys, const std::vector<size_t>& order, size_t lookups, const Lookup& lookup) {
+    size_t n = keys.size();
+    LookupRow row;
+    size_t sum = 0;
+    row.throughput = measureNs(lookups, [&]() {
+        for (size_t i = 0; i < lookups; ++i) {
+            sum += lookup(keys[order[i % n]]);
+        }
+    });
+    size_t expected = 0;
+    for (size_t i = 0; i < lookups; ++i) expected += order[i % n];
+    require(sum == expected, "lookup returned the wrong value");
+
+    size_t j = 0;
+    row.latency = measureNs(lookups, [&]() {
+        for (size_t i = 0; i < lookups; ++i) {
+            j = order[(lookup(keys[j]) + i) % n];
+        }
+    });
+    require(j < n, "lookup chain");
+    return row;
+}
+
+void writeLookupRow (const char* name, size_t n, const LookupRow& row) {
+    std::cout << "  " << std::setw(16) << std::left << name << std::right
+        << std::setw(9) << n
+        << std::fixed << std::setprecision(1)
+        << std::setw(14) << row.throughput
+        << std::setw(14) << row.latency << '\n';
+}
+
+template <typename Key>
+void benchFrozenLookups (const char* keyName, size_t maxKeys) {
+    std::cout << "\nRead-only lookups, " << keyName << " keys (ns / lookup):\n"
+        << "  " << std::setw(16) << std::left << "container" << std::right
+        << std::setw(9) << "keys" << std::setw(14) << "throughput" << std::setw(14) << "latency" << '\n';
+
+    std::mt19937 rng (220);
+    for (size_t n = 1000; n <= maxKeys; n *= 10) {
+        std::vector<Key> keys;
+        std::vector<std::pair<Key, int>> pairs;
+        std::vector<size_t> order;
+        for (size_t i = 0; i < n; ++i) {
+            keys.push_back(makeKey<Key>(i));
+            pairs.push_back({ keys.back(), (int)i });
+            order.push_back(i);
+        }
+        std::shuffle(order.begin(), order.end(), rng);
+        size_t lookups = std::max<size_t>(n, 1000000);
+
+        std::map<Key, int> map (pairs.begin(), pairs.end());
+        writeLookupRow("std::map", n, benchLookups(keys, order, lookups, [&](const Key& key) {
+            return (size_t)map.find(key)->second;
+        }));
+
+        AssociativeArray<Key, int, AASortedStrategy> dict;
+        dict.insert(pairs.begin(), pairs.end());
+        const auto& constDict = dict;
+        writeLookupRow("binary search", n, benchLookups(keys, order, lookups, [&](const Key& key) {
+            return (size_t)constDict[key];
+        }));
+
+        dict.freeze();
+        require(dict.isFrozen(), "freeze()");
+        writeLookupRow("frozen", n, benchLookups(keys, order, lookups, [&](const Key& key) {
+            return (size_t)constDict[key];
+        }));
+    }
+}
+
+int main () {
+    std::cout << "Programmer: Seiji Emery\n"
+              << "Programmer's id: M00202623\n"
+              << "File: " __FILE__ "\n";
+
+    std::cout << "\nPart 1: linear vs sorted strategy\n";
+    benchKeys<int>("int");
+    benchKeys<std::string>("std::string");
+
+    std::cout << "\nPart 2: frozen lookups\n";
+    benchFrozenLookups<int>("int", 1000000);
+    benchFrozenLookups<std::string>("std::string", 100000);
+    return 0;
+}
@@ -2,8 +2,11 @@
 // Programmer ID: M00202623
 //
 // AssociativeArray.h
-// Implements a simple O(N) associative array as a DynamicArray<std::pair<K, V>>,
-// with all the expected operations for a dictionary type.
+// Implements a simple associative array as a DynamicArray<std::pair<K, V>>,
+// with all the expected operations for a dictionary type. Lookup / insertion is
+// O(N) (unordered, linear search) by default, or O(log N) lookup w/ sorted
+// iteration using AASortedStrategy. Read-mostly maps can be freeze()-d into a
+// branchless Eytzinger search index.
 //
 // Remote source:
 // https://github.com/SeijiEmery/comp220/tree/master/assignment_09/src/AssociativeArray.hpp
@@ -11,10 +14,24 @@
 
 #ifndef AssociativeArray_h
 #define AssociativeArray_h
-#include <algorithm>        // std::lower_bound
+#include <algorithm>        // std::lower_bound, std::stable_sort, std::inplace_merge, std::sort
+#include <cstring>          // memmove
+#include <cstdint>          // uint32_t
+#include <type_traits>      // std::is_trivially_copyable
+#include <utility>          // std::pair
 #include "DynamicArray.h"
 #include "Queue.h"
 
+//
+// Insert strategies: control how elements are laid out in the array. Each implements
+//  locate (elements, key, n):        index of key in elements[0, n), or n if not present
+//  insert (elements, kv, i, n):      stores kv (i = locate(kv.first), ie. n for a new key);
+//                                    returns the index kv ended up at
+//  erase  (elements, i, n):          removes elements[i]
+//  insertRange (elements, first, last, n): inserts all of [first, last) (later values win)
+//
+
+// Unordered array w/ linear search (O(n) lookup + insert, O(1) erase)
 struct AADefaultStrategy {
     template <typename KV, typename Key>
     static size_t locate (
@@ -30,7 +47,7 @@ struct AADefaultStrategy {
         return n;
     }
     template <typename KV>
-    static void insert (
+    static size_t insert (
         DynamicArray<KV>& elements,
         const KV& kv,
         size_t  i,
@@ -38,35 +55,145 @@ struct AADefaultStrategy {
     ) {
         elements[i] = kv;
         if (i == n) { ++n; }
+        return i;
+    }
+    template <typename KV>
+    static void erase (
+        DynamicArray<KV>& elements,
+        size_t  i,
+        size_t& n
+    ) {
+        std::swap(elements[i], elements[--n]);
+    }
+    template <typename KV, typename It>
+    static void insertRange (
+        DynamicArray<KV>& elements,
+        It first, It last,
+        size_t& n
+    ) {
+        for (; first != last; ++first) {
+            insert(elements, *first, locate(elements, first->first, n), n);
+        }
     }
 };
 
+// Sorted array (flat map) w/ binary search: O(log n) lookup, O(n) insert / erase (one
+// memmove for trivially copyable elements), and iteration visits keys in sorted order.
+// Bulk inserts append everything, then sort + merge + dedupe once (O((n + m) + m log m)
+// instead of O(n * m)).
+struct AASortedStrategy {
+    template <typename KV>
+    struct KeyLess {
+        template <typename Key>
+        bool operator() (const KV& a, const Key& key) const { return a.first < key; }
+        bool operator() (const KV& a, const KV& b) const { return a.first < b.first; }
+    };
+
+    // std::pair isn't trivially copyable (user-defined operator=), but a pair of trivially
+    // copyable types can still be shifted w/ memmove
+    template <typename T>
+    struct CanMemmove : std::is_trivially_copyable<T> {};
+    template <typename K, typename V>
+    struct CanMemmove<std::pair<K, V>> : std::integral_constant<bool,
+        std::is_trivially_copyable<K>::value && std::is_trivially_copyable<V>::value> {};
 
-struct AAFastBinaryStrategy {
+    // Moves elements[i, n) to elements[i + 1, n + 1); elements[n] must already be constructed
+    template <typename KV>
+    static void shiftRight (KV* data, size_t i, size_t n, std::true_type) {
+        memmove(static_cast<void*>(&data[i + 1]), &data[i], (n - i) * sizeof(KV));
+    }
+    template <typename KV>
+    static void shiftRight (KV* data, size_t i, size_t n, std::false_type) {
+        std::move_backward(&data[i], &data[n], &data[n + 1]);
+    }
+    // Moves elements[i + 1, n) to elements[i, n - 1)
+    template <typename KV>
+    static void shiftLeft (KV* data, size_t i, size_t n, std::true_type) {
+        memmove(static_cast<void*>(&data[i]), &data[i + 1], (n - i - 1) * sizeof(KV));
+    }
+    template <typename KV>
+    static void shiftLeft (KV* data, size_t i, size_t n, std::false_type) {
+        std::move(&data[i + 1], &data[n], &data[i]);
+    }
+
+    template <typename KV, typename Key>
+    static size_t lowerBound (const DynamicArray<KV>& elements, const Key& key, size_t n) {
+        const KV* begin = elements.data();
+        return static_cast<size_t>(std::lower_bound(begin, begin + n, key, KeyLess<KV>()) - begin);
+    }
     template <typename KV, typename Key>
     static size_t locate (
         const DynamicArray<KV>& elements,
         const Key& key,
         size_t n
     ) {
-        const KV* end    = &(elements[n]);
-        const KV* begin  = &(elements[0]);
-        auto ptr   = std::upper_bound(begin, end, KV(key, {}), [](const KV& a, const KV& b) { return a.first < b.first; });
-        return static_cast<size_t>(ptr - begin);
+        size_t i = lowerBound(elements, key, n);
+        return i != n && elements.unchecked(i).first == key ? i : n;
     }
     template <typename KV>
-    static void insert (
+    static size_t insert (
         DynamicArray<KV>& elements,
         const KV& kv,
         size_t  i,
         size_t& n
     ) {
-        elements[i] = kv;
-        if (i == n) { ++n; }
+        if (i != n) {
+            elements.unchecked(i) = kv;
+            return i;
+        }
+        i = lowerBound(elements, kv.first, n);
+        KV temp (kv);                   // (kv may live in elements)
+        elements[n];                    // grows the array (geometrically) to hold n + 1 elements
+        shiftRight(elements.data(), i, n, CanMemmove<KV>());
+        elements.unchecked(i) = std::move(temp);
+        ++n;
+        return i;
+    }
+    template <typename KV>
+    static void erase (
+        DynamicArray<KV>& elements,
+        size_t  i,
+        size_t& n
+    ) {
+        shiftLeft(elements.data(), i, n, CanMemmove<KV>());
+        --n;
+    }
+    template <typename KV, typename It>
+    static void insertRange (
+        DynamicArray<KV>& elements,
+        It first, It last,
+        size_t& n
+    ) {
+        size_t end = n;
+        for (; first != last; ++first) {
+            elements[end++] = *first;
+        }
+        if (end == n) return;
+
+        // Sort the new elements (stable, so later duplicates stay after earlier ones), and
+        // merge them w/ the existing (sorted) elements; existing elements sort before new ones
+        // w/ equal keys.
+        KV* data = elements.data();
+        std::stable_sort(data + n, data + end, KeyLess<KV>());
+        std::inplace_merge(data, data + n, data + end, KeyLess<KV>());
+
+        // Dedupe: keep the last element of each run of equal keys
+        size_t out = 0;
+        for (size_t i = 0; i < end; ++i) {
+            if (i + 1 == end || data[i].first < data[i + 1].first) {
+                if (out != i) data[out] = std::move(data[i]);
+                ++out;
+            }
+        }
+        n = out;
     }
 };
 
-/* Unordered associative array */
+// Originally an (incomplete) binary search strategy: it searched w/ upper_bound, but
+// never kept the array sorted. Now just an alias for the sorted strategy.
+typedef AASortedStrategy AAFastBinaryStrategy;
+
+/* Associative array (unordered w/ AADefaultStrategy, sorted by key w/ AASortedStrategy) */
 template <typename Key, typename Value, typename InsertStrategy = AADefaultStrategy>
 class AssociativeArray {
     typedef AssociativeArray<Key,Value,InsertStrategy>  This;
@@ -75,34 +202,110 @@ class AssociativeArray {
     DynamicArray<KV>    elements;
     size_t              count = 0;        // num unique elements
     const Value         defaultValue;
+
+    // Read-only search index, built by freeze(): a copy of the keys in Eytzinger (BFS) order
+    // (1-based: the children of node k are 2k and 2k + 1), each w/ the index of its element
+    // (stored next to the key, so a hit doesn't take another cache miss to find its value).
+    struct FrozenNode {
+        Key      key;
+        uint32_t index;
+    };
+    DynamicArray<FrozenNode> frozenNodes;
+    bool                     frozen = false;
+
+    // # of nodes per cache line: the descendants of node k, d levels down, are the 2^d nodes
+    // starting at 2^d * k; prefetching there (for 2^d nodes per line) fetches all of them at
+    // once, d levels before the search needs them.
+    static const size_t prefetchStride = sizeof(FrozenNode) < 64 ? 64 / sizeof(FrozenNode) : 1;
 public:
     AssociativeArray () : defaultValue() {}
     AssociativeArray (const std::initializer_list<KV>& values) { insert(values); }
-    AssociativeArray (const This& other) : elements(other.elements), count(other.count), defaultValue() {}
-    This& operator=  (const This& other) { elements = other.elements; count = other.count; return *this; }
+    AssociativeArray (const This& other)
+        : elements(other.elements), count(other.count), defaultValue(),
+          frozenNodes(other.frozenNodes), frozen(other.frozen) {}
+    This& operator=  (const This& other) {
+        elements = other.elements; count = other.count;
+        frozenNodes = other.frozenNodes; frozen = other.frozen;
+        return *this;
+    }
     ~AssociativeArray () { clear(); }
 
     // Move operations
     AssociativeArray (This&& other) : AssociativeArray() { *this = std::move(other); }
-    This& operator=  (This&& other) { std::swap(elements, other.elements); std::swap(count, other.count); return *this; }
+    This& operator=  (This&& other) {
+        std::swap(elements, other.elements); std::swap(count, other.count);
+        std::swap(frozenNodes, other.frozenNodes); std::swap(frozen, other.frozen);
+        return *this;
+    }
 private:
-    size_t find (const Key& key) const { return InsertStrategy::locate(elements, key, count); }
-    void insert (size_t i, const KV& kv) { InsertStrategy::insert(elements, kv, i, count); }
+    size_t find (const Key& key) const {
+        return frozen ? findFrozen(key) : InsertStrategy::locate(elements, key, count);
+    }
+    size_t insert (size_t i, const KV& kv) {
+        if (i == count) { frozen = false; }     // (overwriting an existing key doesn't move it)
+        return InsertStrategy::insert(elements, kv, i, count);
+    }
+
+    // Branchless Eytzinger search: descends left / right w/out any data dependent branches
+    // (the comparison result is just added to the index), prefetching 4 levels ahead.
+    size_t findFrozen (const Key& key) const {
+        const FrozenNode* nodes = frozenNodes.data();
+        size_t k = 1;
+        while (k <= count) {
+            // (may point past the end of the array; prefetches never fault)
+            __builtin_prefetch(reinterpret_cast<const char*>(nodes) + k * prefetchStride * sizeof(FrozenNode));
+            k = 2 * k + (nodes[k].key < key);
+        }
+        // k went right at every level after the lower bound; undo those steps + the final left
+        k >>= __builtin_ffsll(~static_cast<unsigned long long>(k));
+        return k && nodes[k].key == key ? nodes[k].index : count;
+    }
+    void buildFrozen (size_t& i, size_t k) {
+        if (k <= count) {
+            buildFrozen(i, 2 * k);
+            frozenNodes.unchecked(k).key = elements.unchecked(i).first;
+            frozenNodes.unchecked(k).index = static_cast<uint32_t>(i);
+            ++i;
+            buildFrozen(i, 2 * k + 1);
+        }
+    }
 public:
     size_t size () const { return count; }
     operator bool () const { return count != 0; }
-    void  clear () { count = 0; }
+    void  clear () { count = 0; frozen = false; }
+
+    // Builds a read-only search index for the current keys (for maps that are filled once, then
+    // only queried): lookups become a branchless search over a cache-friendly (Eytzinger)
+    // layout instead of the strategy's linear / binary search. Sorts the elements by key first
+    // (a no-op for AASortedStrategy), so iteration is ordered afterwards.
+    //
+    // Assigning to existing keys keeps the index; inserting or deleting keys drops it (lookups
+    // fall back to the strategy until freeze() is called again). Reordering elements through
+    // iterators (eg. std::sort) while frozen is NOT detected; call unfreeze() / freeze() after.
+    void freeze () {
+        KV* data = elements.data();
+        auto byKey = [](const KV& a, const KV& b) { return a.first < b.first; };
+        if (!std::is_sorted(data, data + count, byKey)) {
+            std::sort(data, data + count, byKey);
+        }
+        frozenNodes.resize(count + 1);
+        size_t i = 0;
+        buildFrozen(i, 1);
+        frozen = true;
+    }
+    void unfreeze () { frozen = false; }
+    bool isFrozen () const { return frozen; }
 
     Value& operator[] (const Key& key) {
         auto i = find(key);
         if (i == count) {
-            insert(i, { key, {}});
+            i = insert(i, { key, {}});
         }
         return elements[i].second;
     }
     const Value& operator[] (const Key& key) const {
         auto i = find(key);
-        if (i == count) { return elements[i].second; }
+        if (i != count) { return elements[i].second; }
         else            { return defaultValue; }
     }
     bool containsKey (const Key& key) {
@@ -111,7 +314,8 @@ public:
     void deleteKey (const Key& key) {
         auto i = find(key);
         if (i != count) {
-            std::swap(elements[i], elements[--count]);
+            frozen = false;
+            InsertStrategy::erase(elements, i, count);
         }
     }
     void insert (const std::initializer_list<KV>& values) {
@@ -122,9 +326,8 @@ public:
     }
     template <typename It>
     void insert (It begin, It end) {
-        for (; begin != end; ++begin) {
-            insert(*begin);
-        }
+        frozen = false;
+        InsertStrategy::insertRange(elements, begin, end, count);
     }
 
     // Required as part of assignment spec, but not used (is super inefficient,
@@ -162,7 +365,7 @@ public:
     iterator begin () { auto reserve = end(); return &elements[0]; }
     iterator end   () { return &elements[count]; }
     const_iterator begin () const { auto reserve = end(); return &elements[0]; }
-    const_iterator end   () const { return &elements[count]; }
+    const_iterator end   () const { return &elements[0] + count; }
 };
 
 #endif // AssociativeArray_h
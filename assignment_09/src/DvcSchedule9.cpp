@@ -6,6 +6,10 @@
 // Implements a modified DVC parser that displays subjects / sections as a hierarchical tree.
 // Also demonstrates the use of AssociativeArray.
 //
+// If the schedule has a valid, up to date binary cache (<path>.cache, written by dvc_convert; see
+// assignment_08's DvcCache.h, so ../assignment_08/src must be on the include path), its columns
+// are read instead of parsing the text.
+//
 // remote source: https://github.com/SeijiEmery/comp220/blob/master/assignment_09/src/DvcSchedule9.cpp
 //
 #include <iostream>
@@ -17,9 +21,11 @@
 #include <type_traits>
 #include <ctime>
 #include <cmath>
+#include <cctype>
 
 #include "AssociativeArray.h"
 #include "DynamicArray.h"
+#include <DvcCache.h>
 
 //
 // Utilities
@@ -117,18 +123,22 @@ bool parse (const char* file, size_t line_num, const char* line, ParseResult& re
         case PACK_STR_4('W','i','n','t'): require("expected season", (((uint32_t*)line)[1] & 0x00FFFFFF) == PACK_STR_4('e','r',' ','\0')); line += 7; semester = 3; break;
         default: return false;
     }
-    require("expected year", isnumber(line[0]) && line[4] == '\t');
-    result.hash = semester | (((_4atoi(line) - 2000) & 31) << 2);
+    // (years + sections are exactly 4 digits, and years in the binary cache's range, so the text
+    // + the cache (DvcCache.h) load the same rows)
+    require("expected year", isdigit(line[0]) && isdigit(line[1]) && isdigit(line[2]) && isdigit(line[3]) && line[4] == '\t');
+    size_t year = _4atoi(line);
+    require("expected year", year >= DvcCacheHeader::MIN_YEAR && year <= DvcCacheHeader::MAX_YEAR);
+    result.hash = semester | (((year - 2000) & 31) << 2);
     line += 5;
 
-    require("expected section", isnumber(line[0]) && line[4] == '\t');
+    require("expected section", isdigit(line[0]) && isdigit(line[1]) && isdigit(line[2]) && isdigit(line[3]) && line[4] == '\t');
     size_t code = _4atoi(line);
     result.hash |= (code << 8);
     line += 5;
 
     require("expected course", isupper(line[0]));
-    const char* end = strchr(line, '-');
-    require("expected course", end != nullptr && end != line);
+    const char* end = strpbrk(line, "-\t");     // (the '-' must be in the course column)
+    require("expected course", end != nullptr && *end == '-' && end != line);
     result.subject = { line, (size_t)(end - line) };
 
     require("expected section", *end == '-');
@@ -201,53 +211,67 @@ int main (int argc, const char** argv) {
     const char* path = "dvc-schedule.txt";
     switch (argc) {
         case 1: break;
-        case 2: path = argv[0]; break;
+        case 2: path = argv[1]; break;
         default: {
             std::cerr << "usage: " << argv[0] << " [path-to-dvc-schedule.txt]" << std::endl;
             exit(-1);
         }
     }
 
-    // Load file
-    std::ifstream file { path };
-    if (!file) {
-        std::cerr << "Could not load '" << path << "'" << std::endl;
-        exit(-1);
-    } else {
-        std::cout << "Loaded file '" << path << "'" << std::endl;
-    }
-
-    // List / collection of all unique subject elements
-    typedef AssociativeArray<std::string, int>              SectionCount;
-    typedef AssociativeArray<std::string, SectionCount>     SubjectDict;
+    // List / collection of all unique subject elements. Both levels are kept sorted by key
+    // (AASortedStrategy), so lookups are binary searches and the results come out sorted.
+    typedef AssociativeArray<std::string, int, AASortedStrategy>           SectionCount;
+    typedef AssociativeArray<std::string, SectionCount, AASortedStrategy>  SubjectDict;
     SubjectDict subjects;
 
     // Hash-based duplicate filterer
     DuplicateFilterer filterer;
 
-    // Parse lines
-    std::string line;
-    ParseResult result;
-    size_t line_num = 0;
-    while (getline(file, line)) {
-        if (parse(path, ++line_num, line.c_str(), result) && filterer.isUnique(result)) {
-            // std::cout << result << " (from " << line << ")\n";
-
+    auto insert = [&](const ParseResult& result) {
+        if (filterer.isUnique(result)) {
             // Nice, behavior of associative array lets us do this:
             subjects[result.subject][result.section]++;
         }
-    }
+    };
+    ParseResult result;
 
-    // Sort results:
-    typedef std::pair<std::string, SectionCount> SubjectKV;
-    std::sort(subjects.begin(), subjects.end(), [](const SubjectKV& a, const SubjectKV& b) {
-        return a.first < b.first;
-    });
-    typedef std::pair<std::string, int> SectionKV;
-    for (auto& subject : subjects) {
-        std::sort(subject.second.begin(), subject.second.end(), [](const SectionKV& a, const SectionKV& b) {
-            return a.first < b.first;
-        });
+    // Use the file's binary cache if it has one that's valid + up to date (same rows as the text
+    // lines parse() accepts, already split into columns: rows w/out a course # followed by a tab
+    // are flagged, + skipped)
+    DvcCache cache (dvcCachePath(path).c_str(), path);
+    if (cache.valid()) {
+        std::cout << "Loaded cache '" << dvcCachePath(path) << "' (" << cache.rows() << " sections)" << std::endl;
+        for (size_t row = 0, rows = cache.rows(); row < rows; ++row) {
+            if (!(cache.flags()[row] & DvcCacheHeader::ROW_COURSE_NUMBER)) continue;
+            // (same hash as parse(): semester | (year - 2000):5 << 2 | section << 8)
+            result.hash    = (cache.dates()[row] & 0x7F) | (size_t)cache.sections()[row] << 8;
+            result.subject = cache.subjectName(cache.subjects()[row]);
+            result.section = cache.string(cache.courseNumbers()[row]);
+            result.line    = "";
+            insert(result);
+        }
+    } else {
+        if (cache.found()) {
+            warn() << "Ignoring '" << dvcCachePath(path) << "': " << cache.error() << " (rerun dvc_convert)";
+        }
+        // Load file
+        std::ifstream file { path };
+        if (!file) {
+            std::cerr << "Could not load '" << path << "'" << std::endl;
+            exit(-1);
+        } else {
+            std::cout << "Loaded file '" << path << "'" << std::endl;
+        }
+
+        // Parse lines
+        std::string line;
+        size_t line_num = 0;
+        while (getline(file, line)) {
+            if (parse(path, ++line_num, line.c_str(), result)) {
+                // std::cout << result << " (from " << line << ")\n";
+                insert(result);
+            }
+        }
     }
 
     // Quite simple (and efficient) since I implemented iterators using std::pair<K,V>.
@@ -14,6 +14,14 @@
 // it is significantly slower than DVC-8, which brought further improvements / optimizations
 // and is highly modular.
 //
+// Subjects are counted by interned id (StringInterner, from assignment 3): each line's subject is
+// looked up in place (pointer + length), and only the ~100 distinct subject names are ever copied,
+// instead of assigning a std::string + hashing it into a std::string keyed table on every line.
+//
+// Always parses the text file (no binary cache loader, see assignment_08's DvcCache.h): duplicates
+// are whole text lines here, and the cache only keeps each line's term, section + course, so it
+// can't tell apart lines that only differ in their instructor / times / room.
+//
 // remote source: https://github.com/SeijiEmery/comp220/blob/master/assignment_10/src/DvcSchedule10.cpp
 //
 #include <iostream>
@@ -22,12 +30,16 @@
 #include <string>
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
+#include <cassert>
 #include <type_traits>
 #include <ctime>
 #include <cmath>
 #include <vector>
+#include <algorithm>
 
 #include "HashTable.h"
+#include "StringInterner.h"
 
 //
 // Utilities
@@ -86,7 +98,7 @@ int main (int argc, const char** argv) {
     const char* path = "dvc-schedule.txt";
     switch (argc) {
         case 1: break;
-        case 2: path = argv[0]; break;
+        case 2: path = argv[1]; break;
         default: {
             std::cerr << "usage: " << argv[0] << " [path-to-dvc-schedule.txt]" << std::endl;
             exit(-1);
@@ -103,11 +115,11 @@ int main (int argc, const char** argv) {
     }
 
     auto duplicates   = make_hashtable<std::string, bool>(std::hash<std::string>{});
-    auto subjects     = make_hashtable<std::string, size_t>(std::hash<std::string>{});
+    StringInterner      subjects;
+    std::vector<size_t> counts;     // by subject id
 
     // Parse lines 2
     std::string line;
-    std::string subject;
     while (getline(file, line)) {
         // Skip duplicate lines
         if (!duplicates.insert(line, true)) {
@@ -135,23 +147,23 @@ int main (int argc, const char** argv) {
         const char* end  = strchr(subj, '-');         assert(subj != end);
 
         // Count subject
-        subject.assign(subj, static_cast<size_t>(end - subj));
-        subjects[subject] += 1;
+        StringInterner::Id id = subjects.intern(subj, static_cast<size_t>(end - subj));
+        if (id == counts.size()) counts.push_back(0);
+        counts[id] += 1;
     }
 
-    // Fetch + sort results:
-    typedef std::pair<std::string, size_t> SubjectKV;
-    std::vector<SubjectKV> results;
+    // Sort results (subject ids, by name):
+    std::vector<StringInterner::Id> results;
     results.reserve(subjects.size());
-    for (auto& kv : subjects) {
-        results.push_back(kv);
+    for (StringInterner::Id id = 0; id < subjects.size(); ++id) {
+        results.push_back(id);
     }
-    std::sort(results.begin(), results.end(), [](const SubjectKV& a, const SubjectKV& b) {
-        return a.first < b.first;
+    std::sort(results.begin(), results.end(), [&](StringInterner::Id a, StringInterner::Id b) {
+        return strcmp(subjects.str(a), subjects.str(b)) < 0;
     });
 
-    for (const auto& subject : results) {
-        writeln() << subject.first << ", " << subject.second << " section(s)";
+    for (auto id : results) {
+        writeln() << subjects.str(id) << ", " << counts[id] << " section(s)";
     }
     return 0;
 }
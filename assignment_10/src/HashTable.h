@@ -6,6 +6,8 @@
 // Implements a hashtable, open addressed (not chaining).
 // Is thoroughly tested in HashTable.TestDriver.cpp and HashTableInteractiveTest.cpp
 //
+// Storage memory comes from an (std-compatible) Allocator template parameter (rebound to bytes).
+//
 // remote source: https://github.com/SeijiEmery/comp220/blob/master/assignment_10/src/HashTable.h
 //
 
@@ -13,15 +15,20 @@
 #define HashTable_h
 
 #include <utility>      // std::pair
+#include <memory>       // std::allocator, std::allocator_traits
 #include <algorithm>    // std::fill
 #include <cassert>      // assert
 
-template <typename Key, typename Value, typename HashFunction = size_t(*)(const Key&)>
+template <typename Key, typename Value, typename HashFunction = size_t(*)(const Key&),
+          typename Allocator = std::allocator<std::pair<Key, Value>>>
 class HashTable {
 public:
-    typedef HashTable<Key, Value, HashFunction> This;
-    typedef std::pair<Key, Value>               KeyValue;
+    typedef HashTable<Key, Value, HashFunction, Allocator> This;
+    typedef std::pair<Key, Value>                          KeyValue;
 private:
+    typedef typename std::allocator_traits<Allocator>::template rebind_alloc<uint8_t> ByteAllocator;
+    typedef std::allocator_traits<ByteAllocator>                                     ByteTraits;
+
     // Can't use DynamicArray (or, hence, my Bitset impl)
     // Note: this is really stupid, b/c we have to reimplement everything from scratch -_-
     // Note: this is likely to INCREASE bugs, b/c the previous code was well tested...
@@ -75,7 +82,7 @@ private:
     //
     // fun features:
     //  – memory is contiguous (ie. data array is referenced by both bitset + elements)
-    //  - only one allocation / free per storage instance
+    //  - only one allocation / free per storage instance (from the HashTable's Allocator)
     //  - custom (very manual) memory management; data layout is sparse (ie. not all elements have been initialized)
     //  - lookup via contains()
     //  - insertion via maybeInsert() – supports Key or KeyValue
@@ -88,30 +95,38 @@ private:
     //  - does have a move ctor, since that was sorta necessary...
     //
     class Storage {
+        ByteAllocator alloc;
         size_t      capacity;
         void*       data;
         Bitset      bitset;
         KeyValue*   elements;
+
+        // Elements follow the bitset, rounded up so that they're properly aligned
+        static size_t elementsOffset (size_t capacity) {
+            return (Bitset::allocationSize(capacity) + alignof(KeyValue) - 1) / alignof(KeyValue) * alignof(KeyValue);
+        }
+        static size_t allocationSize (size_t capacity) {
+            return elementsOffset(capacity) + capacity * sizeof(KeyValue);
+        }
     public:
-        Storage (size_t capacity)
-            : capacity(capacity)
-            , data((void*)(new uint8_t[Bitset::allocationSize(capacity) + capacity * sizeof(KeyValue)]))
+        Storage (size_t capacity, const ByteAllocator& alloc = ByteAllocator())
+            : alloc(alloc)
+            , capacity(capacity)
+            , data((void*)ByteTraits::allocate(this->alloc, allocationSize(capacity)))
             , bitset(reinterpret_cast<typename Bitset::word_t*>(data), Bitset::allocationSize(capacity))
-            , elements(reinterpret_cast<KeyValue*>(&bitset.data[bitset.size]))
+            , elements(reinterpret_cast<KeyValue*>(&reinterpret_cast<uint8_t*>(data)[elementsOffset(capacity)]))
         {}
         Storage (const Storage& other) = delete;
         Storage& operator= (const Storage& other) = delete;
         Storage (Storage&& other) 
-            : Storage(other.size())
+            : Storage(other.size(), other.alloc)
         { *this = std::move(other); }
         Storage& operator= (Storage&& other) {
-            std::swap(capacity, other.capacity);
-            std::swap(data, other.data);
-            std::swap(bitset, other.bitset);
-            std::swap(elements, other.elements);
+            swap(other);
             return *this;
         }
         void swap (Storage& other) {
+            std::swap(alloc, other.alloc);
             std::swap(capacity, other.capacity);
             std::swap(data, other.data);
             std::swap(bitset, other.bitset);
@@ -121,8 +136,9 @@ private:
             for (size_t i = 0; i < size(); ++i) {
                 maybeDelete(i);
             }
-            delete[] ((uint8_t*)data);
+            ByteTraits::deallocate(alloc, (uint8_t*)data, allocationSize(capacity));
         }
+        const ByteAllocator& allocator () const { return alloc; }
         friend std::ostream& operator<< (std::ostream& os, const Storage& self) {
             return os << "capacity = " << self.size() << ", bitset " << self.bitset;
         }
@@ -223,11 +239,11 @@ public:
     //
     // Utility methods...
     //
-    static Storage make_storage (size_t capacity) {
-        return { capacity };
+    Storage make_storage (size_t capacity) const {
+        return { capacity, storage.allocator() };
     }
     This create (size_t capacity, double threshold = 0.8) const {
-        return { hashFunction, capacity, threshold };
+        return { hashFunction, capacity, threshold, Allocator(storage.allocator()) };
     }
     This clone () { return *this; }
     friend std::ostream& operator<< (std::ostream& os, const This& self) {
@@ -241,15 +257,15 @@ public:
     // Primary interface...
     //
     HashTable () = delete;
-    HashTable (HashFunction hashFunction, size_t capacity = 0, double loadFactor = 0.8)
+    HashTable (HashFunction hashFunction, size_t capacity = 0, double loadFactor = 0.8, const Allocator& alloc = Allocator())
         : hashFunction(hashFunction)
-        , storage(capacity)
+        , storage(capacity, ByteAllocator(alloc))
         , _loadFactor(loadFactor)
         , capacityThreshold((size_t)(capacity * loadFactor))
     {}
     HashTable (const This& other)
         : hashFunction(other.hashFunction)
-        , storage(other.capacity())
+        , storage(other.capacity(), ByteTraits::select_on_container_copy_construction(other.storage.allocator()))
         , _loadFactor(other.loadFactor())
         , capacityThreshold(other.capacityThreshold)
     {
@@ -294,7 +310,7 @@ public:
             size *= 2;
         }
         // Create new storage element w/ the target size, and swap it w/ our current storage
-        Storage temp { size };
+        Storage temp { size, storage.allocator() };
         storage.swap(temp);
 
         // Reset capacityThreshold to accomodate new storage size
@@ -13,49 +13,12 @@ using namespace std;
 
 #include <ctime>
 #include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include "PriorityQueue.h"
+#include "Benchmark.h"     // (assignment_03/src)
 
 
-class BenchResult {
-    clock_t startTime, endTime;
-    bool started = false, stopped = false;
-public:
-    BenchResult () : startTime(0), endTime(0) {}
-
-    // Start / stop bench time
-    void start () { startTime = clock(); started = true; stopped = false; }
-    void stop  () { endTime   = clock(); stopped = false; }
-
-    // Returns true iff in a valid timing state (start() called, then stop()).
-    bool valid () const { return started && stopped; }
-
-    // Returns total time elapsed, in seconds
-    double elapsed () const { return (double)(endTime - startTime) / CLOCKS_PER_SEC; }
-
-    template <typename F>
-    BenchResult& run (const F& inner) {
-        start();
-        inner();
-        stop();
-        return *this;
-    }
-};
-
-template <typename F>
-double benchmark (const F& inner) {
-    return BenchResult().run(inner).elapsed();
-}
-template <typename F>
-double benchmark (size_t iterations, const F& inner) {
-    auto duration = benchmark([&](){
-        for (size_t i = iterations; i --> 0; ) {
-            inner();
-        }
-    });
-    // std::cout << "runtime: " << duration << '\n';
-    return duration / static_cast<double>(iterations);
-}
-
 //
 // Memory + time benchmarking code: this hijacks (overloads) global new / delete
 // to trace memory allocations (very simple: # of allocations / frees + # bytes
@@ -153,11 +116,17 @@ struct Seconds {
 };
 
 
+// Times This::run(i, queue, data) on fresh queues (bench::run: warm-up, calibrated # of runs per
+// sample, median / p90 / stddev); This::before(i, queue, data) prepares each queue, untimed.
 template <typename T, typename This>
 class PriorityQueueBenchmark {
     std::vector<PriorityQueue<T>> items;
     std::vector<T>                data;
+
+    This& self () { return static_cast<This&>(*this); }
 public:
+    void before (size_t, PriorityQueue<T>&, const std::vector<T>&) {}
+
     // resize / re-fill input data
     template <typename Generator>
     This& generate (size_t count, const Generator& generator) {
@@ -166,91 +135,106 @@ public:
         for (size_t i = count; i --> 0; ) {
             data.push_back(generator());
         }
-        return static_cast<This&>(*this);
+        return self();
     }
     template <typename Reporter>
-    This& run (size_t iterations, const Reporter& report) {
+    This& run (const bench::Options& options, const Reporter& report) {
+        auto setup = [&](size_t iterations) {
+            items.clear();
+            items.resize(iterations);
+            for (size_t i = 0; i < iterations; ++i) {
+                self().before(i, items[i], data);
+            }
+        };
+        auto stats = bench::run(options, setup, [&](size_t i) {
+            self().run(i, items[i], data);
+        });
+
+        // memory used by one (untimed) run
+        LocalMemoryTracer memoryTracer;
+        setup(1);
+        memoryTracer.enter();
+        self().run(0, items[0], data);
+        memoryTracer.exit();
         items.clear();
-        for (size_t i = iterations; i --> 0; ) {
-            items.emplace_back();
-        }
-        size_t i = 0;
-        report(iterations, benchmark(iterations, [&](){
-            static_cast<This&>(*this).run(i, items[i], data); 
-            ++i;
-        }));
-        return static_cast<This&>(*this);
+
+        report(stats, memoryTracer);
+        return self();
     }
-    This& runSuite (std::initializer_list<std::pair<size_t, size_t>> counts) {
-        LocalMemoryTracer memoryTracer;
+    // counts: { # elements, # samples }
+    This& runSuite (const char* name, std::initializer_list<std::pair<size_t, size_t>> counts) {
         double expected = 60e-9;
 
         srand(time(nullptr));
         for (const auto& pair : counts) {
-            size_t count = pair.first, iterations = pair.second;
+            size_t count = pair.first, samples = pair.second;
             generate(count, [](){ return static_cast<T>(rand() % 2048 - 1024); });
 
-            memoryTracer.enter();
-            run(iterations, [&](size_t iterations, double benchDuration /* seconds */) {
-                memoryTracer.exit();
-                Seconds duration { benchDuration };
+            run(bench::Options(samples), [&](const bench::Stats& stats, const LocalMemoryTracer& memoryTracer) {
+                bench::Report::global().add(name, count, stats);
+                Seconds duration { stats.median * 1e-3 };
                 Seconds projected { expected * count };
-                Bytes usedMemory { (size_t)(memoryTracer.usedMemory / iterations) };
-                double usedAllocs = (double)memoryTracer.usedAllocs / iterations;
                 double percentDifference = (duration.seconds - projected.seconds) / projected.seconds * 100;
 
                 std::cout 
-                    << "push count: " << std::setw(9) << count
+                    << name << " count: " << std::setw(9) << count
                     << " time: " << std::setw(8) << duration << " / run"
-                    << " (expected " << std::setw(8) << Seconds(expected * count) 
+                    << " (p90 " << std::setw(8) << Seconds(stats.p90 * 1e-3)
+                    << ", stddev " << std::setw(8) << Seconds(stats.stddev * 1e-3) << ")"
+                    << " (expected " << std::setw(8) << projected 
                     << " " << std::setw(4) << (int)percentDifference << "%)"
-                    << "  iteration(s): " << std::setw(4) << iterations
-                    << "  memory: " << std::setw(8) << usedMemory << " "
-                    << std::setw(3) << (int)usedAllocs << " allocation(s)"
+                    << "  runs: " << std::setw(3) << stats.samples << " x " << std::setw(6) << stats.iterations
+                    << "  memory: " << std::setw(8) << Bytes(memoryTracer.usedMemory) << " "
+                    << std::setw(3) << memoryTracer.usedAllocs << " allocation(s)"
                     << std::endl;
-                expected = benchDuration / count;
-                memoryTracer.enter();
+                expected = duration.seconds / count;
             });
         }
-        return static_cast<This&>(*this);
+        return self();
     }
 };
 
 template <typename T>
 struct PriorityQueuePushBenchmark : public PriorityQueueBenchmark<T, PriorityQueuePushBenchmark<T>> {
-    T accumulator;
     void run (size_t i, PriorityQueue<T>& queue, const std::vector<T>& data) {
         // std::cout << data.size() << " elements\n";
         for (const auto& element : data) {
             queue.push(element);
         }
-        accumulator += queue.size();
+        bench::doNotOptimize(queue.size());
         // std::cout << queue << '\n';
     }
-    void info () {
-        std::cout << accumulator << '\n';
-    }
 };
 
-int main () {
+int main (int argc, const char** argv) {
     std::cout << "Programmer: Seiji Emery\n"
               << "Programmer's id: M00202623\n"
               << "File: " __FILE__ "\n\n";
 
+    // optional result files: [--csv results.csv] [--json results.json]
+    const char* csvPath = nullptr, *jsonPath = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if      (strcmp(argv[i], "--csv")  == 0 && i + 1 < argc) csvPath  = argv[++i];
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) jsonPath = argv[++i];
+        else {
+            std::cerr << "usage: " << argv[0] << " [--csv results.csv] [--json results.json]" << std::endl;
+            return -1;
+        }
+    }
+
     PriorityQueuePushBenchmark<double>()
-        .runSuite({
-            { 1,  1000 }, 
-            { 10, 1000 }, 
-            { 100, 1000 },
-            { 1000, 100 },
-            { 10000, 100 },
+        .runSuite("push", {
+            { 1, 10 },
+            { 10, 10 },
+            { 100, 10 },
+            { 1000, 10 },
+            { 10000, 10 },
             { 100000, 10 },
-            { 1000000, 10 },
-            { 10000000, 1 },
+            { 1000000, 5 },
+            { 10000000, 3 },
             // { 100000000, 1 },
-        })
-        .info();
-}
-
-
+        });
 
+    if (csvPath)  { std::ofstream file (csvPath);  bench::Report::global().writeCsv(file); }
+    if (jsonPath) { std::ofstream file (jsonPath); bench::Report::global().writeJson(file); }
+}
@@ -0,0 +1,417 @@
+// Programmer: Seiji Emery
+// Programmer ID: M00202623
+//
+// ExternalSort.cpp
+//
+// Stable external merge sort for line-oriented files larger than RAM (eg. extracted DVC
+// section records). Works in two phases:
+//
+//  1. run generation: reads lines until the memory budget is used up, sorts them in memory
+//     with SortableArray (ties broken by input order, so the sort is stable), and writes each
+//     sorted run to a temporary file.
+//  2. merge: k-way merges the runs using our PriorityQueue (assignment 11), with large
+//     buffered sequential reads / writes. Each run is an open temporary file, so we never keep
+//     more runs than we have buffers for (given the memory budget + the open file limit): once
+//     that many runs exist, the newest ones are merged into one while runs are still generated.
+//
+// Lines are compared on the whole line, or (with -k N) on the Nth tab-separated field.
+// Per-phase throughput is reported to stderr, so the sorted output can go to stdout.
+//
+// usage: external_sort [-m <budget MB>] [-k <field>] [-o <output>] [<input>]
+//
+// Remote source:
+// https://github.com/SeijiEmery/comp220/tree/master/assignment_12/src/ExternalSort.cpp
+//
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <sys/resource.h>   // getrlimit (open file limit)
+
+#include "SortableArray.h"
+
+#define NO_PQUEUE_DEBUG
+#include "PriorityQueue.h"
+
+//
+// Config
+//
+
+struct SortConfig {
+    size_t      memoryBudget = 64 * 1024 * 1024;  // bytes used for run generation + merge buffers
+    int         keyField     = -1;                 // tab-separated field to sort on (-1 => whole line)
+    const char* inputPath    = nullptr;            // nullptr => stdin
+    const char* outputPath   = nullptr;            // nullptr => stdout
+
+    size_t      maxOpenRuns  = (size_t)-1;         // open file limit, minus the files that aren't runs
+
+    static const size_t MIN_BUFFER_SIZE = 64 * 1024, MAX_BUFFER_SIZE = 4 * 1024 * 1024;
+    static const size_t RESERVED_FILES = 8;         // stdin / stdout / stderr, input, output, merged run
+
+    // Max number of runs merged per pass (+ kept open at once): each needs its own read buffer
+    // (+1 for the output), and is an open file.
+    size_t fanIn () const {
+        size_t n = memoryBudget / MIN_BUFFER_SIZE;
+        n = n > 2 ? n - 1 : 2;
+        return n < maxOpenRuns ? n : maxOpenRuns;
+    }
+    // I/O buffer size used when merging k runs.
+    size_t bufferSize (size_t k) const {
+        size_t size = memoryBudget / (k + 1);
+        return size < MIN_BUFFER_SIZE ? MIN_BUFFER_SIZE : size > MAX_BUFFER_SIZE ? MAX_BUFFER_SIZE : size;
+    }
+
+    SortConfig (int argc, const char** argv) {
+        for (int i = 1; i < argc; ++i) {
+            if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+                memoryBudget = (size_t)(atof(argv[++i]) * 1024 * 1024);
+            } else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
+                keyField = atoi(argv[++i]);
+            } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+                outputPath = argv[++i];
+            } else if (argv[i][0] != '-' && !inputPath) {
+                inputPath = argv[i];
+            } else {
+                std::cerr << "usage: " << argv[0] << " [-m <budget MB>] [-k <field>] [-o <output>] [<input>]" << std::endl;
+                exit(-1);
+            }
+        }
+        if (memoryBudget < 2 * MIN_BUFFER_SIZE) {
+            memoryBudget = 2 * MIN_BUFFER_SIZE;
+        }
+        struct rlimit limit;
+        if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY) {
+            maxOpenRuns = limit.rlim_cur > RESERVED_FILES + 2 ? limit.rlim_cur - RESERVED_FILES : 2;
+        }
+    }
+};
+const size_t SortConfig::MIN_BUFFER_SIZE;
+const size_t SortConfig::MAX_BUFFER_SIZE;
+const size_t SortConfig::RESERVED_FILES;
+
+//
+// Buffered line I/O. The underlying FILE is unbuffered; we do our own (large, explicitly
+// sized) buffering so that runs can be written, then re-read w/ a different buffer size.
+//
+
+class LineFile {
+    FILE*             file = nullptr;
+    std::vector<char> buffer;
+    size_t            pos = 0, end = 0;     // unread (or unwritten) range of buffer
+    bool              owned = false, eof = false, writing = false;
+public:
+    size_t bytes = 0;   // bytes read / written through this file
+
+    LineFile (FILE* file, size_t bufferSize, bool owned)
+        : file(file), buffer(bufferSize), owned(owned)
+    {
+        if (file) { setvbuf(file, nullptr, _IONBF, 0); }
+    }
+    LineFile (const LineFile&) = delete;
+    LineFile& operator= (const LineFile&) = delete;
+    ~LineFile () {
+        flush();
+        if (owned && file) { fclose(file); }
+    }
+    operator bool () const { return file != nullptr; }
+
+    // Reads next line (w/out trailing newline) into str; returns false on EOF.
+    bool read (std::string& str) {
+        while (true) {
+            const char* nl = (const char*)memchr(buffer.data() + pos, '\n', end - pos);
+            if (nl) {
+                size_t n = (size_t)(nl - (buffer.data() + pos));
+                str.assign(buffer.data() + pos, n);
+                pos += n + 1; bytes += n + 1;
+                return true;
+            }
+            if (eof) {
+                if (pos == end) return false;
+                str.assign(buffer.data() + pos, end - pos);   // last line, w/out trailing newline
+                bytes += end - pos; pos = end;
+                return true;
+            }
+            // Refill: move partial line to front (and grow buffer if a line doesn't fit)
+            if (pos == 0 && end == buffer.size()) {
+                buffer.resize(buffer.size() * 2);
+            } else if (pos != 0) {
+                memmove(buffer.data(), buffer.data() + pos, end - pos);
+                end -= pos; pos = 0;
+            }
+            size_t n = fread(buffer.data() + end, 1, buffer.size() - end, file);
+            end += n;
+            if (n == 0) { eof = true; }
+        }
+    }
+    void write (const std::string& str) {
+        writing = true;
+        if (end + str.size() + 1 > buffer.size()) {
+            flush();
+            if (str.size() + 1 > buffer.size()) { buffer.resize(str.size() + 1); }
+        }
+        memcpy(buffer.data() + end, str.data(), str.size());
+        end += str.size();
+        buffer[end++] = '\n';
+        bytes += str.size() + 1;
+    }
+    void flush () {
+        if (file && writing && end > 0) {
+            fwrite(buffer.data(), 1, end, file);
+            end = 0;
+        }
+    }
+    // Flushes + frees the buffer of a run that we're done writing (until it's rewound for merging)
+    void suspend () {
+        flush();
+        std::vector<char>().swap(buffer);
+        pos = end = 0;
+    }
+    // Flushes (if writing) + rewinds a temporary file for reading, with a new buffer size.
+    void rewind (size_t bufferSize) {
+        flush();
+        fflush(file);
+        ::rewind(file);
+        buffer.resize(bufferSize);
+        buffer.shrink_to_fit();
+        pos = end = bytes = 0;
+        eof = writing = false;
+    }
+};
+
+//
+// Records
+//
+
+// Returns the sort key of line (the whole line, or the field-th tab separated field).
+inline void keyOf (const std::string& line, int field, size_t& begin, size_t& length) {
+    begin = 0; length = line.size();
+    if (field < 0) return;
+    for (int i = 0; i < field; ++i) {
+        begin = line.find('\t', begin);
+        if (begin == std::string::npos) { begin = line.size(); length = 0; return; }
+        ++begin;
+    }
+    size_t end = line.find('\t', begin);
+    length = (end == std::string::npos ? line.size() : end) - begin;
+}
+inline int compareKeys (const std::string& a, size_t ab, size_t al, const std::string& b, size_t bb, size_t bl) {
+    int c = memcmp(a.data() + ab, b.data() + bb, al < bl ? al : bl);
+    return c != 0 ? c : (al < bl ? -1 : al > bl ? 1 : 0);
+}
+
+// A line + its position in the input; seq breaks ties so that the (unstable) quicksort
+// used by SortableArray produces a stable ordering.
+struct Record {
+    std::string line;
+    size_t      seq = 0;
+    size_t      keyBegin = 0, keyLength = 0;
+
+    friend bool operator< (const Record& a, const Record& b) {
+        int c = compareKeys(a.line, a.keyBegin, a.keyLength, b.line, b.keyBegin, b.keyLength);
+        return c != 0 ? c < 0 : a.seq < b.seq;
+    }
+};
+
+// Head of a run in the k-way merge. PriorityQueue is a max-heap, so comparisons are inverted;
+// ties go to the lower numbered (ie. earlier) run, which keeps the merge stable.
+struct MergeHead {
+    std::string line;
+    size_t      run = 0;
+    size_t      keyBegin = 0, keyLength = 0;
+
+    bool before (const MergeHead& other) const {
+        int c = compareKeys(line, keyBegin, keyLength, other.line, other.keyBegin, other.keyLength);
+        return c != 0 ? c < 0 : run < other.run;
+    }
+    bool operator>  (const MergeHead& other) const { return before(other); }
+    bool operator>= (const MergeHead& other) const { return !other.before(*this); }
+};
+
+//
+// Phase timing
+//
+
+struct PhaseStats {
+    const char* name;
+    size_t lines = 0, bytes = 0, runs = 0;
+    std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
+
+    PhaseStats (const char* name) : name(name) {}
+    void report () const {
+        using namespace std::chrono;
+        double seconds = duration_cast<duration<double>>(high_resolution_clock::now() - t0).count();
+        std::cerr << std::setw(16) << name << ": "
+            << std::setw(9) << lines << " lines, "
+            << std::setw(8) << bytes * 1e-6 << " MB, "
+            << std::setw(5) << runs << " run(s) in "
+            << std::setw(8) << seconds * 1e3 << " ms  ("
+            << std::setw(8) << (seconds > 0 ? bytes * 1e-6 / seconds : 0) << " MB/s, "
+            << std::setw(10) << (seconds > 0 ? lines / seconds : 0) << " lines/s)\n";
+    }
+};
+
+//
+// Phase 1: run generation
+//
+
+typedef std::vector<LineFile*> Runs;
+
+LineFile* createRun (const SortConfig& config) {
+    FILE* file = tmpfile();
+    if (!file) {
+        std::cerr << "Could not create temporary run file" << std::endl;
+        exit(-1);
+    }
+    return new LineFile(file, config.bufferSize(1), true);
+}
+
+void mergeRuns (const SortConfig& config, const Runs& runs, LineFile& output, PhaseStats& stats);
+
+// Keeps the # of (open) runs below fanIn(): merges the newest runs that have been merged the
+// fewest times (levels[i]: # of merges run i's lines went through) into one, so each line is only
+// re-merged O(log(# runs)) times. The runs merged are consecutive + replaced in place, so earlier
+// runs stay ahead of later ones (stability).
+void mergeNewestRuns (const SortConfig& config, Runs& runs, std::vector<size_t>& levels) {
+    PhaseStats stats ("merge pass");
+    size_t begin = runs.size() - 1;
+    while (begin > 0 && levels[begin - 1] == levels.back()) {
+        --begin;
+    }
+    if (runs.size() - begin < 2) {
+        begin = 0;      // (every run has a different level: merge them all)
+    }
+    size_t level = levels[begin] + 1;     // (levels never increase from oldest to newest run)
+
+    LineFile* run = createRun(config);
+    mergeRuns(config, Runs(runs.begin() + begin, runs.end()), *run, stats);
+    run->suspend();
+    runs.resize(begin);
+    levels.resize(begin);
+    runs.push_back(run);
+    levels.push_back(level);
+    ++stats.runs;
+    stats.report();
+}
+
+Runs generateRuns (const SortConfig& config, LineFile& input, size_t& totalLines) {
+    PhaseStats stats ("run generation");
+    Runs runs;
+    std::vector<size_t> levels;
+    SortableArray<Record> records (1024);
+    size_t count = 0, usedMemory = 0, seq = 0;
+
+    auto flushRun = [&]() {
+        if (count == 0) return;
+        records.sort(count);
+        LineFile* run = createRun(config);
+        for (size_t i = 0; i < count; ++i) {
+            run->write(records[i].line);
+        }
+        run->suspend();
+        runs.push_back(run);
+        levels.push_back(0);
+        ++stats.runs;
+        count = usedMemory = 0;
+
+        if (runs.size() >= config.fanIn()) {
+            mergeNewestRuns(config, runs, levels);
+        }
+    };
+
+    std::string line;
+    while (input.read(line)) {
+        Record& record = records[count++];
+        record.line.swap(line);
+        record.seq = seq++;
+        keyOf(record.line, config.keyField, record.keyBegin, record.keyLength);
+
+        usedMemory += sizeof(Record) + record.line.capacity();
+        if (usedMemory >= config.memoryBudget) {
+            flushRun();
+        }
+    }
+    flushRun();
+
+    stats.lines = totalLines = seq;
+    stats.bytes = input.bytes;
+    stats.report();
+    return runs;
+}
+
+//
+// Phase 2: k-way merge
+//
+
+// Merges (and deletes) runs into output.
+void mergeRuns (const SortConfig& config, const Runs& runs, LineFile& output, PhaseStats& stats) {
+    size_t k = runs.size();
+    size_t bufferSize = config.bufferSize(k);
+
+    PriorityQueue<MergeHead> heads;
+    for (size_t i = 0; i < k; ++i) {
+        runs[i]->rewind(bufferSize);
+
+        MergeHead head; head.run = i;
+        if (runs[i]->read(head.line)) {
+            keyOf(head.line, config.keyField, head.keyBegin, head.keyLength);
+            heads.push(std::move(head));
+        }
+    }
+    while (!heads.empty()) {
+        MergeHead head = std::move(heads.peek());
+        heads.pop();
+        output.write(head.line);
+        ++stats.lines;
+
+        if (runs[head.run]->read(head.line)) {
+            keyOf(head.line, config.keyField, head.keyBegin, head.keyLength);
+            heads.push(std::move(head));
+        }
+    }
+    for (auto run : runs) {
+        stats.bytes += run->bytes;
+        delete run;
+    }
+}
+
+int main (int argc, const char** argv) {
+    SortConfig config (argc, argv);
+
+    FILE* in = config.inputPath ? fopen(config.inputPath, "r") : stdin;
+    if (!in) {
+        std::cerr << "Could not open '" << config.inputPath << "'" << std::endl;
+        exit(-1);
+    }
+    FILE* out = config.outputPath ? fopen(config.outputPath, "w") : stdout;
+    if (!out) {
+        std::cerr << "Could not open '" << config.outputPath << "' for writing" << std::endl;
+        exit(-1);
+    }
+    std::cerr << "memory budget: " << config.memoryBudget * 1e-6 << " MB, max fan-in: " << config.fanIn() << '\n';
+
+    size_t totalLines = 0;
+    Runs runs;
+    {
+        LineFile input (in, config.bufferSize(1), in != stdin);
+        runs = generateRuns(config, input, totalLines);
+    }
+
+    // Final merge, to output (run generation already merged runs down to fewer than fanIn())
+    assert(runs.size() < config.fanIn());
+    {
+        PhaseStats stats ("final merge");
+        stats.runs = runs.size();
+        LineFile output (out, config.bufferSize(runs.size()), out != stdout);
+        mergeRuns(config, runs, output, stats);
+        output.flush();
+        stats.report();
+        assert(stats.lines == totalLines);
+    }
+    return 0;
+}
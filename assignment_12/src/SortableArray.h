@@ -3,6 +3,7 @@
 //
 // SortableArray.h
 // Implements a templated sortable dynamic array with non-throwing bounds checking.
+// Memory comes from an (std-compatible) Allocator template parameter.
 //
 // Remote source:
 // https://github.com/SeijiEmery/comp220/tree/master/assignment_12/src/SortableArray.hpp
@@ -11,23 +12,33 @@
 #ifndef SortableArray_h
 #define SortableArray_h
 #include <cassert>
+#include <memory>       // std::allocator, std::allocator_traits
+#include <utility>
+#include <type_traits>
+#include "SortingNetwork.h"
 
-template <typename T>
+template <typename T, typename Allocator = std::allocator<T>>
 class SortableArray {
-    size_t _capacity = 0;
-    T*     _data = nullptr;           // dummy incorporated into array at index N. (reserves N+1 elements for data)
-    T      _dummy;
+    typedef std::allocator_traits<Allocator> AllocTraits;
+
+    size_t    _capacity = 0;
+    T*        _data = nullptr;
+    T         _dummy;
+    Allocator _alloc;
     
 public:
+    typedef Allocator allocator_type;
+
     // Constructors, assignment operators, destructor
-    SortableArray (size_t capacity = 2);
-    SortableArray (const SortableArray<T>&);
-    SortableArray& operator= (const SortableArray<T>&);
+    SortableArray (size_t capacity = 2, const Allocator& alloc = Allocator());
+    SortableArray (const SortableArray&);
+    SortableArray& operator= (const SortableArray&);
     ~SortableArray ();
 
     // Move operations
-    SortableArray (SortableArray<T>&& other) { *this = std::move(other); }
-    SortableArray<T>& operator= (SortableArray<T>&& other) { 
+    SortableArray (SortableArray&& other) : _alloc(other._alloc) { *this = std::move(other); }
+    SortableArray& operator= (SortableArray&& other) { 
+        std::swap(_alloc, other._alloc);
         std::swap(_capacity, other._capacity);
         std::swap(_data, other._data);
         std::swap(_dummy, other._dummy);
@@ -49,17 +60,46 @@ public:
         quicksort(0, upperBound > 0 ? upperBound - 1 : 0);
     }
 private:
+    // Destroys all elements + frees storage
+    void release ();
+
+    // Recurses on the smaller partition + loops on the larger one, so stack depth stays O(log n)
+    // (inputs w/ many duplicates could otherwise recurse O(n) deep and overflow the stack).
     void quicksort (size_t start, size_t end) {
-        if (start < end) {
-            size_t pivot = partition(start, end);
-            if (pivot > 1) {
-                quicksort(start, pivot - 1);
+        while (start < end) {
+            // Finish small partitions w/ a simd sorting network, if we have one for T (+ this cpu
+            // has a simd kernel: the scalar network is slower than just partitioning further)
+            if (end - start < sortingnetwork::MAX_SIZE && 
+                sortSmallPartition(start, end, sortingnetwork::has_network<T>())) {
+                return;
             }
-            if (pivot + 1 <= end) {
-                quicksort(pivot + 1, end);
+            size_t pivot = partition(start, end);
+            if (pivot - start < end - pivot) {
+                if (pivot > start) {
+                    quicksort(start, pivot - 1);
+                }
+                start = pivot + 1;
+            } else {
+                if (pivot + 1 <= end) {
+                    quicksort(pivot + 1, end);
+                }
+                if (pivot <= start) {
+                    return;
+                }
+                end = pivot - 1;
             }
         }
     }
+    bool sortSmallPartition (size_t start, size_t end, std::true_type) {
+        if (sortingnetwork::simdLevel() == sortingnetwork::SimdLevel::SCALAR) {
+            return false;
+        }
+        sortingnetwork::sort(&_data[start], end - start + 1);
+        return true;
+    }
+    bool sortSmallPartition (size_t, size_t, std::false_type) {
+        return false;
+    }
     size_t partition (size_t left, size_t right) {
         size_t pivot  = left;
         size_t middle = (left + right) / 2;
@@ -114,86 +154,91 @@ namespace detail {
     }
 }; // namespace detail
 
-template <typename T>
-SortableArray<T>::SortableArray (size_t count) 
+template <typename T, typename Allocator>
+SortableArray<T, Allocator>::SortableArray (size_t count, const Allocator& alloc) 
     : _capacity(count),
-      _data(new T[_capacity]),
-      _dummy(T())
+      _dummy(T()),
+      _alloc(alloc)
 {
-    // std::cout << "\033[36mALLOC " << _capacity << " (" << _capacity * sizeof(T) << ")\033[0m\n";
-    detail::fill(&_data[0], &_data[_capacity], T());
+    _data = AllocTraits::allocate(_alloc, _capacity);
+    for (size_t i = 0; i < _capacity; ++i) {
+        new (&_data[i]) T();
+    }
 }
 
-template <typename T>
-SortableArray<T>::SortableArray (const SortableArray<T>& other) 
+template <typename T, typename Allocator>
+SortableArray<T, Allocator>::SortableArray (const SortableArray& other) 
     : _capacity(other._capacity),
-      _data(new T[_capacity]),
-      _dummy(T())
+      _dummy(T()),
+      _alloc(AllocTraits::select_on_container_copy_construction(other._alloc))
 {
-    // std::cout << "\033[36mALLOC " << _capacity << " (" << _capacity * sizeof(T) << ")\033[0m\n";
-    detail::copy(&other._data[0], &other._data[_capacity], &_data[0]);
+    _data = AllocTraits::allocate(_alloc, _capacity);
+    for (size_t i = 0; i < _capacity; ++i) {
+        new (&_data[i]) T(other._data[i]);
+    }
 }
 
-template <typename T>
-SortableArray<T>& SortableArray<T>::operator= (const SortableArray<T>& other) {
+template <typename T, typename Allocator>
+SortableArray<T, Allocator>& SortableArray<T, Allocator>::operator= (const SortableArray& other) {
     if (this != &other) {
-        // std::cout << "\033[35mDEALLOC " << _capacity << " (" << _capacity * sizeof(T) << ")\033[0m\n";
-        delete[] _data;
+        release();
 
         _capacity = other._capacity;
-        _data = new T[_capacity];
+        _data = AllocTraits::allocate(_alloc, _capacity);
         _dummy = T();
-        // std::cout << "\033[36mALLOC " << _capacity << " (" << _capacity * sizeof(T) << ")\033[0m\n";
-        detail::copy(&other._data[0], &other._data[_capacity], &_data[0]);
+        for (size_t i = 0; i < _capacity; ++i) {
+            new (&_data[i]) T(other._data[i]);
+        }
     }
     return *this;
 }
 
-template <typename T>
-SortableArray<T>::~SortableArray () {
+template <typename T, typename Allocator>
+SortableArray<T, Allocator>::~SortableArray () {
+    release();
+}
+
+template <typename T, typename Allocator>
+void SortableArray<T, Allocator>::release () {
     if (_data) {
-        delete[] _data;
+        for (size_t i = 0; i < _capacity; ++i) {
+            _data[i].~T();
+        }
+        AllocTraits::deallocate(_alloc, _data, _capacity);
         _data = nullptr;
-        // std::cout << "\033[35mDEALLOC " << _capacity << " (" << _capacity * sizeof(T) << ")\033[0m\n";
     }
 }
 
-template <typename T>
-void SortableArray<T>::capacity (size_t cap) {
+template <typename T, typename Allocator>
+void SortableArray<T, Allocator>::capacity (size_t cap) {
     if (cap < 10) cap = 10;
 
-    // std::cout << "\033[34mresizing " << _capacity << " => " << cap << "\033[0m\n";
-
     if (cap > _capacity) {
-        // Allocate new array
-        T* newData = new T[cap];
-        // std::cout << "\033[36mALLOC " << _capacity << " (" << _capacity * sizeof(T) << ")\033[0m\n";
-
-        // Copy existing data
-        if (_capacity != 0) {
-            detail::copy(&_data[0], &_data[_capacity], &newData[0]);
+        // Allocate new array, move existing elements into it + default-construct the rest
+        T* newData = AllocTraits::allocate(_alloc, cap);
+        for (size_t i = 0; i < _capacity; ++i) {
+            new (&newData[i]) T(std::move(_data[i]));
+            _data[i].~T();
+        }
+        for (size_t i = _capacity; i < cap; ++i) {
+            new (&newData[i]) T();
         }
-        // Fill remaining data with zeroes
-        assert(_capacity < cap);
-        detail::fill(&newData[_capacity], &newData[cap], T());
 
         // Delete old array, and replace array / capacity
         if (_data != nullptr) {
-            delete[] _data;
-            _data = nullptr;
-            // std::cout << "\033[35mDEALLOC " << _capacity << " (" << _capacity * sizeof(T) << ")\033[0m\n";
+            AllocTraits::deallocate(_alloc, _data, _capacity);
         }
         _data = newData;
         _capacity = cap;
     }
 }
 
-template <typename T>
-const T& SortableArray<T>::operator[] (int i) const {
+template <typename T, typename Allocator>
+const T& SortableArray<T, Allocator>::operator[] (int i) const {
     return i < 0 || i > _capacity ? _dummy : _data[i];
 }
-template <typename T>
-T& SortableArray<T>::operator[] (int i) {
+template <typename T, typename Allocator>
+T& SortableArray<T, Allocator>::operator[] (int i) {
     if (i < 0) return _dummy = {};
     if (i >= _capacity) {
         // Resize capacity
@@ -0,0 +1,179 @@
+// Programmer: Seiji Emery
+// Programmer ID: M00202623
+//
+// SortingNetwork.bench.cpp
+//
+// Micro-benchmark for the small-partition sorting networks in SortingNetwork.h:
+// times every available kernel (scalar / sse4.1 / avx2) for 8 / 16 / 32 element sorts
+// of int32_t, float and double, against std::sort + insertion sort. Also times
+// SortableArray::sort (which uses the simd networks as its quicksort finisher) end to end.
+//
+// Remote source:
+// https://github.com/SeijiEmery/comp220/tree/master/assignment_12/src/SortingNetwork.bench.cpp
+//
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <limits>
+#include "SortableArray.h"
+
+using namespace sortingnetwork;
+
+template <typename F>
+double benchmark (const F& inner) {
+    using namespace std::chrono;
+    auto t0 = high_resolution_clock::now();
+    inner();
+    auto t1 = high_resolution_clock::now();
+    return duration_cast<duration<double>>(t1 - t0).count();
+}
+
+template <typename T>
+void insertionSort (T* begin, T* end) {
+    for (T* i = begin + 1; i < end; ++i) {
+        T value = *i; T* j = i;
+        for (; j > begin && value < j[-1]; --j) { j[0] = j[-1]; }
+        *j = value;
+    }
+}
+
+template <typename T>
+std::vector<T> randomData (size_t count) {
+    std::vector<T> data (count);
+    for (auto& value : data) {
+        value = static_cast<T>(rand() % 100000 - 50000);
+    }
+    return data;
+}
+
+// Sorts `count / n` consecutive n-element chunks of data w/ sort; returns ns / chunk.
+// Result is checked against std::sort.
+template <typename T, typename Sort>
+double benchChunks (const std::vector<T>& input, size_t n, const Sort& sort) {
+    std::vector<T> data = input, expected = input;
+    size_t chunks = data.size() / n;
+    for (size_t i = 0; i < chunks; ++i) {
+        std::sort(&expected[i * n], &expected[i * n + n]);
+    }
+    double elapsed = benchmark([&](){
+        for (size_t i = 0; i < chunks; ++i) {
+            sort(&data[i * n], n);
+        }
+    });
+    if (data != expected) {
+        std::cerr << "FAILED: chunks were not sorted correctly (n = " << n << ")" << std::endl;
+        exit(-1);
+    }
+    return elapsed * 1e9 / chunks;
+}
+
+// Checks every n (1 - MAX_SIZE) w/ every available kernel on inputs containing +inf / -inf / max
+// (the network pads unused lanes, and a pad must never displace a real value), and
+// SortableArray::sort (small partitions go through the networks) on the same values.
+template <typename T>
+void checkSpecialValues (const char* typeName) {
+    const T inf = std::numeric_limits<T>::infinity(), big = std::numeric_limits<T>::max();
+    const T values[] = { 3, inf, 1, -2, static_cast<T>(0.5), -inf, big, 0, inf, -big, -1 };
+    const size_t numValues = sizeof(values) / sizeof(values[0]);
+
+    SimdLevel best = simdLevel();
+    for (int level = 0; level <= static_cast<int>(best); ++level) {
+        simdLevel() = static_cast<SimdLevel>(level);
+        for (size_t n = 1; n <= MAX_SIZE; ++n) {
+            std::vector<T> data, expected;
+            for (size_t i = 0; i < n; ++i) { data.push_back(values[(i * 7) % numValues]); }
+            expected = data;
+            std::sort(expected.begin(), expected.end());
+            sortingnetwork::sort(&data[0], n);
+            if (data != expected) {
+                std::cerr << "FAILED: " << typeName << " w/ +/-inf was not sorted correctly (n = " << n
+                    << ", " << simdLevelName(simdLevel()) << ")" << std::endl;
+                exit(-1);
+            }
+        }
+        SortableArray<T> array (numValues);
+        for (size_t i = 0; i < numValues; ++i) { array[i] = values[i]; }
+        array.sort(numValues);
+        std::vector<T> expected (values, values + numValues);
+        std::sort(expected.begin(), expected.end());
+        for (size_t i = 0; i < numValues; ++i) {
+            if (!(array[i] == expected[i])) {
+                std::cerr << "FAILED: SortableArray<" << typeName << "> w/ +/-inf was not sorted correctly" << std::endl;
+                exit(-1);
+            }
+        }
+    }
+    simdLevel() = best;
+}
+
+template <typename T>
+void benchType (const char* typeName, size_t count) {
+    auto input = randomData<T>(count);
+    SimdLevel best = simdLevel();
+
+    std::cout << '\n' << typeName << ":\n";
+    for (size_t n : { 8, 16, 32 }) {
+        std::cout << "  n = " << std::setw(2) << n << "  ";
+        std::cout << " std::sort: " << std::setw(7) << benchChunks(input, n, [](T* a, size_t n) { std::sort(a, a + n); }) << " ns";
+        std::cout << "  insertion: " << std::setw(7) << benchChunks(input, n, [](T* a, size_t n) { insertionSort(a, a + n); }) << " ns";
+        for (int level = 0; level <= static_cast<int>(best); ++level) {
+            simdLevel() = static_cast<SimdLevel>(level);
+            std::cout << "  " << simdLevelName(simdLevel()) << ": " << std::setw(7)
+                << benchChunks(input, n, [](T* a, size_t n) { sortingnetwork::sort(a, n); }) << " ns";
+        }
+        simdLevel() = best;
+        std::cout << '\n';
+    }
+}
+
+template <typename T>
+void benchSortableArray (const char* typeName, size_t count) {
+    auto input = randomData<T>(count);
+    SortableArray<T> array (count);
+
+    SimdLevel best = simdLevel();
+    for (int level = 0; level <= static_cast<int>(best); ++level) {
+        simdLevel() = static_cast<SimdLevel>(level);
+        for (size_t i = 0; i < count; ++i) { array[i] = input[i]; }
+
+        double elapsed = benchmark([&](){ array.sort(count); });
+        for (size_t i = 1; i < count; ++i) {
+            if (array[i] < array[i - 1]) {
+                std::cerr << "FAILED: SortableArray<" << typeName << "> was not sorted" << std::endl;
+                exit(-1);
+            }
+        }
+        std::cout << "  SortableArray<" << typeName << ">::sort(" << count << ") w/ "
+            << std::setw(6) << (simdLevel() == SimdLevel::SCALAR ? "no" : simdLevelName(simdLevel())) << " finisher: "
+            << std::setw(8) << elapsed * 1e3 << " ms\n";
+    }
+    simdLevel() = best;
+}
+
+int main () {
+    std::cout << "Programmer: Seiji Emery\n"
+              << "Programmer's id: M00202623\n"
+              << "File: " __FILE__ "\n\n";
+    srand(time(nullptr));
+
+    std::cout << "Detected simd level: " << simdLevelName(detectSimdLevel()) << '\n';
+    checkSpecialValues<float>("float");
+    checkSpecialValues<double>("double");
+
+    std::cout << "Sorting network runtimes (ns / sort):\n";
+
+    const size_t count = 32 * 64 * 1024;
+    benchType<int32_t>("int32_t", count);
+    benchType<float>("float", count);
+    benchType<double>("double", count);
+
+    std::cout << "\nQuicksort w/ small partition finisher:\n";
+    benchSortableArray<int32_t>("int32_t", 1000000);
+    benchSortableArray<double>("double", 1000000);
+    return 0;
+}
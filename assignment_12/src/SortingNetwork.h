@@ -0,0 +1,326 @@
+// Programmer: Seiji Emery
+// Programmer ID: M00202623
+//
+// SortingNetwork.h
+// Implements fixed-size bitonic sorting networks (8 / 16 / 32 elements) for int32_t, float and double,
+// with AVX2 / SSE4.1 kernels and a (branchless) scalar fallback. The kernel is selected at runtime
+// via cpuid, so this header does NOT need to be compiled with -mavx2 (we use per-function target
+// attributes instead).
+//
+// Used by SortableArray as the finisher for small quicksort partitions (w/ the simd kernels only).
+//
+// Remote source:
+// https://github.com/SeijiEmery/comp220/tree/master/assignment_12/src/SortingNetwork.h
+//
+
+#ifndef SortingNetwork_h
+#define SortingNetwork_h
+
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <limits>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define SORTING_NETWORK_X86
+    #include <immintrin.h>
+    #define SN_TARGET(arch) __attribute__((target(arch), always_inline))
+#endif
+
+namespace sortingnetwork {
+
+// Largest partition we can sort with a single network.
+enum { MAX_SIZE = 32 };
+
+// Types that we have network kernels for.
+template <typename T> struct has_network : std::false_type {};
+template <> struct has_network<int32_t> : std::true_type {};
+template <> struct has_network<float>   : std::true_type {};
+template <> struct has_network<double>  : std::true_type {};
+
+//
+// Runtime dispatch
+//
+
+enum class SimdLevel { SCALAR = 0, SSE41 = 1, AVX2 = 2 };
+
+inline SimdLevel detectSimdLevel () {
+    #ifdef SORTING_NETWORK_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))   return SimdLevel::AVX2;
+        if (__builtin_cpu_supports("sse4.1")) return SimdLevel::SSE41;
+    #endif
+    return SimdLevel::SCALAR;
+}
+
+// Cached simd level; can be overridden (eg. by benchmarks) to force a specific kernel.
+inline SimdLevel& simdLevel () {
+    static SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+inline const char* simdLevelName (SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SCALAR: return "scalar";
+        case SimdLevel::SSE41:  return "sse4.1";
+        case SimdLevel::AVX2:   return "avx2";
+        default:                return "unknown";
+    }
+}
+
+//
+// Scalar kernel: classic bitonic network on array indices; compare-exchange is branchless
+// (compiles to min / max or cmov).
+//
+
+template <typename T>
+void bitonicSortScalar (T* a, size_t n) {
+    assert(n >= 2 && (n & (n - 1)) == 0);
+    for (size_t k = 2; k <= n; k <<= 1) {
+        for (size_t j = k >> 1; j > 0; j >>= 1) {
+            for (size_t i = 0; i < n; ++i) {
+                size_t l = i ^ j;
+                if (l > i) {
+                    T lo = a[l] < a[i] ? a[l] : a[i];
+                    T hi = a[l] < a[i] ? a[i] : a[l];
+                    bool ascending = (i & k) == 0;
+                    a[i] = ascending ? lo : hi;
+                    a[l] = ascending ? hi : lo;
+                }
+            }
+        }
+    }
+}
+
+#ifdef SORTING_NETWORK_X86
+
+//
+// SIMD kernels. Each Traits type describes one register type (W lanes of T) and implements:
+//  - load / store, min / max
+//  - swapLanes(x, j): permutes x s.t. lane i holds lane i ^ j (for j < W)
+//  - takeMax(base, j, k): lane mask, set where lane (base + lane) should take max(x, partner)
+//  - blend(a, b, mask): selects b where mask is set, a otherwise
+//
+
+struct Avx2Int32 {
+    typedef int32_t T; typedef __m256i V; enum { W = 8 };
+    SN_TARGET("avx2") static V load  (const T* p) { return _mm256_loadu_si256((const __m256i*)p); }
+    SN_TARGET("avx2") static void store (T* p, V x) { _mm256_storeu_si256((__m256i*)p, x); }
+    SN_TARGET("avx2") static V min (V a, V b) { return _mm256_min_epi32(a, b); }
+    SN_TARGET("avx2") static V max (V a, V b) { return _mm256_max_epi32(a, b); }
+    SN_TARGET("avx2") static V swapLanes (V x, size_t j) {
+        switch (j) {
+            case 1:  return _mm256_shuffle_epi32(x, 0xB1);
+            case 2:  return _mm256_shuffle_epi32(x, 0x4E);
+            default: return _mm256_permute2x128_si256(x, x, 1);
+        }
+    }
+    SN_TARGET("avx2") static V takeMax (size_t base, size_t j, size_t k) {
+        __m256i idx  = _mm256_add_epi32(_mm256_set1_epi32((int)base), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        __m256i zero = _mm256_setzero_si256();
+        __m256i lo   = _mm256_cmpeq_epi32(_mm256_and_si256(idx, _mm256_set1_epi32((int)j)), zero);
+        __m256i asc  = _mm256_cmpeq_epi32(_mm256_and_si256(idx, _mm256_set1_epi32((int)k)), zero);
+        return _mm256_xor_si256(lo, asc);
+    }
+    SN_TARGET("avx2") static V blend (V a, V b, V mask) { return _mm256_blendv_epi8(a, b, mask); }
+};
+
+struct Avx2Float {
+    typedef float T; typedef __m256 V; enum { W = 8 };
+    SN_TARGET("avx2") static V load  (const T* p) { return _mm256_loadu_ps(p); }
+    SN_TARGET("avx2") static void store (T* p, V x) { _mm256_storeu_ps(p, x); }
+    SN_TARGET("avx2") static V min (V a, V b) { return _mm256_min_ps(a, b); }
+    SN_TARGET("avx2") static V max (V a, V b) { return _mm256_max_ps(a, b); }
+    SN_TARGET("avx2") static V swapLanes (V x, size_t j) {
+        switch (j) {
+            case 1:  return _mm256_permute_ps(x, 0xB1);
+            case 2:  return _mm256_permute_ps(x, 0x4E);
+            default: return _mm256_permute2f128_ps(x, x, 1);
+        }
+    }
+    SN_TARGET("avx2") static V takeMax (size_t base, size_t j, size_t k) {
+        return _mm256_castsi256_ps(Avx2Int32::takeMax(base, j, k));
+    }
+    SN_TARGET("avx2") static V blend (V a, V b, V mask) { return _mm256_blendv_ps(a, b, mask); }
+};
+
+struct Avx2Double {
+    typedef double T; typedef __m256d V; enum { W = 4 };
+    SN_TARGET("avx2") static V load  (const T* p) { return _mm256_loadu_pd(p); }
+    SN_TARGET("avx2") static void store (T* p, V x) { _mm256_storeu_pd(p, x); }
+    SN_TARGET("avx2") static V min (V a, V b) { return _mm256_min_pd(a, b); }
+    SN_TARGET("avx2") static V max (V a, V b) { return _mm256_max_pd(a, b); }
+    SN_TARGET("avx2") static V swapLanes (V x, size_t j) {
+        switch (j) {
+            case 1:  return _mm256_permute_pd(x, 0x5);
+            default: return _mm256_permute2f128_pd(x, x, 1);
+        }
+    }
+    SN_TARGET("avx2") static V takeMax (size_t base, size_t j, size_t k) {
+        __m256i idx  = _mm256_add_epi64(_mm256_set1_epi64x((long long)base), _mm256_setr_epi64x(0, 1, 2, 3));
+        __m256i zero = _mm256_setzero_si256();
+        __m256i lo   = _mm256_cmpeq_epi64(_mm256_and_si256(idx, _mm256_set1_epi64x((long long)j)), zero);
+        __m256i asc  = _mm256_cmpeq_epi64(_mm256_and_si256(idx, _mm256_set1_epi64x((long long)k)), zero);
+        return _mm256_castsi256_pd(_mm256_xor_si256(lo, asc));
+    }
+    SN_TARGET("avx2") static V blend (V a, V b, V mask) { return _mm256_blendv_pd(a, b, mask); }
+};
+
+struct Sse41Int32 {
+    typedef int32_t T; typedef __m128i V; enum { W = 4 };
+    SN_TARGET("sse4.1") static V load  (const T* p) { return _mm_loadu_si128((const __m128i*)p); }
+    SN_TARGET("sse4.1") static void store (T* p, V x) { _mm_storeu_si128((__m128i*)p, x); }
+    SN_TARGET("sse4.1") static V min (V a, V b) { return _mm_min_epi32(a, b); }
+    SN_TARGET("sse4.1") static V max (V a, V b) { return _mm_max_epi32(a, b); }
+    SN_TARGET("sse4.1") static V swapLanes (V x, size_t j) {
+        return j == 1 ? _mm_shuffle_epi32(x, 0xB1) : _mm_shuffle_epi32(x, 0x4E);
+    }
+    SN_TARGET("sse4.1") static V takeMax (size_t base, size_t j, size_t k) {
+        __m128i idx  = _mm_add_epi32(_mm_set1_epi32((int)base), _mm_setr_epi32(0, 1, 2, 3));
+        __m128i zero = _mm_setzero_si128();
+        __m128i lo   = _mm_cmpeq_epi32(_mm_and_si128(idx, _mm_set1_epi32((int)j)), zero);
+        __m128i asc  = _mm_cmpeq_epi32(_mm_and_si128(idx, _mm_set1_epi32((int)k)), zero);
+        return _mm_xor_si128(lo, asc);
+    }
+    SN_TARGET("sse4.1") static V blend (V a, V b, V mask) { return _mm_blendv_epi8(a, b, mask); }
+};
+
+struct Sse41Float {
+    typedef float T; typedef __m128 V; enum { W = 4 };
+    SN_TARGET("sse4.1") static V load  (const T* p) { return _mm_loadu_ps(p); }
+    SN_TARGET("sse4.1") static void store (T* p, V x) { _mm_storeu_ps(p, x); }
+    SN_TARGET("sse4.1") static V min (V a, V b) { return _mm_min_ps(a, b); }
+    SN_TARGET("sse4.1") static V max (V a, V b) { return _mm_max_ps(a, b); }
+    SN_TARGET("sse4.1") static V swapLanes (V x, size_t j) {
+        return j == 1 ? _mm_shuffle_ps(x, x, 0xB1) : _mm_shuffle_ps(x, x, 0x4E);
+    }
+    SN_TARGET("sse4.1") static V takeMax (size_t base, size_t j, size_t k) {
+        return _mm_castsi128_ps(Sse41Int32::takeMax(base, j, k));
+    }
+    SN_TARGET("sse4.1") static V blend (V a, V b, V mask) { return _mm_blendv_ps(a, b, mask); }
+};
+
+struct Sse41Double {
+    typedef double T; typedef __m128d V; enum { W = 2 };
+    SN_TARGET("sse4.1") static V load  (const T* p) { return _mm_loadu_pd(p); }
+    SN_TARGET("sse4.1") static void store (T* p, V x) { _mm_storeu_pd(p, x); }
+    SN_TARGET("sse4.1") static V min (V a, V b) { return _mm_min_pd(a, b); }
+    SN_TARGET("sse4.1") static V max (V a, V b) { return _mm_max_pd(a, b); }
+    SN_TARGET("sse4.1") static V swapLanes (V x, size_t) { return _mm_shuffle_pd(x, x, 1); }
+    SN_TARGET("sse4.1") static V takeMax (size_t base, size_t j, size_t k) {
+        __m128i idx  = _mm_add_epi64(_mm_set1_epi64x((long long)base), _mm_set_epi64x(1, 0));
+        __m128i zero = _mm_setzero_si128();
+        __m128i lo   = _mm_cmpeq_epi64(_mm_and_si128(idx, _mm_set1_epi64x((long long)j)), zero);
+        __m128i asc  = _mm_cmpeq_epi64(_mm_and_si128(idx, _mm_set1_epi64x((long long)k)), zero);
+        return _mm_castsi128_pd(_mm_xor_si128(lo, asc));
+    }
+    SN_TARGET("sse4.1") static V blend (V a, V b, V mask) { return _mm_blendv_pd(a, b, mask); }
+};
+
+// Bitonic network over W-lane registers. For partner distances j >= W every register is
+// compared against another whole register (and shares one sort direction); for j < W the
+// partner lives in the same register, so we permute + blend instead.
+//
+// Defined once per target architecture (the intrinsics wrappers above can only be inlined
+// into a function compiled for the same target).
+#define SN_DEFINE_NETWORK(arch, name) \
+    template <typename Traits, size_t N> \
+    __attribute__((target(arch))) void name (typename Traits::T* a) { \
+        typedef typename Traits::V V; \
+        enum { W = Traits::W }; \
+        static_assert(N >= W && (N & (N - 1)) == 0, "network size must be a power of 2 >= lane count"); \
+        for (size_t k = 2; k <= N; k <<= 1) { \
+            for (size_t j = k >> 1; j > 0; j >>= 1) { \
+                if (j >= W) { \
+                    for (size_t b = 0; b < N; b += W) { \
+                        if (b & j) continue; \
+                        V x = Traits::load(&a[b]), y = Traits::load(&a[b + j]); \
+                        V lo = Traits::min(x, y), hi = Traits::max(x, y); \
+                        bool ascending = (b & k) == 0; \
+                        Traits::store(&a[b],     ascending ? lo : hi); \
+                        Traits::store(&a[b + j], ascending ? hi : lo); \
+                    } \
+                } else { \
+                    for (size_t b = 0; b < N; b += W) { \
+                        V x = Traits::load(&a[b]), y = Traits::swapLanes(x, j); \
+                        V lo = Traits::min(x, y), hi = Traits::max(x, y); \
+                        Traits::store(&a[b], Traits::blend(lo, hi, Traits::takeMax(b, j, k))); \
+                    } \
+                } \
+            } \
+        } \
+    }
+
+SN_DEFINE_NETWORK("avx2",   bitonicSortAvx2)
+SN_DEFINE_NETWORK("sse4.1", bitonicSortSse41)
+
+#undef SN_DEFINE_NETWORK
+
+template <typename T> struct Kernels;
+template <> struct Kernels<int32_t> {
+    template <size_t N> static void avx2  (int32_t* a) { bitonicSortAvx2<Avx2Int32, N>(a); }
+    template <size_t N> static void sse41 (int32_t* a) { bitonicSortSse41<Sse41Int32, N>(a); }
+};
+template <> struct Kernels<float> {
+    template <size_t N> static void avx2  (float* a) { bitonicSortAvx2<Avx2Float, N>(a); }
+    template <size_t N> static void sse41 (float* a) { bitonicSortSse41<Sse41Float, N>(a); }
+};
+template <> struct Kernels<double> {
+    template <size_t N> static void avx2  (double* a) { bitonicSortAvx2<Avx2Double, N>(a); }
+    template <size_t N> static void sse41 (double* a) { bitonicSortSse41<Sse41Double, N>(a); }
+};
+
+#endif // SORTING_NETWORK_X86
+
+// Sorts exactly N elements (N = 8, 16 or 32) using the best kernel for this cpu.
+template <size_t N, typename T>
+void sortN (T* a) {
+    static_assert(has_network<T>::value, "no sorting network for this type");
+    #ifdef SORTING_NETWORK_X86
+        switch (simdLevel()) {
+            case SimdLevel::AVX2:  Kernels<T>::template avx2<N>(a);  return;
+            case SimdLevel::SSE41: Kernels<T>::template sse41<N>(a); return;
+            default: break;
+        }
+    #endif
+    bitonicSortScalar(a, N);
+}
+
+// Value the unused lanes are padded with: must sort at or after every real value (incl. +inf),
+// so only copies of it can end up past the first n elements.
+template <typename T>
+constexpr T padValue () {
+    return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+}
+
+// Sorts n <= MAX_SIZE elements: copies into a buffer padded (with padValue()) to the next network
+// size, sorts it, and copies the first n elements back. NaNs aren't supported (nor are they by
+// std::sort: they break its strict weak ordering).
+template <typename T>
+void sort (T* data, size_t n) {
+    assert(n <= MAX_SIZE);
+    if (n < 2) return;
+
+    T buf[MAX_SIZE];
+    size_t i = 0;
+    for (; i < n; ++i) { buf[i] = data[i]; }
+
+    size_t size = n <= 8 ? 8 : n <= 16 ? 16 : 32;
+    for (; i < size; ++i) { buf[i] = padValue<T>(); }
+
+    switch (size) {
+        case 8:  sortN<8>(&buf[0]);  break;
+        case 16: sortN<16>(&buf[0]); break;
+        default: sortN<32>(&buf[0]); break;
+    }
+    for (i = 0; i < n; ++i) { data[i] = buf[i]; }
+}
+
+}; // namespace sortingnetwork
+
+#ifdef SORTING_NETWORK_X86
+    #undef SN_TARGET
+#endif
+
+#endif // SortingNetwork_h
@@ -11,7 +11,10 @@
 #include <string>
 #include <cassert>
 #include <cstring>
+#include <cstdio>
+#include <cctype>
 #include <map>
+#include <DvcCache.h>
 
 //
 // Utilities
@@ -163,24 +166,24 @@ bool parse (const char* file, size_t line_num, char* line, ParseResult& result)
 
     Season season = parseSeasonDVC(line);
     require("expected season", season != Season::INVALID);
-    require("expected year", line[0] == ' ' && isnumber(line[1]) && line[5] == '\t');
+    require("expected year", line[0] == ' ' && isdigit(line[1]) && line[5] == '\t');
     result.date = Date(season, _4atoi(&line[1]));
     line += 6;
 
-    require("expected section", isnumber(line[0]) && line[4] == '\t');
+    require("expected section", isdigit(line[0]) && line[4] == '\t');
     result.section = static_cast<decltype(result.section)>(_4atoi(line));
     line += 5;
 
     result.course = line; line = strchr(line, '-');
-    require("expected course", isupper(result.course[0]) && line[0] == '-');
+    require("expected course", isupper(result.course[0]) && line && line[0] == '-');
     ++line;
 
     result.courseNumber = &line[1]; line = strchr(line, '\t');
-    require("expected course number", isnumber(result.courseNumber[0]) && *line == '\t');
+    require("expected course number", isdigit(result.courseNumber[0]) && line && *line == '\t');
     *line++ = '\0';
 
     result.instructor = line; line = strchr(line, '\t');
-    require("expected instructor", isupper(result.instructor[0]) && line[0] == '\t');
+    require("expected instructor", isupper(result.instructor[0]) && line && line[0] == '\t');
     *line++ = '\0';
 
     result.details = line;
@@ -188,23 +191,87 @@ bool parse (const char* file, size_t line_num, char* line, ParseResult& result)
     #undef require
 }
 
+// Calls callback w/ each row of a (valid) binary cache (DvcCache.h, written by dvc_convert); no
+// parsing, just the columns. Rows that the text parser above would reject (ROW_STRICT) are skipped.
+template <typename F>
+void parseDvcCache (const DvcCache& cache, const F& callback) {
+    ParseResult result;
+    char course[64];
+    result.instructor = result.details = "";
+    for (size_t row = 0, rows = cache.rows(); row < rows; ++row) {
+        if (!(cache.flags()[row] & DvcCacheHeader::ROW_STRICT)) continue;
+        uint8_t date = cache.dates()[row];
+        result.date    = Date(static_cast<Season>(date & 0x3), Date::MIN_YEAR + (date >> 2));
+        result.section = cache.sections()[row];
+
+        // course = "<subject>-<course #>"
+        const char* subject = cache.subjectName(cache.subjects()[row]);
+        const char* number  = cache.string(cache.courseNumbers()[row]);
+        size_t subjectLength = strlen(subject), numberLength = strlen(number);
+        if (subjectLength + numberLength + 2 > sizeof(course)) continue;
+        memcpy(course, subject, subjectLength);
+        course[subjectLength] = '-';
+        memcpy(course + subjectLength + 1, number, numberLength + 1);
+        result.course       = course;
+        result.courseNumber = course + subjectLength + 1;
+        callback(result, row, course);
+    }
+}
+
+// Reads the schedule in fixed BUFFER_SIZE blocks (so memory use doesn't depend on the input size),
+// and splits each block's complete lines w/ memchr; a partial line at the end of a block is moved
+// to the front of the buffer and finished by the next read. filePath "-" reads from stdin (eg. a
+// schedule dump piped from another program). If the file has a valid binary cache
+// (<filePath>.cache), that's loaded instead.
 template <typename F>
 void parseDvc (const char* filePath, const F& callback) {
-    std::ifstream file { filePath };
+    enum { BUFFER_SIZE = 64 * 1024 };
+    bool  fromStdin = strcmp(filePath, "-") == 0;
+    if (!fromStdin) {
+        // Use the file's binary cache if it has one that's valid + up to date
+        DvcCache cache (dvcCachePath(filePath).c_str(), filePath);
+        if (cache.valid()) {
+            report() << "Loaded cache '" << dvcCachePath(filePath) << "' (" << cache.rows() << " sections)";
+            parseDvcCache(cache, callback);
+            return;
+        } else if (cache.found()) {
+            warn() << "Ignoring '" << dvcCachePath(filePath) << "': " << cache.error() << " (rerun dvc_convert)";
+        }
+    }
+    FILE* file = fromStdin ? stdin : fopen(filePath, "rb");
     if (!file) {
         warn(std::cerr) << "Could not load '" << filePath << "'"; std::cerr.flush();
         exit(-1);
     } else {
-        report() << "Loaded file '" << filePath << "'. Parsing...";
+        report() << "Loaded file '" << (fromStdin ? "stdin" : filePath) << "'. Parsing...";
     }
+    std::string data (BUFFER_SIZE + 1, '\0');      // (+1 for the '\0' after a last line w/out a '\n')
+    size_t      tail = 0;                           // partial line carried over from the last block
+    size_t      lineNum = 0;
     ParseResult result;
-
-    std::string line;
-    for (size_t lineNum = 0; getline(file, line); ++lineNum) {
-        if (parse(filePath, lineNum, &line[0], result)) {
-            callback(result, lineNum, line);
+    while (true) {
+        size_t size = tail + fread(&data[tail], 1, BUFFER_SIZE - tail, file);
+        bool   last = size < BUFFER_SIZE;
+        if (size == 0) break;
+
+        // Split at the block's last newline (unless this is the last block, or one line fills it)
+        size_t complete = size;
+        while (!last && complete > 0 && data[complete - 1] != '\n') --complete;
+        if (complete == 0) complete = size;
+        for (char* line = &data[0], *end = &data[complete]; line < end; ++lineNum) {
+            char* eol = static_cast<char*>(memchr(line, '\n', end - line));
+            if (!eol) eol = end;
+            *eol = '\0';
+            if (parse(filePath, lineNum, line, result)) {
+                callback(result, lineNum, line);
+            }
+            line = eol + 1;
         }
+        tail = size - complete;
+        memmove(&data[0], &data[complete], tail);
+        if (last) break;
     }
+    if (!fromStdin) fclose(file);
 }
 template <typename F>
 void parseDvc (int argc, const char** argv, const F& callback) {
@@ -212,9 +279,9 @@ void parseDvc (int argc, const char** argv, const F& callback) {
     const char* path = "dvc-schedule.txt";
     switch (argc) {
         case 1: break;
-        case 2: path = argv[0]; break;
+        case 2: path = argv[1]; break;
         default: {
-            std::cerr << "usage: " << argv[0] << " [path-to-dvc-schedule.txt]" << std::endl;
+            std::cerr << "usage: " << argv[0] << " [path-to-dvc-schedule.txt | -]" << std::endl;
             exit(-1);
         }
     }
@@ -236,7 +303,7 @@ int main (int argc, const char** argv) {
     CoursesByTerm courses;
 
     size_t numConflicts = 0;
-    parseDvc(argc, argv, [&](const ParseResult& result, size_t lineNum, const std::string& line){
+    parseDvc(argc, argv, [&](const ParseResult& result, size_t lineNum, const char* line){
         auto& byTerm = courses[result.date];
         auto  entry  = byTerm.find(result.section);
         if (entry != byTerm.end() && entry->second != result.course) {
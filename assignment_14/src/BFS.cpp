@@ -9,7 +9,7 @@
 #include <fstream>
 #include <iostream>
 #include <list>
-#include <queue>
+#include "RingQueue.h"
 #include <string>
 #include <vector>
 using namespace std;
@@ -20,9 +20,9 @@ struct Node
     list<int> neighbors;
 };
 
-queue<int> doBreadthFirstSearch(int iOriginNode, vector<Node>& database)
+RingQueue<int> doBreadthFirstSearch(int iOriginNode, vector<Node>& database)
 {
-    queue<int> searchOrder;
+    RingQueue<int> searchOrder;
     vector<bool> visited (database.size(), false);
     vector<int> toVisit;
 
@@ -111,7 +111,7 @@ int main()
 
         // BFS result by copy-pop
         cout << "BFS";
-        for (queue<int> q = doBreadthFirstSearch(i, database); !q.empty(); q.pop())
+        for (RingQueue<int> q = doBreadthFirstSearch(i, database); !q.empty(); q.pop())
             cout  << '-'<< database[q.front()].name;
         cout << endl;
     }